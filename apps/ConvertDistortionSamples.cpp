@@ -0,0 +1,135 @@
+/** @file
+    @brief Program that converts the point samples in an external distortion
+           JSON file into the binary file that RenderManager loads in its
+           place.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include <osvr/RenderKit/DistortionSampleFile.h>
+#include <osvr/RenderKit/DistortionSampleParser.h>
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdlib.h> // For exit()
+
+using osvr::renderkit::MonoPointDistortionMeshDescriptions;
+
+void Usage(std::string name) {
+    std::cerr << "Usage: " << name << " ExternalFile.json [OutputFile]"
+              << std::endl;
+    std::cerr << "       Default output file is the one RenderManager looks "
+                 "for next to the JSON file: ExternalFile.json"
+              << osvr::renderkit::getDistortionSampleFileName("")
+              << std::endl;
+
+    exit(-1);
+}
+
+int main(int argc, char* argv[]) {
+    std::string inputName;
+    std::string outputName;
+    int realParams = 0;
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '-') {
+            Usage(argv[0]);
+        } else {
+            switch (++realParams) {
+            case 1:
+                inputName = argv[i];
+                break;
+            case 2:
+                outputName = argv[i];
+                break;
+            default:
+                Usage(argv[0]);
+            }
+        }
+    }
+    if (realParams < 1) {
+        Usage(argv[0]);
+    }
+    if (outputName.empty()) {
+        outputName = osvr::renderkit::getDistortionSampleFileName(inputName);
+    }
+
+    std::ifstream fs{inputName, std::ios::in | std::ios::binary};
+    if (!fs) {
+        std::cerr << "Couldn't open " << inputName << std::endl;
+        return -1;
+    }
+    std::string text;
+    fs.seekg(0, std::ios::end);
+    std::streamoff size = fs.tellg();
+    if (size <= 0) {
+        std::cerr << "Empty file " << inputName << std::endl;
+        return -1;
+    }
+    text.resize(static_cast<size_t>(size));
+    fs.seekg(0, std::ios::beg);
+    if (!fs.read(&text[0], size)) {
+        std::cerr << "Couldn't read " << inputName << std::endl;
+        return -1;
+    }
+
+    // The file holds either mono or RGB point samples.
+    const std::vector<std::vector<std::string> > layouts = {
+        {"mono_point_samples"},
+        {"red_point_samples", "green_point_samples", "blue_point_samples"}};
+    std::vector<MonoPointDistortionMeshDescriptions> samples;
+    std::string error;
+    for (auto const& keys : layouts) {
+        std::string layoutError;
+        if (!osvr::renderkit::parseDistortionSampleArrays(text, keys, samples,
+                                                          layoutError)) {
+            error += "\n  " + layoutError;
+            continue;
+        }
+        if (!osvr::renderkit::writeDistortionSampleFile(
+                outputName, keys, samples,
+                osvr::renderkit::describeDistortionSampleSource(text),
+                error)) {
+            std::cerr << "Couldn't write " << outputName << ": " << error
+                      << std::endl;
+            return -1;
+        }
+        std::cout << "Wrote";
+        for (size_t k = 0; k < keys.size(); k++) {
+            std::cout << (k ? ", " : " ") << keys[k] << " (";
+            for (size_t eye = 0; eye < samples[k].size(); eye++) {
+                std::cout << (eye ? " and " : "") << samples[k][eye]->size();
+            }
+            std::cout << " samples)";
+        }
+        std::cout << " to " << outputName << std::endl;
+        return 0;
+    }
+    std::cerr << "Couldn't find point samples in " << inputName << ":"
+              << error << std::endl;
+    return -1;
+}
@@ -0,0 +1,194 @@
+/** @file
+    @brief Benchmark program that times the construction of distortion
+           meshes with increasing numbers of worker threads and checks
+           that the meshes are identical to the ones built serially.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include <osvr/RenderKit/ComputeDistortionMesh.h>
+#include <osvr/RenderKit/DistortionParameters.h>
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <stdlib.h> // For exit()
+
+using osvr::renderkit::DistortionMesh;
+using osvr::renderkit::DistortionParameters;
+using osvr::renderkit::MonoPointDistortionMeshDescription;
+
+void Usage(std::string name) {
+    std::cerr << "Usage: " << name << " [DesiredTriangles [Repetitions]]"
+              << std::endl;
+    std::cerr << "       Default desired triangles = 100000, repetitions = 3"
+              << std::endl;
+
+    exit(-1);
+}
+
+/// Polynomial distortion similar to that of the OSVR HDK 1.3.
+static std::vector<DistortionParameters> makePolynomialParameters(
+    float desiredTriangles) {
+    DistortionParameters p;
+    p.m_type = DistortionParameters::rgb_symmetric_polynomials;
+    p.m_desiredTriangles = desiredTriangles;
+    p.m_distortionD = {1.0f, 1.0f};
+    p.m_distortionPolynomialRed = {0, 1, -1.74f, 5.15f, -1.27f, -2.23f};
+    p.m_distortionPolynomialGreen = {0, 1, -1.74f, 5.15f, -1.27f, -2.23f};
+    p.m_distortionPolynomialBlue = {0, 1, -1.74f, 5.15f, -1.27f, -2.23f};
+    std::vector<DistortionParameters> ret(2, p);
+    ret[0].m_distortionCOP = {0.53f, 0.5f};
+    ret[1].m_distortionCOP = {0.47f, 0.5f};
+    return ret;
+}
+
+/// Mono point samples of a radial distortion on a 50x50 grid, to stand
+/// in for the unstructured meshes of the measured HDK configurations.
+static std::vector<DistortionParameters> makePointSampleParameters(
+    float desiredTriangles) {
+    DistortionParameters p;
+    p.m_type = DistortionParameters::mono_point_samples;
+    p.m_desiredTriangles = desiredTriangles;
+    const int samples = 50;
+    for (size_t eye = 0; eye < 2; eye++) {
+        MonoPointDistortionMeshDescription eyeSamples;
+        double copX = eye == 0 ? 0.53 : 0.47;
+        for (int x = 0; x <= samples; x++) {
+            for (int y = 0; y <= samples; y++) {
+                double inX = static_cast<double>(x) / samples;
+                double inY = static_cast<double>(y) / samples;
+                double dx = inX - copX;
+                double dy = inY - 0.5;
+                double scale = 1 + 0.4 * (dx * dx + dy * dy);
+                eyeSamples.push_back(
+                    {{{{inX, inY}}, {{copX + dx * scale, 0.5 + dy * scale}}}});
+            }
+        }
+        p.m_monoPointSamples.push_back(
+            std::make_shared<const MonoPointDistortionMeshDescription>(
+                std::move(eyeSamples)));
+    }
+    return std::vector<DistortionParameters>(2, p);
+}
+
+static bool sameMeshes(std::vector<DistortionMesh> const& a,
+                       std::vector<DistortionMesh> const& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].vertices.size() != b[i].vertices.size() ||
+            a[i].indices != b[i].indices) {
+            return false;
+        }
+        if (!a[i].vertices.empty() &&
+            std::memcmp(a[i].vertices.data(), b[i].vertices.data(),
+                        sizeof(a[i].vertices[0]) * a[i].vertices.size()) !=
+                0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool runBenchmark(std::string const& name,
+                         std::vector<DistortionParameters> const& params,
+                         int repetitions) {
+    std::cout << name << ":" << std::endl;
+    std::vector<DistortionMesh> serial;
+    double serialSeconds = 0;
+    const unsigned threadCounts[] = {1, 4, 8, 16};
+    for (unsigned threads : threadCounts) {
+        double best = 0;
+        std::vector<DistortionMesh> meshes;
+        for (int r = 0; r < repetitions; r++) {
+            auto start = std::chrono::high_resolution_clock::now();
+            meshes = osvr::renderkit::ComputeDistortionMeshes(
+                osvr::renderkit::SQUARE, params, 1.0f, threads);
+            std::chrono::duration<double> elapsed =
+                std::chrono::high_resolution_clock::now() - start;
+            if (r == 0 || elapsed.count() < best) {
+                best = elapsed.count();
+            }
+        }
+        if (threads == 1) {
+            serial = meshes;
+            serialSeconds = best;
+            if (serial.empty() || serial[0].vertices.empty()) {
+                std::cerr << "  Could not construct meshes" << std::endl;
+                return false;
+            }
+        }
+        bool same = sameMeshes(serial, meshes);
+        std::cout << "  " << threads << " threads: " << best * 1e3 << " ms, "
+                  << serialSeconds / best << "x speedup, "
+                  << (same ? "identical" : "DIFFERENT") << std::endl;
+        if (!same) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    // Parse the command line
+    float desiredTriangles = 100000;
+    int repetitions = 3;
+    int realParams = 0;
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '-') {
+            Usage(argv[0]);
+        } else {
+            switch (++realParams) {
+            case 1:
+                desiredTriangles = static_cast<float>(atof(argv[i]));
+                break;
+            case 2:
+                repetitions = atoi(argv[i]);
+                break;
+            default:
+                Usage(argv[0]);
+            }
+        }
+    }
+    if (repetitions < 1) {
+        Usage(argv[0]);
+    }
+    std::cout << "Building two-eye meshes with " << desiredTriangles
+              << " desired triangles per eye" << std::endl;
+
+    bool ok = runBenchmark("Polynomial distortion",
+                           makePolynomialParameters(desiredTriangles),
+                           repetitions);
+    ok = runBenchmark("Mono point-sample distortion",
+                      makePointSampleParameters(desiredTriangles),
+                      repetitions) && ok;
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,551 @@
+/** @file
+    @brief Benchmark program that compares the SQUARE, RADIAL and ADAPTIVE
+           distortion mesh types at equal error: the number of vertices and
+           triangles in each and the GPU time taken to draw it in the
+           present pass.  Also times drawing with distortion lookup
+           textures at full and reduced resolution.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com/osvr>
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include <osvr/RenderKit/ComputeDistortionMesh.h>
+#include <osvr/RenderKit/DistortionCorrectTextureCoordinate.h>
+#include <osvr/RenderKit/DistortionParameters.h>
+
+// Library/third-party includes
+#include <GL/glew.h>
+#include <SDL.h>
+
+// Standard includes
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <stddef.h> // For offsetof()
+#include <stdlib.h> // For exit()
+
+using osvr::renderkit::DistortionLookupTable;
+using osvr::renderkit::DistortionMesh;
+using osvr::renderkit::DistortionMeshType;
+using osvr::renderkit::DistortionMeshVertex;
+using osvr::renderkit::DistortionParameters;
+using osvr::renderkit::Float2;
+
+// Size of the display area for one eye, as on the OSVR HDK 2.
+static const int EYE_WIDTH = 1080;
+static const int EYE_HEIGHT = 1200;
+
+void Usage(std::string name) {
+    std::cerr << "Usage: " << name << " [DesiredTriangles [Repetitions]]"
+              << std::endl;
+    std::cerr << "       Default desired triangles = 12800, repetitions = 200"
+              << std::endl;
+
+    exit(-1);
+}
+
+/// Polynomial distortion similar to that of the OSVR HDK 1.3, with the
+/// center of projection off to the side as it is for the left eye.
+static DistortionParameters makeParameters(float desiredTriangles) {
+    DistortionParameters p;
+    p.m_type = DistortionParameters::rgb_symmetric_polynomials;
+    p.m_desiredTriangles = desiredTriangles;
+    p.m_distortionD = {1.0f, 1.0f};
+    p.m_distortionCOP = {0.53f, 0.5f};
+    p.m_distortionPolynomialRed = {0, 1, -1.74f, 5.15f, -1.27f, -2.23f};
+    p.m_distortionPolynomialGreen = {0, 1, -1.74f, 5.15f, -1.27f, -2.23f};
+    p.m_distortionPolynomialBlue = {0, 1, -1.74f, 5.15f, -1.27f, -2.23f};
+    p.m_eyeWidthPixels = EYE_WIDTH;
+    p.m_eyeHeightPixels = EYE_HEIGHT;
+    return p;
+}
+
+/// Turn the indices of a mesh into a list of triangles, dropping the
+/// degenerate ones that join the columns of a triangle strip.
+static std::vector<uint16_t> triangleList(DistortionMesh const& mesh) {
+    if (mesh.topology == osvr::renderkit::TRIANGLE_LIST) {
+        return mesh.indices;
+    }
+    std::vector<uint16_t> ret;
+    for (size_t i = 2; i < mesh.indices.size(); i++) {
+        uint16_t a = mesh.indices[i - 2];
+        uint16_t b = mesh.indices[i - 1];
+        uint16_t c = mesh.indices[i];
+        if (a != b && b != c && a != c) {
+            ret.insert(ret.end(), {a, b, c});
+        }
+    }
+    return ret;
+}
+
+/// Largest difference, in display pixels, between the texture coordinates
+/// interpolated across the mesh's triangles and the exact distortion, over
+/// a grid of points that is much finer than the mesh.
+static double measureError(DistortionMesh const& mesh,
+                           DistortionParameters const& distort) {
+    const int GRID = 512;
+    const std::vector<std::unique_ptr<osvr::renderkit::UnstructuredMeshInterpolator> >
+        noInterpolators;
+    std::vector<uint16_t> triangles = triangleList(mesh);
+    double maxError = 0;
+    for (size_t t = 0; t + 2 < triangles.size(); t += 3) {
+        DistortionMeshVertex const* v[3] = {&mesh.vertices[triangles[t]],
+                                            &mesh.vertices[triangles[t + 1]],
+                                            &mesh.vertices[triangles[t + 2]]};
+        // Texture-space location of each corner.
+        double x[3], y[3];
+        for (int c = 0; c < 3; c++) {
+            x[c] = (v[c]->m_pos[0] + 1) / 2;
+            y[c] = (v[c]->m_pos[1] + 1) / 2;
+        }
+        double area = (x[1] - x[0]) * (y[2] - y[0]) -
+                      (x[2] - x[0]) * (y[1] - y[0]);
+        if (area == 0) {
+            continue;
+        }
+        int loX = std::max(0, static_cast<int>(
+            std::floor(*std::min_element(x, x + 3) * GRID)));
+        int hiX = std::min(GRID, static_cast<int>(
+            std::ceil(*std::max_element(x, x + 3) * GRID)));
+        int loY = std::max(0, static_cast<int>(
+            std::floor(*std::min_element(y, y + 3) * GRID)));
+        int hiY = std::min(GRID, static_cast<int>(
+            std::ceil(*std::max_element(y, y + 3) * GRID)));
+        for (int i = loX; i <= hiX; i++) {
+            for (int j = loY; j <= hiY; j++) {
+                double px = static_cast<double>(i) / GRID;
+                double py = static_cast<double>(j) / GRID;
+                double w[3];
+                w[0] = ((x[1] - px) * (y[2] - py) -
+                        (x[2] - px) * (y[1] - py)) / area;
+                w[1] = ((x[2] - px) * (y[0] - py) -
+                        (x[0] - px) * (y[2] - py)) / area;
+                w[2] = 1 - w[0] - w[1];
+                if (w[0] < -1e-9 || w[1] < -1e-9 || w[2] < -1e-9) {
+                    continue;
+                }
+                Float2 in = {static_cast<float>(px), static_cast<float>(py)};
+                for (size_t color = 0; color < 3; color++) {
+                    Float2 exact =
+                        osvr::renderkit::DistortionCorrectTextureCoordinate(
+                            0, in, distort, color, 1.0f, noInterpolators);
+                    double u = 0, v2 = 0;
+                    for (int c = 0; c < 3; c++) {
+                        Float2 const& tex = color == 0 ? v[c]->m_texRed
+                            : color == 1 ? v[c]->m_texGreen
+                                         : v[c]->m_texBlue;
+                        u += w[c] * tex[0];
+                        v2 += w[c] * tex[1];
+                    }
+                    double dx = (u - exact[0]) * EYE_WIDTH;
+                    double dy = (v2 - exact[1]) * EYE_HEIGHT;
+                    maxError =
+                        std::max(maxError, std::sqrt(dx * dx + dy * dy));
+                }
+            }
+        }
+    }
+    return maxError;
+}
+
+/// Largest difference, in display pixels, between the texture coordinates
+/// bilinearly filtered from a lookup table, as the GPU samples it, and the
+/// exact distortion, over the same grid of points as measureError().
+static double measureLookupError(DistortionLookupTable const& table,
+                                 DistortionParameters const& distort) {
+    const int GRID = 512;
+    const std::vector<std::unique_ptr<osvr::renderkit::UnstructuredMeshInterpolator> >
+        noInterpolators;
+    auto texel = [&](size_t color, int x, int y, int coord) {
+        x = std::min(std::max(x, 0), static_cast<int>(table.width) - 1);
+        y = std::min(std::max(y, 0), static_cast<int>(table.height) - 1);
+        size_t const i = static_cast<size_t>(y) * table.width + x;
+        return color < 2 ? table.redGreen[4 * i + 2 * color + coord]
+                         : table.blue[2 * i + coord];
+    };
+    double maxError = 0;
+    for (int i = 0; i <= GRID; i++) {
+        for (int j = 0; j <= GRID; j++) {
+            double px = static_cast<double>(i) / GRID;
+            double py = static_cast<double>(j) / GRID;
+            double fx = px * (table.width - 1);
+            double fy = py * (table.height - 1);
+            int x0 = static_cast<int>(std::floor(fx));
+            int y0 = static_cast<int>(std::floor(fy));
+            double ax = fx - x0;
+            double ay = fy - y0;
+            Float2 in = {static_cast<float>(px), static_cast<float>(py)};
+            for (size_t color = 0; color < 3; color++) {
+                Float2 exact =
+                    osvr::renderkit::DistortionCorrectTextureCoordinate(
+                        0, in, distort, color, 1.0f, noInterpolators);
+                double filtered[2];
+                for (int c = 0; c < 2; c++) {
+                    filtered[c] =
+                        (1 - ay) * ((1 - ax) * texel(color, x0, y0, c) +
+                                    ax * texel(color, x0 + 1, y0, c)) +
+                        ay * ((1 - ax) * texel(color, x0, y0 + 1, c) +
+                              ax * texel(color, x0 + 1, y0 + 1, c));
+                }
+                double dx = (filtered[0] - exact[0]) * EYE_WIDTH;
+                double dy = (filtered[1] - exact[1]) * EYE_HEIGHT;
+                maxError = std::max(maxError, std::sqrt(dx * dx + dy * dy));
+            }
+        }
+    }
+    return maxError;
+}
+
+static const char* vertexShader =
+    "#version 330 core\n"
+    "layout(location = 0) in vec2 position;\n"
+    "layout(location = 1) in vec2 texRed;\n"
+    "layout(location = 2) in vec2 texGreen;\n"
+    "layout(location = 3) in vec2 texBlue;\n"
+    "out vec2 red;\n"
+    "out vec2 green;\n"
+    "out vec2 blue;\n"
+    "void main() {\n"
+    "  gl_Position = vec4(position, 0, 1);\n"
+    "  red = texRed; green = texGreen; blue = texBlue;\n"
+    "}\n";
+
+static const char* fragmentShader =
+    "#version 330 core\n"
+    "uniform sampler2D tex;\n"
+    "in vec2 red;\n"
+    "in vec2 green;\n"
+    "in vec2 blue;\n"
+    "out vec4 color;\n"
+    "void main() {\n"
+    "  color = vec4(texture(tex, red).r, texture(tex, green).g,\n"
+    "               texture(tex, blue).b, 1);\n"
+    "}\n";
+
+static const char* lookupVertexShader =
+    "#version 330 core\n"
+    "layout(location = 0) in vec2 position;\n"
+    "uniform sampler2D lookupRedGreen;\n"
+    "out vec2 lookup;\n"
+    "void main() {\n"
+    "  gl_Position = vec4(position, 0, 1);\n"
+    "  vec2 size = vec2(textureSize(lookupRedGreen, 0));\n"
+    "  lookup = ((position * 0.5 + 0.5) * (size - 1.0) + 0.5) / size;\n"
+    "}\n";
+
+static const char* lookupFragmentShader =
+    "#version 330 core\n"
+    "uniform sampler2D tex;\n"
+    "uniform sampler2D lookupRedGreen;\n"
+    "uniform sampler2D lookupBlue;\n"
+    "in vec2 lookup;\n"
+    "out vec4 color;\n"
+    "void main() {\n"
+    "  vec4 redGreen = texture(lookupRedGreen, lookup);\n"
+    "  vec2 blue = texture(lookupBlue, lookup).rg;\n"
+    "  color = vec4(texture(tex, redGreen.rg).r, texture(tex, redGreen.ba).g,\n"
+    "               texture(tex, blue).b, 1);\n"
+    "}\n";
+
+static GLuint compileProgram(const char* vertexSource,
+                             const char* fragmentSource) {
+    GLuint program = glCreateProgram();
+    const char* sources[2] = {vertexSource, fragmentSource};
+    const GLenum types[2] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
+    for (int i = 0; i < 2; i++) {
+        GLuint shader = glCreateShader(types[i]);
+        glShaderSource(shader, 1, &sources[i], nullptr);
+        glCompileShader(shader);
+        GLint result = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &result);
+        if (result == GL_FALSE) {
+            std::cerr << "Could not compile shader" << std::endl;
+            return 0;
+        }
+        glAttachShader(program, shader);
+        glDeleteShader(shader);
+    }
+    glLinkProgram(program);
+    GLint result = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &result);
+    if (result == GL_FALSE) {
+        std::cerr << "Could not link shader program" << std::endl;
+        return 0;
+    }
+    return program;
+}
+
+/// Draw the mesh into the current framebuffer the given number of times
+/// and return the average GPU time per draw, in milliseconds.
+static double timePresent(DistortionMesh const& mesh, int repetitions) {
+    GLuint vertexArray, buffers[2];
+    glGenVertexArrays(1, &vertexArray);
+    glBindVertexArray(vertexArray);
+    glGenBuffers(2, buffers);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER,
+                 sizeof(mesh.vertices[0]) * mesh.vertices.size(),
+                 mesh.vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 sizeof(mesh.indices[0]) * mesh.indices.size(),
+                 mesh.indices.data(), GL_STATIC_DRAW);
+    const size_t offsets[4] = {offsetof(DistortionMeshVertex, m_pos),
+                               offsetof(DistortionMeshVertex, m_texRed),
+                               offsetof(DistortionMeshVertex, m_texGreen),
+                               offsetof(DistortionMeshVertex, m_texBlue)};
+    for (GLuint attrib = 0; attrib < 4; attrib++) {
+        glEnableVertexAttribArray(attrib);
+        glVertexAttribPointer(attrib, 2, GL_FLOAT, GL_FALSE,
+                              sizeof(DistortionMeshVertex),
+                              reinterpret_cast<const void*>(offsets[attrib]));
+    }
+    GLenum mode = mesh.topology == osvr::renderkit::TRIANGLE_LIST
+                      ? GL_TRIANGLES
+                      : GL_TRIANGLE_STRIP;
+    GLsizei count = static_cast<GLsizei>(mesh.indices.size());
+
+    // Warm up, then time the whole batch of draws.
+    glDrawElements(mode, count, GL_UNSIGNED_SHORT, nullptr);
+    glFinish();
+    GLuint query;
+    glGenQueries(1, &query);
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    for (int r = 0; r < repetitions; r++) {
+        glDrawElements(mode, count, GL_UNSIGNED_SHORT, nullptr);
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+
+    glDeleteQueries(1, &query);
+    glDeleteBuffers(2, buffers);
+    glDeleteVertexArrays(1, &vertexArray);
+    return elapsed * 1e-6 / repetitions;
+}
+
+/// Draw a quad that looks up its texture coordinates in the table, with
+/// bilinear filtering, the given number of times and return the average
+/// GPU time per draw, in milliseconds.  The lookup program must be in use.
+static double timePresentLookup(DistortionLookupTable const& table,
+                                int repetitions) {
+    GLuint lookupTextures[2];
+    glGenTextures(2, lookupTextures);
+    const GLenum formats[2][2] = {{GL_RGBA32F, GL_RGBA}, {GL_RG32F, GL_RG}};
+    const float* data[2] = {table.redGreen.data(), table.blue.data()};
+    for (int i = 0; i < 2; i++) {
+        glActiveTexture(GL_TEXTURE1 + i);
+        glBindTexture(GL_TEXTURE_2D, lookupTextures[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, formats[i][0],
+                     static_cast<GLsizei>(table.width),
+                     static_cast<GLsizei>(table.height), 0, formats[i][1],
+                     GL_FLOAT, data[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    static const float quad[] = {-1, -1, 1, -1, -1, 1, 1, 1};
+    GLuint vertexArray, buffer;
+    glGenVertexArrays(1, &vertexArray);
+    glBindVertexArray(vertexArray);
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float),
+                          nullptr);
+
+    // Warm up, then time the whole batch of draws.
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glFinish();
+    GLuint query;
+    glGenQueries(1, &query);
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    for (int r = 0; r < repetitions; r++) {
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+
+    glDeleteQueries(1, &query);
+    glDeleteBuffers(1, &buffer);
+    glDeleteVertexArrays(1, &vertexArray);
+    glDeleteTextures(2, lookupTextures);
+    return elapsed * 1e-6 / repetitions;
+}
+
+int main(int argc, char* argv[]) {
+    // Parse the command line
+    float desiredTriangles = 12800;
+    int repetitions = 200;
+    int realParams = 0;
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '-') {
+            Usage(argv[0]);
+        } else {
+            switch (++realParams) {
+            case 1:
+                desiredTriangles = static_cast<float>(atof(argv[i]));
+                break;
+            case 2:
+                repetitions = atoi(argv[i]);
+                break;
+            default:
+                Usage(argv[0]);
+            }
+        }
+    }
+    if (repetitions < 1) {
+        Usage(argv[0]);
+    }
+
+    // Build the SQUARE mesh and measure its error, then ask the other
+    // types for the same error.
+    DistortionParameters distort = makeParameters(desiredTriangles);
+    struct Entry {
+        const char* name;
+        DistortionMeshType type;
+        DistortionMesh mesh;
+        double error;
+    };
+    std::vector<Entry> entries = {
+        {"SQUARE", osvr::renderkit::SQUARE, DistortionMesh(), 0},
+        {"RADIAL", osvr::renderkit::RADIAL, DistortionMesh(), 0},
+        {"ADAPTIVE", osvr::renderkit::ADAPTIVE, DistortionMesh(), 0}};
+    for (auto& entry : entries) {
+        entry.mesh = osvr::renderkit::ComputeDistortionMesh(0, entry.type,
+                                                             distort, 1.0f);
+        if (entry.mesh.vertices.empty()) {
+            std::cerr << "Could not construct " << entry.name << " mesh"
+                      << std::endl;
+            return -1;
+        }
+        entry.error = measureError(entry.mesh, distort);
+        if (entry.type == osvr::renderkit::SQUARE) {
+            distort.m_maxMeshErrorPixels = static_cast<float>(entry.error);
+        }
+    }
+
+    // Draw into an offscreen eye-sized framebuffer from a texture of the
+    // same size, as the present pass does.
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        std::cerr << "Could not initialize SDL: " << SDL_GetError()
+                  << std::endl;
+        return -1;
+    }
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK,
+                        SDL_GL_CONTEXT_PROFILE_CORE);
+    SDL_Window* window = SDL_CreateWindow(
+        "DistortionMeshPresentBenchmark", SDL_WINDOWPOS_UNDEFINED,
+        SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+    SDL_GLContext context = window ? SDL_GL_CreateContext(window) : nullptr;
+    if (!context) {
+        std::cerr << "Could not create OpenGL context: " << SDL_GetError()
+                  << std::endl;
+        SDL_Quit();
+        return -1;
+    }
+    glewExperimental = true; // Needed for core profile
+    if (glewInit() != GLEW_OK) {
+        std::cerr << "Could not initialize GLEW" << std::endl;
+        SDL_Quit();
+        return -1;
+    }
+    GLuint program = compileProgram(vertexShader, fragmentShader);
+    GLuint lookupProgram =
+        compileProgram(lookupVertexShader, lookupFragmentShader);
+    if (!program || !lookupProgram) {
+        SDL_Quit();
+        return -1;
+    }
+    glUseProgram(lookupProgram);
+    glUniform1i(glGetUniformLocation(lookupProgram, "tex"), 0);
+    glUniform1i(glGetUniformLocation(lookupProgram, "lookupRedGreen"), 1);
+    glUniform1i(glGetUniformLocation(lookupProgram, "lookupBlue"), 2);
+    glUseProgram(program);
+
+    GLuint textures[2], framebuffer;
+    glGenTextures(2, textures);
+    for (GLuint tex : textures) {
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, EYE_WIDTH, EYE_HEIGHT, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                           GL_TEXTURE_2D, textures[1], 0);
+    glBindTexture(GL_TEXTURE_2D, textures[0]);
+    glViewport(0, 0, EYE_WIDTH, EYE_HEIGHT);
+
+    std::cout << "Meshes for a " << EYE_WIDTH << "x" << EYE_HEIGHT
+              << " eye at the error of a SQUARE mesh with "
+              << desiredTriangles << " desired triangles:" << std::endl;
+    for (auto const& entry : entries) {
+        double ms = timePresent(entry.mesh, repetitions);
+        std::cout << "  " << entry.name << ": "
+                  << entry.mesh.vertices.size() << " vertices, "
+                  << triangleList(entry.mesh).size() / 3 << " triangles, "
+                  << entry.error << " px max error, " << ms
+                  << " ms GPU per present" << std::endl;
+    }
+
+    // Lookup textures at one texel per pixel and at reduced resolutions,
+    // bilinearly filtered.
+    std::cout << "Lookup textures for the same eye:" << std::endl;
+    glUseProgram(lookupProgram);
+    for (int downsample : {1, 2, 4, 8}) {
+        size_t const width = (EYE_WIDTH + downsample - 1) / downsample;
+        size_t const height = (EYE_HEIGHT + downsample - 1) / downsample;
+        DistortionLookupTable table =
+            osvr::renderkit::ComputeDistortionLookupTable(
+                0, distort, 1.0f, width, height, 0);
+        if (table.width == 0) {
+            std::cerr << "Could not construct lookup table" << std::endl;
+            return -1;
+        }
+        double ms = timePresentLookup(table, repetitions);
+        std::cout << "  1/" << downsample << ": " << width << "x" << height
+                  << " texels, " << measureLookupError(table, distort)
+                  << " px max error, " << ms << " ms GPU per present"
+                  << std::endl;
+    }
+
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(2, textures);
+    glDeleteProgram(lookupProgram);
+    glDeleteProgram(program);
+    SDL_GL_DeleteContext(context);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
@@ -27,6 +27,8 @@
 #include "ComputeDistortionMesh.h"
 #include "UnstructuredMeshInterpolator.h"
 #include "DistortionCorrectTextureCoordinate.h"
+#include "DistortionCorrectBatch.h"
+#include "DistortionMeshCache.h"
 
 // Library/third-party includes
 // - none
@@ -34,54 +36,818 @@
 // Standard includes
 #include <iostream>
 #include <cmath>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <limits>
 
 namespace osvr {
 namespace renderkit {
 
-    DistortionMesh ComputeDistortionMesh(size_t eye, DistortionMeshType type, DistortionParameters distort, float overfillFactor) {
-        DistortionMesh ret;
+    /// Resolve a requested thread count, where 0 means one per hardware
+    /// thread, into the number of threads to use.
+    static unsigned resolveThreadCount(unsigned numThreads) {
+        if (numThreads == 0) {
+            numThreads = std::thread::hardware_concurrency();
+        }
+        return std::max(numThreads, 1u);
+    }
 
-        // Check the validity of the parameters, based on the ones we're
-        // using.
+    /// Compute the distorted vertices for the columns of a SQUARE mesh
+    /// in the range [xBegin, xEnd), appending them in column-major order.
+    static void ComputeSquareMeshColumns(
+        int xBegin, int xEnd, int numVertsPerSide, float quadSide,
+        float quadTexSide, size_t eye, DistortionParameters const& distort,
+        float overfillFactor,
+        std::vector< std::unique_ptr<UnstructuredMeshInterpolator> > const&
+            interpolators,
+        std::vector<DistortionMeshVertex>& vertices) {
+        vertices.reserve(vertices.size() +
+                         static_cast<size_t>(xEnd - xBegin) * numVertsPerSide);
+
+        // Polynomial distortion is evaluated a column at a time using
+        // the batch interface.
+        if (distort.m_type ==
+            DistortionParameters::rgb_symmetric_polynomials) {
+            RGBSymmetricPolynomialBatch batch(distort, overfillFactor);
+            size_t const n = static_cast<size_t>(numVertsPerSide);
+            std::vector<float> texX(n), texY(n);
+            std::vector<float> outX[3], outY[3];
+            float* outXPtrs[3];
+            float* outYPtrs[3];
+            for (size_t c = 0; c < 3; c++) {
+                outX[c].resize(n);
+                outY[c].resize(n);
+                outXPtrs[c] = outX[c].data();
+                outYPtrs[c] = outY[c].data();
+            }
+            for (int y = 0; y < numVertsPerSide; y++) {
+                texY[y] = y * quadTexSide;
+            }
+            for (int x = xBegin; x < xEnd; x++) {
+                float xPos = -1 + x * quadSide;
+                float xTex = x * quadTexSide;
+                std::fill(texX.begin(), texX.end(), xTex);
+                batch.correctRGB(n, texX.data(), texY.data(), outXPtrs,
+                                 outYPtrs);
+                for (size_t y = 0; y < n; y++) {
+                    Float2 pos = { xPos, -1 + static_cast<int>(y) * quadSide };
+                    vertices.emplace_back(pos,
+                        Float2{ outX[0][y], outY[0][y] },
+                        Float2{ outX[1][y], outY[1][y] },
+                        Float2{ outX[2][y], outY[2][y] });
+                }
+            }
+            return;
+        }
+
+        for (int x = xBegin; x < xEnd; x++) {
+            float xPos = -1 + x * quadSide;
+            float xTex = x * quadTexSide;
+
+            for (int y = 0; y < numVertsPerSide; y++) {
+                float yPos = -1 + y * quadSide;
+                float yTex = y * quadTexSide;
+
+                Float2 pos = { xPos, yPos };
+                Float2 tex = { xTex, yTex };
+
+                vertices.emplace_back(pos,
+                    DistortionCorrectTextureCoordinate(eye, tex, distort, 0, overfillFactor, interpolators),
+                    DistortionCorrectTextureCoordinate(eye, tex, distort, 1, overfillFactor, interpolators),
+                    DistortionCorrectTextureCoordinate(eye, tex, distort, 2, overfillFactor, interpolators));
+            }
+        }
+    }
+
+    /// Distortion-corrected texture coordinates for the three colors.
+    struct CorrectedSample {
+        Float2 tex[3];
+    };
+
+    /// Distortion-correct a point in texture space for all three colors.
+    static CorrectedSample CorrectRGB(size_t eye, float x, float y,
+        DistortionParameters const& distort, float overfillFactor,
+        std::vector< std::unique_ptr<UnstructuredMeshInterpolator> > const&
+            interpolators) {
+        CorrectedSample ret;
+        Float2 tex = { x, y };
+        for (size_t c = 0; c < 3; c++) {
+            ret.tex[c] = DistortionCorrectTextureCoordinate(eye, tex, distort,
+                c, overfillFactor, interpolators);
+        }
+        return ret;
+    }
+
+    /// Find how many pixels of the rendered texture one unit of texture
+    /// coordinate covers in X and Y, used to measure mesh errors in pixels.
+    /// When the size of the eye is not known, measure against a 1024-pixel
+    /// square.
+    static void MeshErrorPixelScale(DistortionParameters const& distort,
+                                    float overfillFactor, float texPixels[2]) {
+        float width = distort.m_eyeWidthPixels > 0
+            ? distort.m_eyeWidthPixels : 1024.0f;
+        float height = distort.m_eyeHeightPixels > 0
+            ? distort.m_eyeHeightPixels : 1024.0f;
+        texPixels[0] = width * overfillFactor;
+        texPixels[1] = height * overfillFactor;
+    }
+
+    /// Builds an ADAPTIVE mesh: a coarse grid of quads over texture space,
+    /// each the root of a quadtree whose quads are split wherever drawing
+    /// them as two triangles would interpolate the distortion with more
+    /// than the allowed error in pixels.  The finest level matches the grid
+    /// of a SQUARE mesh with the given number of quads per side.  The
+    /// trees are then balanced so that neighboring leaves differ by at most
+    /// one level, and leaves that border finer ones are drawn as a fan
+    /// around their center that passes through the shared edge midpoints,
+    /// so that the mesh has no cracks.
+    class AdaptiveMeshBuilder {
+      public:
+        AdaptiveMeshBuilder(size_t eye, DistortionParameters const& distort,
+            float overfillFactor,
+            std::vector< std::unique_ptr<UnstructuredMeshInterpolator> > const&
+                interpolators,
+            int quadsPerSide)
+            : m_eye(eye), m_distort(distort), m_overfillFactor(overfillFactor),
+              m_interpolators(interpolators) {
+            // Use as many levels as we can while keeping at least four
+            // coarse quads per side, then enough coarse quads to reach
+            // the requested resolution.
+            quadsPerSide = std::max(quadsPerSide, 1);
+            m_maxLevel = 0;
+            while ((4 << (m_maxLevel + 1)) <= quadsPerSide) {
+                m_maxLevel++;
+            }
+            m_baseQuads = (quadsPerSide + (1 << m_maxLevel) - 1) >> m_maxLevel;
+            m_cells = m_baseQuads << m_maxLevel;
+            m_lattice = 2 * m_cells + 1;
+            size_t const latticePoints =
+                static_cast<size_t>(m_lattice) * m_lattice;
+            m_levels.assign(static_cast<size_t>(m_cells) * m_cells, 0);
+            m_samples.resize(latticePoints);
+            m_computed.assign(latticePoints, false);
+            m_vertexIndex.assign(latticePoints, -1);
+
+            MeshErrorPixelScale(distort, overfillFactor, m_texPixels);
+            m_maxError = distort.m_maxMeshErrorPixels;
+        }
+
+        void build(DistortionMesh& mesh) {
+            for (int iy = 0; iy < m_baseQuads; iy++) {
+                for (int ix = 0; ix < m_baseQuads; ix++) {
+                    refine(0, ix, iy);
+                }
+            }
+            while (balance()) {
+            }
+            mesh.topology = TRIANGLE_LIST;
+            for (int iy = 0; iy < m_baseQuads; iy++) {
+                for (int ix = 0; ix < m_baseQuads; ix++) {
+                    emit(0, ix, iy, mesh);
+                }
+            }
+        }
+
+      private:
+        /// Distortion-corrected point on the lattice, which has two points
+        /// per finest cell in each direction so that it includes the cell
+        /// centers.  Each point is only computed once.
+        CorrectedSample const& latticeSample(int lx, int ly) {
+            size_t const i = static_cast<size_t>(ly) * m_lattice + lx;
+            if (!m_computed[i]) {
+                float const scale = 1.0f / (m_lattice - 1);
+                m_samples[i] = CorrectRGB(m_eye, lx * scale, ly * scale,
+                    m_distort, m_overfillFactor, m_interpolators);
+                m_computed[i] = true;
+            }
+            return m_samples[i];
+        }
+
+        /// Largest error, in pixels, between the true distortion at a set
+        /// of points in the quad and the distortion interpolated across the
+        /// two triangles the quad would be drawn with, which are split
+        /// along the diagonal from its lower-left to its upper-right corner.
+        float quadError(int level, int ix, int iy) {
+            int const span = 2 * cellSpan(level); // Lattice steps per side
+            int const lx = ix * span;
+            int const ly = iy * span;
+            CorrectedSample const c00 = latticeSample(lx, ly);
+            CorrectedSample const c10 = latticeSample(lx + span, ly);
+            CorrectedSample const c11 = latticeSample(lx + span, ly + span);
+            CorrectedSample const c01 = latticeSample(lx, ly + span);
+
+            // Edge midpoints, center and quarter points.  Quads are only
+            // tested above the finest level, so these are all lattice points.
+            static const float POINTS[][2] = {
+                {0.5f, 0.0f}, {1.0f, 0.5f}, {0.5f, 1.0f}, {0.0f, 0.5f},
+                {0.5f, 0.5f}, {0.25f, 0.25f}, {0.75f, 0.25f},
+                {0.75f, 0.75f}, {0.25f, 0.75f}};
+            float maxError = 0;
+            for (auto const& p : POINTS) {
+                float const s = p[0];
+                float const t = p[1];
+                CorrectedSample const& truth =
+                    latticeSample(lx + static_cast<int>(s * span),
+                                  ly + static_cast<int>(t * span));
+                for (size_t c = 0; c < 3; c++) {
+                    for (size_t d = 0; d < 2; d++) {
+                        float interp;
+                        if (s >= t) {
+                            interp = c00.tex[c][d] +
+                                     s * (c10.tex[c][d] - c00.tex[c][d]) +
+                                     t * (c11.tex[c][d] - c10.tex[c][d]);
+                        } else {
+                            interp = c00.tex[c][d] +
+                                     t * (c01.tex[c][d] - c00.tex[c][d]) +
+                                     s * (c11.tex[c][d] - c01.tex[c][d]);
+                        }
+                        float const error = std::abs(interp - truth.tex[c][d]) *
+                                            m_texPixels[d];
+                        maxError = std::max(maxError, error);
+                    }
+                }
+            }
+            return maxError;
+        }
+
+        /// Number of finest cells along each side of a quad.
+        int cellSpan(int level) const { return 1 << (m_maxLevel - level); }
+
+        /// Set the level of all of the finest cells covered by a quad.
+        void setLevel(int level, int ix, int iy) {
+            int const span = cellSpan(level);
+            for (int y = iy * span; y < (iy + 1) * span; y++) {
+                for (int x = ix * span; x < (ix + 1) * span; x++) {
+                    m_levels[static_cast<size_t>(y) * m_cells + x] =
+                        static_cast<uint8_t>(level);
+                }
+            }
+        }
+
+        /// Level of the leaf covering a finest cell.
+        int levelAt(int x, int y) const {
+            return m_levels[static_cast<size_t>(y) * m_cells + x];
+        }
+
+        /// Split quads until they are accurate enough or at the finest
+        /// level.
+        void refine(int level, int ix, int iy) {
+            if (level < m_maxLevel && quadError(level, ix, iy) > m_maxError) {
+                for (int child = 0; child < 4; child++) {
+                    refine(level + 1, 2 * ix + (child & 1),
+                           2 * iy + (child >> 1));
+                }
+            } else {
+                setLevel(level, ix, iy);
+            }
+        }
+
+        /// Split each leaf that borders a leaf more than one level finer.
+        /// @return true if any leaf was split.
+        bool balance() {
+            bool changed = false;
+            for (int y = 0; y < m_cells; y++) {
+                for (int x = 0; x < m_cells; x++) {
+                    int const level = levelAt(x, y);
+                    int const span = cellSpan(level);
+                    if (x % span || y % span) {
+                        continue; // Not the lower-left cell of its leaf
+                    }
+                    bool split = false;
+                    for (int i = 0; i < span && !split; i++) {
+                        split = (x > 0 && levelAt(x - 1, y + i) > level + 1) ||
+                            (x + span < m_cells &&
+                             levelAt(x + span, y + i) > level + 1) ||
+                            (y > 0 && levelAt(x + i, y - 1) > level + 1) ||
+                            (y + span < m_cells &&
+                             levelAt(x + i, y + span) > level + 1);
+                    }
+                    if (split) {
+                        for (int child = 0; child < 4; child++) {
+                            setLevel(level + 1, 2 * (x / span) + (child & 1),
+                                     2 * (y / span) + (child >> 1));
+                        }
+                        changed = true;
+                    }
+                }
+            }
+            return changed;
+        }
+
+        /// Index of the mesh vertex at a lattice point, adding it to the
+        /// mesh the first time it is used.
+        uint16_t vertex(int lx, int ly, DistortionMesh& mesh) {
+            size_t const i = static_cast<size_t>(ly) * m_lattice + lx;
+            if (m_vertexIndex[i] < 0) {
+                CorrectedSample const& sample = latticeSample(lx, ly);
+                float const scale = 2.0f / (m_lattice - 1);
+                Float2 pos = { -1 + lx * scale, -1 + ly * scale };
+                m_vertexIndex[i] = static_cast<int32_t>(mesh.vertices.size());
+                mesh.vertices.emplace_back(pos, sample.tex[0], sample.tex[1],
+                                           sample.tex[2]);
+            }
+            return static_cast<uint16_t>(m_vertexIndex[i]);
+        }
+
+        /// Add the triangles for the leaves under a quad, in Z order so
+        /// that nearby triangles share recently-used vertices.
+        void emit(int level, int ix, int iy, DistortionMesh& mesh) {
+            int const span = cellSpan(level);
+            int const x = ix * span;
+            int const y = iy * span;
+            if (levelAt(x, y) > level) {
+                for (int child = 0; child < 4; child++) {
+                    emit(level + 1, 2 * ix + (child & 1),
+                         2 * iy + (child >> 1), mesh);
+                }
+                return;
+            }
+
+            // Lattice coordinates of the corners.
+            int const x0 = 2 * x, x1 = 2 * (x + span), xm = x0 + span;
+            int const y0 = 2 * y, y1 = 2 * (y + span), ym = y0 + span;
+            bool const finerBelow = y > 0 && levelAt(x, y - 1) > level;
+            bool const finerRight =
+                x + span < m_cells && levelAt(x + span, y) > level;
+            bool const finerAbove =
+                y + span < m_cells && levelAt(x, y + span) > level;
+            bool const finerLeft = x > 0 && levelAt(x - 1, y) > level;
+
+            uint16_t const ll = vertex(x0, y0, mesh);
+            uint16_t const hl = vertex(x1, y0, mesh);
+            uint16_t const hh = vertex(x1, y1, mesh);
+            uint16_t const lh = vertex(x0, y1, mesh);
+            if (!(finerBelow || finerRight || finerAbove || finerLeft)) {
+                uint16_t const tris[] = {ll, hl, hh, ll, hh, lh};
+                mesh.indices.insert(mesh.indices.end(), std::begin(tris),
+                                    std::end(tris));
+                return;
+            }
+
+            // Fan around the center through the corners and the midpoints
+            // of the edges shared with finer leaves.
+            std::vector<uint16_t> ring;
+            ring.push_back(ll);
+            if (finerBelow) {
+                ring.push_back(vertex(xm, y0, mesh));
+            }
+            ring.push_back(hl);
+            if (finerRight) {
+                ring.push_back(vertex(x1, ym, mesh));
+            }
+            ring.push_back(hh);
+            if (finerAbove) {
+                ring.push_back(vertex(xm, y1, mesh));
+            }
+            ring.push_back(lh);
+            if (finerLeft) {
+                ring.push_back(vertex(x0, ym, mesh));
+            }
+            uint16_t const center = vertex(xm, ym, mesh);
+            for (size_t i = 0; i < ring.size(); i++) {
+                mesh.indices.push_back(center);
+                mesh.indices.push_back(ring[i]);
+                mesh.indices.push_back(ring[(i + 1) % ring.size()]);
+            }
+        }
+
+        size_t m_eye;
+        DistortionParameters const& m_distort;
+        float m_overfillFactor;
+        std::vector< std::unique_ptr<UnstructuredMeshInterpolator> > const&
+            m_interpolators;
+        int m_maxLevel;  ///< Levels below the coarse quads
+        int m_baseQuads; ///< Coarse quads per side
+        int m_cells;     ///< Finest cells per side
+        int m_lattice; ///< Lattice points per side
+        float m_texPixels[2];
+        float m_maxError;
+        std::vector<uint8_t> m_levels; ///< Leaf level of each finest cell
+        std::vector<CorrectedSample> m_samples;
+        std::vector<bool> m_computed;
+        std::vector<int32_t> m_vertexIndex;
+    };
+
+    /// Builds a RADIAL mesh: rings of vertices around the center of
+    /// projection joined by spokes, drawn as a fan around the center and a
+    /// band of triangles between each two rings.  The rings are scaled to
+    /// be round in the space in which the distortion is symmetric (D space
+    /// for polynomial distortion, display pixels otherwise).  They are
+    /// spaced more closely where the radial distortion curves more, and
+    /// each ring has as many spokes as are needed to follow the distortion
+    /// around it, so that both stay within the pixel tolerance.
+    /// Rings that go beyond the edges of the texture are clipped to them,
+    /// with spokes added through the corners so the mesh covers the whole
+    /// texture.
+    class RadialMeshBuilder {
+      public:
+        RadialMeshBuilder(size_t eye, DistortionParameters const& distort,
+            float overfillFactor,
+            std::vector< std::unique_ptr<UnstructuredMeshInterpolator> > const&
+                interpolators)
+            : m_eye(eye), m_distort(distort), m_overfillFactor(overfillFactor),
+              m_interpolators(interpolators) {
+            // The center of projection is in the normalized space, which
+            // the overfill factor stretches to texture space.
+            for (size_t i = 0; i < 2; i++) {
+                float cop = distort.m_distortionCOP.size() == 2
+                    ? distort.m_distortionCOP[i] : 0.5f;
+                m_center[i] = std::min(1.0f, std::max(0.0f,
+                    (cop - 0.5f) / overfillFactor + 0.5f));
+            }
+            MeshErrorPixelScale(distort, overfillFactor, m_texPixels);
+            if (distort.m_type ==
+                    DistortionParameters::rgb_symmetric_polynomials &&
+                distort.m_distortionD.size() == 2) {
+                m_scale[0] = distort.m_distortionD[0];
+                m_scale[1] = distort.m_distortionD[1];
+            } else {
+                m_scale[0] = m_texPixels[0];
+                m_scale[1] = m_texPixels[1];
+            }
+        }
+
+        void build(DistortionMesh& mesh) {
+            // The farthest corner sets the radius of the outermost ring.
+            std::vector<double> cornerAngles;
+            float maxRadius = 0;
+            for (int corner = 0; corner < 4; corner++) {
+                double angle = std::atan2(
+                    ((corner >> 1) - m_center[1]) * m_scale[1],
+                    ((corner & 1) - m_center[0]) * m_scale[0]);
+                cornerAngles.push_back(angle);
+                maxRadius = std::max(maxRadius, rayLength(angle));
+            }
+            if (maxRadius <= 0) {
+                return;
+            }
+            m_dr = maxRadius / STEPS;
+            measureCurvature(cornerAngles);
+
+            // Loosen the spacing until the mesh fits within the requested
+            // number of triangles, and never use so many vertices that
+            // the indices overflow 16 bits.
+            double const maxTriangles =
+                std::max<double>(m_distort.m_desiredTriangles, 16);
+            float tolerance = std::max(m_distort.m_maxMeshErrorPixels, 1e-3f);
+            std::vector<float> radii;
+            std::vector<int> spokes;
+            while (true) {
+                plan(tolerance, radii, spokes);
+                double triangles = 0;
+                double vertices = 1;
+                for (size_t ring = 0; ring < radii.size(); ring++) {
+                    triangles += spokes[ring] + (ring ? spokes[ring - 1] : 0);
+                    vertices += spokes[ring] + 4;
+                }
+                if ((triangles <= maxTriangles && vertices <= 65535) ||
+                    (radii.size() == 1 && spokes[0] == MIN_SPOKES)) {
+                    break;
+                }
+                tolerance *= 1.25f;
+            }
+            radii.back() = maxRadius;
+
+            // Vertices, ring by ring, each ring joined to the one inside
+            // it by zipping the two sets of spokes together in angle
+            // order.  Where a ring and the one inside it are both clipped
+            // at the same spoke, they share the vertex on the edge of the
+            // texture.
+            mesh.topology = TRIANGLE_LIST;
+            std::vector<double> innerAngles;
+            std::vector<uint16_t> inner;
+            std::vector<float> innerRadii;
+            uint16_t const center = addVertex(0, 0, mesh);
+            for (size_t ring = 0; ring < radii.size(); ring++) {
+                std::vector<double> angles = cornerAngles;
+                for (int spoke = 0; spoke < spokes[ring]; spoke++) {
+                    angles.push_back(-PI + 2 * PI * spoke / spokes[ring]);
+                }
+                std::sort(angles.begin(), angles.end());
+                angles.erase(std::unique(angles.begin(), angles.end(),
+                    [](double a, double b) { return b - a < 1e-9; }),
+                    angles.end());
+                if (angles.back() - angles.front() > 2 * PI - 1e-9) {
+                    angles.pop_back();
+                }
+
+                std::vector<uint16_t> outer(angles.size());
+                std::vector<float> outerRadii(angles.size());
+                size_t match = 0;
+                for (size_t a = 0; a < angles.size(); a++) {
+                    float const length = rayLength(angles[a]);
+                    outerRadii[a] = std::min(radii[ring], length);
+                    while (match < innerAngles.size() &&
+                           innerAngles[match] < angles[a] - 1e-9) {
+                        match++;
+                    }
+                    if (match < innerAngles.size() &&
+                        innerAngles[match] - angles[a] < 1e-9 &&
+                        innerRadii[match] >= length) {
+                        outer[a] = inner[match];
+                    } else {
+                        outer[a] = addVertex(outerRadii[a], angles[a], mesh);
+                    }
+                }
+
+                if (inner.empty()) {
+                    for (size_t a = 0; a < outer.size(); a++) {
+                        addTriangle(center, outer[a],
+                                    outer[(a + 1) % outer.size()], mesh);
+                    }
+                } else {
+                    // Both rings have a spoke at -PI, where the zip
+                    // starts and ends.
+                    size_t i = 0, o = 0;
+                    while (i < inner.size() || o < outer.size()) {
+                        double const nextInner = i + 1 < inner.size()
+                            ? innerAngles[i + 1] : PI + 1;
+                        double const nextOuter = o + 1 < angles.size()
+                            ? angles[o + 1] : PI + 1;
+                        if (i < inner.size() &&
+                            (nextInner < nextOuter || o == outer.size())) {
+                            addTriangle(inner[i], outer[o % outer.size()],
+                                        inner[(i + 1) % inner.size()], mesh);
+                            i++;
+                        } else {
+                            addTriangle(inner[i % inner.size()], outer[o],
+                                        outer[(o + 1) % outer.size()], mesh);
+                            o++;
+                        }
+                    }
+                }
+                innerAngles.swap(angles);
+                inner.swap(outer);
+                innerRadii.swap(outerRadii);
+            }
+        }
+
+      private:
+        static const int STEPS = 128;     ///< Radial steps when measuring
+        static const int MIN_SPOKES = 8;
+        static constexpr double PI = 3.14159265358979323846;
+
+        /// Measure how far the distortion is from linear along the rays
+        /// from the center, including the ones through the corners, and
+        /// along short chords across them, in pixels per unit radius
+        /// squared and per radian squared, at each radial step.
+        void measureCurvature(std::vector<double> const& cornerAngles) {
+            double const dTheta = 2 * PI / 256;
+            float const dr = m_dr;
+            std::vector<double> rays = cornerAngles;
+            for (int ray = 0; ray < 16; ray++) {
+                rays.push_back(-PI + 2 * PI * ray / 16);
+            }
+            m_radialCurvature.assign(STEPS + 1, 0);
+            m_angularCurvature.assign(STEPS + 1, 0);
+            int lastMeasured = 1;
+            for (double angle : rays) {
+                float const length = rayLength(angle);
+                float const chordLength = std::min(length,
+                    std::min(rayLength(angle - dTheta),
+                             rayLength(angle + dTheta)));
+                CorrectedSample prev = correct(0, angle);
+                CorrectedSample cur = correct(dr, angle);
+                for (int step = 1; step < STEPS && (step + 1) * dr <= length;
+                     step++) {
+                    CorrectedSample next = correct((step + 1) * dr, angle);
+                    m_radialCurvature[step] = std::max(
+                        m_radialCurvature[step],
+                        secondDifference(prev, cur, next) / (dr * dr));
+                    if (step * dr <= chordLength) {
+                        // Compare the middle of the chord with the ends,
+                        // so that the bend of the ring itself, which the
+                        // triangles follow exactly, is not counted.
+                        Float2 a = texCoord(step * dr, angle - dTheta);
+                        Float2 b = texCoord(step * dr, angle + dTheta);
+                        float const across = secondDifference(
+                            correctTex(a[0], a[1]),
+                            correctTex((a[0] + b[0]) / 2, (a[1] + b[1]) / 2),
+                            correctTex(b[0], b[1]));
+                        m_angularCurvature[step] = std::max(
+                            m_angularCurvature[step],
+                            across / static_cast<float>(dTheta * dTheta));
+                    }
+                    lastMeasured = std::max(lastMeasured, step);
+                    prev = cur;
+                    cur = next;
+                }
+            }
+
+            // Only the longest rays reach the outermost steps; carry the
+            // last measurements out to them.
+            for (int step = 0; step <= STEPS; step++) {
+                int const from = std::min(std::max(step, 1), lastMeasured);
+                m_radialCurvature[step] = m_radialCurvature[from];
+                m_angularCurvature[step] = m_angularCurvature[from];
+            }
+        }
+
+        /// Choose the ring radii and the number of spokes in each ring for
+        /// a tolerance.  Linear interpolation over a step h is off by about
+        /// h * h * curvature / 8.  The rings are placed at equal steps of
+        /// the integral of the square root of the radial curvature, which
+        /// spreads the error evenly across them.  Each ring has a power of
+        /// two times as many spokes as the smallest ring, at least as many
+        /// as the ring inside it.  The error budget is split between the
+        /// radial, around-the-ring and diagonal directions, with a margin
+        /// for the estimates.
+        void plan(float tolerance, std::vector<float>& radii,
+                  std::vector<int>& spokes) const {
+            float const budget = tolerance / 4;
+            std::vector<double> cumulative(STEPS + 1, 0);
+            for (int step = 1; step <= STEPS; step++) {
+                cumulative[step] = cumulative[step - 1] + m_dr * 0.5 *
+                    (std::sqrt(m_radialCurvature[step - 1] / (8 * budget)) +
+                     std::sqrt(m_radialCurvature[step] / (8 * budget)));
+            }
+            int const numRings =
+                static_cast<int>(std::max(1.0, std::ceil(cumulative[STEPS])));
+
+            radii.clear();
+            spokes.clear();
+            int step = 0;
+            for (int ring = 1; ring <= numRings; ring++) {
+                double const target = cumulative[STEPS] * ring / numRings;
+                float radius;
+                if (cumulative[STEPS] <= 0) {
+                    radius = m_dr * STEPS * ring / numRings;
+                } else {
+                    while (step < STEPS - 1 && cumulative[step + 1] < target) {
+                        step++;
+                    }
+                    double const span =
+                        cumulative[step + 1] - cumulative[step];
+                    double const frac =
+                        span > 0 ? (target - cumulative[step]) / span : 0;
+                    radius = static_cast<float>(
+                        m_dr * (step + std::min(1.0, std::max(0.0, frac))));
+                }
+                int const last = std::min(STEPS,
+                    static_cast<int>(std::ceil(radius / m_dr)));
+                float curvature = m_angularCurvature[last];
+                double const needed =
+                    2 * PI * std::sqrt(curvature / (8 * budget));
+                int count = spokes.empty() ? MIN_SPOKES : spokes.back();
+                while (count < needed && count < 4096) {
+                    count *= 2;
+                }
+                radii.push_back(radius);
+                spokes.push_back(count);
+            }
+        }
+
+        /// Distance from the center to the edge of the texture along a
+        /// ray, in scaled units.
+        float rayLength(double angle) const {
+            float ret = std::numeric_limits<float>::max();
+            for (size_t i = 0; i < 2; i++) {
+                float const dir = static_cast<float>(
+                    (i == 0 ? std::cos(angle) : std::sin(angle)) / m_scale[i]);
+                if (dir > 1e-9f) {
+                    ret = std::min(ret, (1 - m_center[i]) / dir);
+                } else if (dir < -1e-9f) {
+                    ret = std::min(ret, -m_center[i] / dir);
+                }
+            }
+            return std::max(ret, 0.0f);
+        }
+
+        /// Texture coordinate at a radius and angle from the center.
+        Float2 texCoord(float radius, double angle) const {
+            Float2 ret;
+            for (size_t i = 0; i < 2; i++) {
+                float const dir = static_cast<float>(
+                    (i == 0 ? std::cos(angle) : std::sin(angle)) / m_scale[i]);
+                ret[i] = std::min(1.0f, std::max(0.0f,
+                                                 m_center[i] + radius * dir));
+            }
+            return ret;
+        }
+
+        CorrectedSample correctTex(float x, float y) const {
+            return CorrectRGB(m_eye, x, y, m_distort, m_overfillFactor,
+                              m_interpolators);
+        }
+
+        CorrectedSample correct(float radius, double angle) const {
+            Float2 tex = texCoord(radius, angle);
+            return correctTex(tex[0], tex[1]);
+        }
+
+        /// Largest second difference across three samples, in pixels.
+        float secondDifference(CorrectedSample const& a,
+                               CorrectedSample const& b,
+                               CorrectedSample const& c) const {
+            float ret = 0;
+            for (size_t color = 0; color < 3; color++) {
+                for (size_t d = 0; d < 2; d++) {
+                    ret = std::max(ret, std::abs(a.tex[color][d] -
+                        2 * b.tex[color][d] + c.tex[color][d]) *
+                        m_texPixels[d]);
+                }
+            }
+            return ret;
+        }
+
+        uint16_t addVertex(float radius, double angle, DistortionMesh& mesh) {
+            Float2 tex = texCoord(radius, angle);
+            CorrectedSample sample = correctTex(tex[0], tex[1]);
+            Float2 pos = { -1 + 2 * tex[0], -1 + 2 * tex[1] };
+            mesh.vertices.emplace_back(pos, sample.tex[0], sample.tex[1],
+                                       sample.tex[2]);
+            return static_cast<uint16_t>(mesh.vertices.size() - 1);
+        }
+
+        /// Add a triangle unless clipping has collapsed it.
+        static void addTriangle(uint16_t a, uint16_t b, uint16_t c,
+                                DistortionMesh& mesh) {
+            if (a != b && b != c && a != c) {
+                mesh.indices.push_back(a);
+                mesh.indices.push_back(b);
+                mesh.indices.push_back(c);
+            }
+        }
+
+        size_t m_eye;
+        DistortionParameters const& m_distort;
+        float m_overfillFactor;
+        std::vector< std::unique_ptr<UnstructuredMeshInterpolator> > const&
+            m_interpolators;
+        float m_center[2];    ///< Center of projection in texture space
+        float m_scale[2];     ///< Scale that makes the distortion round
+        float m_texPixels[2];
+        float m_dr = 0;       ///< Radial step when measuring
+        std::vector<float> m_radialCurvature;
+        std::vector<float> m_angularCurvature;
+    };
+
+    const int RadialMeshBuilder::STEPS;
+    const int RadialMeshBuilder::MIN_SPOKES;
+    constexpr double RadialMeshBuilder::PI;
+
+    /// Check that the distortion parameters have what their type needs,
+    /// reporting problems with the name of the caller.
+    static bool CheckDistortionParameters(DistortionParameters const& distort,
+                                          const char* caller) {
         if (distort.m_type ==
             DistortionParameters::rgb_symmetric_polynomials) {
             if (distort.m_distortionPolynomialRed.size() < 2) {
-                std::cerr << "ComputeDistortionMesh: Need 2+ "
+                std::cerr << caller << ": Need 2+ "
                     "red polynomial coefficients, found "
                     << distort.m_distortionPolynomialRed.size()
                     << std::endl;
-                return ret;
+                return false;
             }
             if (distort.m_distortionPolynomialGreen.size() < 2) {
-                std::cerr << "ComputeDistortionMesh: Need 2+ "
+                std::cerr << caller << ": Need 2+ "
                     "green polynomial coefficients, found "
                     << distort.m_distortionPolynomialGreen.size()
                     << std::endl;
-                return ret;
+                return false;
             }
             if (distort.m_distortionPolynomialBlue.size() < 2) {
-                std::cerr << "ComputeDistortionMesh: Need 2+ "
+                std::cerr << caller << ": Need 2+ "
                     "blue polynomial coefficients, found "
                     << distort.m_distortionPolynomialBlue.size()
                     << std::endl;
-                return ret;
+                return false;
             }
             if (distort.m_distortionD.size() != 2) {
-                std::cerr << "ComputeDistortionMesh: Need 2 "
+                std::cerr << caller << ": Need 2 "
                     "distortion coefficients, found "
                     << distort.m_distortionD.size() << std::endl;
-                return ret;
+                return false;
             }
         } else if (distort.m_type ==
                  DistortionParameters::mono_point_samples) {
-          // Nothing special to do, our interpolator is created below
+          // Nothing special to check, the interpolators check the samples
         } else if (distort.m_type ==
                  DistortionParameters::rgb_point_samples) {
-          // Nothing special to do, our interpolator is created below
+          // Nothing special to check, the interpolators check the samples
         }
         else {
-            std::cerr << "ComputeDistortionMesh: Unrecognized "
+            std::cerr << caller << ": Unrecognized "
                 << "distortion parameter type" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    DistortionMesh ComputeDistortionMesh(size_t eye, DistortionMeshType type, DistortionParameters const& distort, float overfillFactor) {
+        return ComputeDistortionMesh(eye, type, distort, overfillFactor, 1);
+    }
+
+    DistortionMesh ComputeDistortionMesh(size_t eye, DistortionMeshType type, DistortionParameters const& distort, float overfillFactor,
+                                         unsigned numThreads) {
+        DistortionMesh ret;
+        numThreads = resolveThreadCount(numThreads);
+
+        // Check the validity of the parameters, based on the ones we're
+        // using.
+        if (!CheckDistortionParameters(distort, "ComputeDistortionMesh")) {
             return ret;
         }
 
@@ -122,25 +888,46 @@ namespace renderkit {
               auto const numVertices = numVertsPerSide*numVertsPerSide;
               ret.vertices.reserve(numVertices);
 
-              // Generate a grid of vertices with distorted texture coordinates
-              for (int x = 0; x < numVertsPerSide; x++) {
-                  float xPos = -1 + x * quadSide;
-                  float xTex = x * quadTexSide;
-
-                  for (int y = 0; y < numVertsPerSide; y++) {
-                      float yPos = -1 + y * quadSide;
-                      float yTex = y * quadTexSide;
-
-                      Float2 pos = { xPos, yPos };
-                      Float2 tex = { xTex, yTex };
-
-                      ret.vertices.emplace_back(pos,
-                          DistortionCorrectTextureCoordinate(eye, tex, distort, 0, overfillFactor, interpolators),
-                          DistortionCorrectTextureCoordinate(eye, tex, distort, 1, overfillFactor, interpolators),
-                          DistortionCorrectTextureCoordinate(eye, tex, distort, 2, overfillFactor, interpolators));
+              // Generate a grid of vertices with distorted texture
+              // coordinates.  When we have more than one thread, split the
+              // columns into one contiguous tile per thread and append the
+              // tiles in order, so the result matches the serial one.
+              unsigned const numTiles = std::min(numThreads,
+                  static_cast<unsigned>(numVertsPerSide));
+              if (numTiles <= 1) {
+                  ComputeSquareMeshColumns(0, numVertsPerSide,
+                      numVertsPerSide, quadSide, quadTexSide, eye, distort,
+                      overfillFactor, interpolators, ret.vertices);
+              } else {
+                  std::vector< std::vector<DistortionMeshVertex> >
+                      tiles(numTiles);
+                  std::vector<std::thread> workers;
+                  for (unsigned t = 0; t < numTiles; t++) {
+                      int xBegin = static_cast<int>(
+                          static_cast<long>(numVertsPerSide) * t / numTiles);
+                      int xEnd = static_cast<int>(
+                          static_cast<long>(numVertsPerSide) * (t + 1) /
+                          numTiles);
+                      workers.emplace_back([&, t, xBegin, xEnd] {
+                          ComputeSquareMeshColumns(xBegin, xEnd,
+                              numVertsPerSide, quadSide, quadTexSide, eye,
+                              distort, overfillFactor, interpolators,
+                              tiles[t]);
+                      });
+                  }
+                  for (auto& worker : workers) {
+                      worker.join();
+                  }
+                  for (auto const& tile : tiles) {
+                      ret.vertices.insert(ret.vertices.end(), tile.begin(),
+                                          tile.end());
                   }
               }
 
+              // The interpolators are not needed to build the indices, so
+              // free their copies of the point samples now.
+              interpolators.clear();
+
               // Generate a pair of triangles for each quad, as a trignale strip
 
               // total of (quadsPerSide + 1) * quadsPerSide * 2 vertices added: reserve
@@ -172,13 +959,19 @@ namespace renderkit {
                   }
               }
           } break;
+        case ADAPTIVE: {
+              // Refine no further than the grid the SQUARE mesh would use
+              // for the same number of triangles, and never so far that the
+              // indices could overflow 16 bits.
+              int quadsPerSide =
+                  static_cast<int>(std::sqrt(distort.m_desiredTriangles / 2));
+              quadsPerSide = std::min(quadsPerSide, 160);
+              AdaptiveMeshBuilder(eye, distort, overfillFactor,
+                                  interpolators, quadsPerSide).build(ret);
+          } break;
         case RADIAL: {
-              std::cerr
-                  << "ComputeDistortionMesh: Radial mesh type "
-                  << "not yet implemented" << std::endl;
-
-              // @todo Scale the aspect ratio of the rings around the center of
-              // projection so that they will be round in the visible display.
+              RadialMeshBuilder(eye, distort, overfillFactor, interpolators)
+                  .build(ret);
           } break;
         default:
               std::cerr << "ComputeDistortionMesh: Unsupported "
@@ -189,6 +982,165 @@ namespace renderkit {
         return ret;
     }
 
+    /// Fetch a mesh from the cache, if there is one, or compute it and
+    /// add it to the cache.
+    static DistortionMesh CachedDistortionMesh(size_t eye,
+        DistortionMeshType type, DistortionParameters const& distort,
+        float overfillFactor, unsigned numThreads, DistortionMeshCache* cache) {
+        DistortionMesh ret;
+        if (cache && cache->load(eye, type, distort, overfillFactor, ret)) {
+            return ret;
+        }
+        auto start = std::chrono::steady_clock::now();
+        ret = ComputeDistortionMesh(eye, type, distort, overfillFactor,
+                                    numThreads);
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        if (cache && !ret.vertices.empty()) {
+            cache->store(eye, type, distort, overfillFactor, ret,
+                         elapsed.count());
+        }
+        return ret;
+    }
+
+    std::vector<DistortionMesh> ComputeDistortionMeshes(
+        DistortionMeshType type,
+        std::vector<DistortionParameters> const& distort,
+        float overfillFactor, unsigned numThreads,
+        DistortionMeshCache* cache) {
+        std::vector<DistortionMesh> ret(distort.size());
+        numThreads = resolveThreadCount(numThreads);
+        if (numThreads <= 1 || distort.size() <= 1) {
+            for (size_t eye = 0; eye < distort.size(); eye++) {
+                ret[eye] = CachedDistortionMesh(eye, type, distort[eye],
+                    overfillFactor, numThreads, cache);
+            }
+            return ret;
+        }
+
+        // Give each eye its own thread and share out the rest among the
+        // eyes for splitting their vertex grids.
+        unsigned const perEye = std::max(1u,
+            numThreads / static_cast<unsigned>(distort.size()));
+        std::vector<std::thread> workers;
+        for (size_t eye = 0; eye < distort.size(); eye++) {
+            workers.emplace_back([&, eye] {
+                ret[eye] = CachedDistortionMesh(eye, type, distort[eye],
+                    overfillFactor, perEye, cache);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return ret;
+    }
+
+    /// Fill in rows [yBegin, yEnd) of a lookup table.
+    static void ComputeLookupTableRows(size_t yBegin, size_t yEnd,
+        size_t eye, DistortionParameters const& distort,
+        float overfillFactor,
+        std::vector< std::unique_ptr<UnstructuredMeshInterpolator> > const&
+            interpolators,
+        DistortionLookupTable& table) {
+        size_t const w = table.width;
+        std::vector<float> texX(w), texY(w);
+        std::vector<float> outX[3], outY[3];
+        float* outXPtrs[3];
+        float* outYPtrs[3];
+        for (size_t c = 0; c < 3; c++) {
+            outX[c].resize(w);
+            outY[c].resize(w);
+            outXPtrs[c] = outX[c].data();
+            outYPtrs[c] = outY[c].data();
+        }
+        for (size_t x = 0; x < w; x++) {
+            texX[x] = static_cast<float>(x) / (w - 1);
+        }
+
+        // Polynomial distortion is evaluated a row at a time using the
+        // batch interface.
+        bool const polynomial = distort.m_type ==
+            DistortionParameters::rgb_symmetric_polynomials;
+        RGBSymmetricPolynomialBatch batch(distort, overfillFactor);
+        for (size_t y = yBegin; y < yEnd; y++) {
+            float const yTex = static_cast<float>(y) / (table.height - 1);
+            if (polynomial) {
+                std::fill(texY.begin(), texY.end(), yTex);
+                batch.correctRGB(w, texX.data(), texY.data(), outXPtrs,
+                                 outYPtrs);
+            } else {
+                for (size_t x = 0; x < w; x++) {
+                    CorrectedSample s = CorrectRGB(eye, texX[x], yTex,
+                        distort, overfillFactor, interpolators);
+                    for (size_t c = 0; c < 3; c++) {
+                        outX[c][x] = s.tex[c][0];
+                        outY[c][x] = s.tex[c][1];
+                    }
+                }
+            }
+            float* rg = &table.redGreen[4 * y * w];
+            float* b = &table.blue[2 * y * w];
+            for (size_t x = 0; x < w; x++) {
+                rg[4 * x + 0] = outX[0][x];
+                rg[4 * x + 1] = outY[0][x];
+                rg[4 * x + 2] = outX[1][x];
+                rg[4 * x + 3] = outY[1][x];
+                b[2 * x + 0] = outX[2][x];
+                b[2 * x + 1] = outY[2][x];
+            }
+        }
+    }
+
+    DistortionLookupTable ComputeDistortionLookupTable(size_t eye,
+        DistortionParameters const& distort, float overfillFactor,
+        size_t width, size_t height, unsigned numThreads) {
+        DistortionLookupTable ret;
+        if (width < 2 || height < 2) {
+            std::cerr << "ComputeDistortionLookupTable: Table too small: "
+                << width << "x" << height << std::endl;
+            return ret;
+        }
+        if (!CheckDistortionParameters(distort,
+                                       "ComputeDistortionLookupTable")) {
+            return ret;
+        }
+        std::vector< std::unique_ptr<UnstructuredMeshInterpolator> >
+          interpolators;
+        if (!makeUnstructuredMeshInterpolators(distort, eye,
+            interpolators)) {
+          std::cerr << "ComputeDistortionLookupTable: Could not "
+            << "create mesh interpolators" << std::endl;
+          return ret;
+        }
+
+        ret.width = width;
+        ret.height = height;
+        ret.redGreen.resize(4 * width * height);
+        ret.blue.resize(2 * width * height);
+
+        // Split the rows into one contiguous band per thread.
+        size_t const numBands = std::min<size_t>(
+            resolveThreadCount(numThreads), height);
+        if (numBands <= 1) {
+            ComputeLookupTableRows(0, height, eye, distort, overfillFactor,
+                                   interpolators, ret);
+            return ret;
+        }
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < numBands; t++) {
+            size_t const yBegin = height * t / numBands;
+            size_t const yEnd = height * (t + 1) / numBands;
+            workers.emplace_back([&, yBegin, yEnd] {
+                ComputeLookupTableRows(yBegin, yEnd, eye, distort,
+                                       overfillFactor, interpolators, ret);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return ret;
+    }
+
 } // end namespace renderkit
 } // end namespace osvr
 
@@ -35,10 +35,14 @@
 
 // Standard includes
 #include <cstddef>      // for size_t
+#include <vector>
 
 namespace osvr {
 namespace renderkit {
 
+    // forward declaration to avoid dragging in dependencies.
+    class DistortionMeshCache;
+
     /// @brief Constructs a mesh to correct lens distortions
     ///
     /// Constructs a set of vertices in the range (-1,-1) to (1,1),
@@ -60,6 +64,19 @@ namespace renderkit {
     /// There are sets of 3 vertices produced, suitable for sending
     /// as a set of triangles to the rendering system.
     ///
+    /// SQUARE meshes are a uniform grid drawn as a triangle strip.
+    /// ADAPTIVE meshes are drawn as a triangle list and only use small
+    /// triangles where the distortion is strongly curved, so that
+    /// interpolating across each triangle stays within
+    /// distort.m_maxMeshErrorPixels of the true distortion; they are never
+    /// finer than the SQUARE mesh for the same m_desiredTriangles.
+    /// RADIAL meshes are also drawn as a triangle list; they are rings
+    /// around distort.m_distortionCOP, scaled so that the distortion is
+    /// round, spaced more closely where the distortion bends more and with
+    /// more spokes in the rings that need them, to the same error and
+    /// within the same triangle budget.  The mesh's topology field tells
+    /// which way to draw it.
+    ///
     ///  @todo Consider switching to an indexed-based mesh.
     ///
     ///  @param eye which eye
@@ -69,9 +86,72 @@ namespace renderkit {
     ///
     ///  @return Vector of triangles (sets of 3 vertices), empty on failure.
     DistortionMesh OSVR_RENDERMANAGER_EXPORT ComputeDistortionMesh(
-      size_t eye, DistortionMeshType type, DistortionParameters distort,
+      size_t eye, DistortionMeshType type, DistortionParameters const& distort,
       float overfillFactor);
 
+    /// @brief Constructs a mesh to correct lens distortions, splitting the
+    /// work across worker threads.
+    ///
+    /// The vertex grid is split into tiles of adjacent columns, each of
+    /// which is distortion-corrected on its own thread; the resulting mesh
+    /// is identical to the one produced by the serial version above.
+    /// ADAPTIVE and RADIAL meshes are always computed on the calling thread.
+    ///
+    ///  @param eye which eye
+    ///  @param type type of mesh to produce
+    ///  @param distort distortion parameters
+    ///  @param overfillFactor overfill factor
+    ///  @param numThreads how many threads to use: 1 computes the mesh on
+    ///         the calling thread and 0 uses one per hardware thread.
+    ///
+    ///  @return Vector of triangles (sets of 3 vertices), empty on failure.
+    DistortionMesh OSVR_RENDERMANAGER_EXPORT ComputeDistortionMesh(
+      size_t eye, DistortionMeshType type, DistortionParameters const& distort,
+      float overfillFactor, unsigned numThreads);
+
+    /// @brief Constructs the meshes for a set of eyes concurrently.
+    ///
+    /// Each eye is computed on its own thread, with the requested number
+    /// of threads shared among the eyes to split their vertex grids.
+    ///
+    ///  @param type type of mesh to produce
+    ///  @param distort distortion parameters, one set per eye
+    ///  @param overfillFactor overfill factor
+    ///  @param numThreads how many threads to use in total: 1 computes the
+    ///         meshes serially on the calling thread and 0 uses one per
+    ///         hardware thread.
+    ///  @param cache Optional on-disk cache.  Meshes found there are not
+    ///         computed, and computed meshes are added to it.
+    ///
+    ///  @return One mesh per entry in distort, each empty on failure.
+    std::vector<DistortionMesh> OSVR_RENDERMANAGER_EXPORT
+    ComputeDistortionMeshes(DistortionMeshType type,
+      std::vector<DistortionParameters> const& distort,
+      float overfillFactor, unsigned numThreads,
+      DistortionMeshCache* cache = nullptr);
+
+    /// @brief Bakes the distortion for an eye into a lookup table.
+    ///
+    /// Computes the same distortion-corrected texture coordinates that
+    /// the mesh vertices carry, but on a width x height grid of points
+    /// spanning the texture from edge to edge, so that a renderer can
+    /// look them up per pixel instead of interpolating them across
+    /// triangles.  Rows are split across worker threads.
+    ///
+    ///  @param eye which eye
+    ///  @param distort distortion parameters
+    ///  @param overfillFactor overfill factor
+    ///  @param width number of texels across the table, at least 2
+    ///  @param height number of texels down the table, at least 2
+    ///  @param numThreads how many threads to use: 1 computes the table on
+    ///         the calling thread and 0 uses one per hardware thread.
+    ///
+    ///  @return The table, empty (zero size) on failure.
+    DistortionLookupTable OSVR_RENDERMANAGER_EXPORT
+    ComputeDistortionLookupTable(size_t eye,
+      DistortionParameters const& distort, float overfillFactor,
+      size_t width, size_t height, unsigned numThreads);
+
 } // namespace osvr
 } // namespace renderkit
 
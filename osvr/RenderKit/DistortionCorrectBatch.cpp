@@ -0,0 +1,168 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "DistortionCorrectBatch.h"
+
+// Library/third-party includes
+#include <Eigen/Core>
+
+// Standard includes
+// - none
+
+namespace osvr {
+namespace renderkit {
+
+    using Eigen::ArrayXf;
+    using Eigen::Map;
+
+    /// The color-independent part of the computation: the location of each
+    /// point relative to the center of projection in D space, split into
+    /// its distance and direction.  Eigen evaluates these array expressions
+    /// using the SIMD instructions available to the compiler.
+    struct PolynomialBatchPoints {
+        PolynomialBatchPoints(size_t count, const float* inX,
+                              const float* inY, float overfillFactor,
+                              const float D[2], const float COPinD[2]) {
+            const Eigen::DenseIndex n = static_cast<Eigen::DenseIndex>(count);
+            Map<const ArrayXf> x(inX, n);
+            Map<const ArrayXf> y(inY, n);
+
+            // Convert from coordinates in the overfilled texture to
+            // coordinates that cover (0,0) to (1,1) on the screen.
+            xN = (x - 0.5f) * overfillFactor + 0.5f;
+            yN = (y - 0.5f) * overfillFactor + 0.5f;
+
+            // Distance and direction from the COP in D space.  Points at
+            // the center have no direction and are not distorted.
+            ArrayXf dx = xN * D[0] - COPinD[0];
+            ArrayXf dy = yN * D[1] - COPinD[1];
+            ArrayXf rMag2 = dx.square() + dy.square();
+            atCenter = rMag2 == 0;
+            rMag = rMag2.sqrt();
+            ArrayXf safeMag = atCenter.select(ArrayXf::Ones(n), rMag);
+            xDir = dx / safeMag;
+            yDir = dy / safeMag;
+        }
+
+        ArrayXf xN, yN;
+        ArrayXf rMag;
+        ArrayXf xDir, yDir;
+        Eigen::Array<bool, Eigen::Dynamic, 1> atCenter;
+    };
+
+    /// Apply one color's polynomial to the points and convert back from D
+    /// space into the overfilled texture space.
+    static void correctColor(PolynomialBatchPoints const& p,
+                             std::vector<float> const& params,
+                             float overfillFactor, const float D[2],
+                             const float COPinD[2], float* outX,
+                             float* outY) {
+        const Eigen::DenseIndex n = p.rMag.size();
+
+        // The distance scaling factor needs to be applied as many times
+        // as the degree of the polynomial we are using.  For the constant
+        // term, the factor is 1.
+        ArrayXf rFactor = ArrayXf::Ones(n);
+        ArrayXf rNew = ArrayXf::Constant(n, params[0]);
+        for (size_t i = 1; i < params.size(); i++) {
+            rFactor *= p.rMag;
+            rNew += params[i] * rFactor;
+        }
+
+        ArrayXf xNNew = (COPinD[0] + rNew * p.xDir) / D[0];
+        ArrayXf yNNew = (COPinD[1] + rNew * p.yDir) / D[1];
+        xNNew = p.atCenter.select(p.xN, xNNew);
+        yNNew = p.atCenter.select(p.yN, yNNew);
+
+        // Convert from unit (normalized) space back into overfill space.
+        Map<ArrayXf>(outX, n) = (xNNew - 0.5f) / overfillFactor + 0.5f;
+        Map<ArrayXf>(outY, n) = (yNNew - 0.5f) / overfillFactor + 0.5f;
+    }
+
+    RGBSymmetricPolynomialBatch::RGBSymmetricPolynomialBatch(
+        const DistortionParameters& distort, float overfillFactor)
+        : m_overfillFactor(overfillFactor) {
+        m_D[0] = m_D[1] = 1;
+        m_COPinD[0] = m_COPinD[1] = 0.5f;
+        if (distort.m_type != DistortionParameters::rgb_symmetric_polynomials ||
+            distort.m_distortionPolynomialRed.size() < 2 ||
+            distort.m_distortionPolynomialGreen.size() < 2 ||
+            distort.m_distortionPolynomialBlue.size() < 2 ||
+            distort.m_distortionCOP.size() != 2 ||
+            distort.m_distortionD.size() != 2 ||
+            distort.m_distortionD[0] <= 0 || distort.m_distortionD[1] <= 0) {
+            return;
+        }
+        for (size_t i = 0; i < 2; i++) {
+            m_D[i] = distort.m_distortionD[i];
+            m_COPinD[i] = distort.m_distortionD[i] * distort.m_distortionCOP[i];
+        }
+        m_coefficients[0] = distort.m_distortionPolynomialRed;
+        m_coefficients[1] = distort.m_distortionPolynomialGreen;
+        m_coefficients[2] = distort.m_distortionPolynomialBlue;
+        m_valid = true;
+    }
+
+    void RGBSymmetricPolynomialBatch::correct(size_t count, const float* inX,
+                                              const float* inY, size_t color,
+                                              float* outX, float* outY) const {
+        if (!m_valid || color > 2) {
+            const Eigen::DenseIndex n = static_cast<Eigen::DenseIndex>(count);
+            if (outX != inX) {
+                Map<ArrayXf>(outX, n) = Map<const ArrayXf>(inX, n);
+            }
+            if (outY != inY) {
+                Map<ArrayXf>(outY, n) = Map<const ArrayXf>(inY, n);
+            }
+            return;
+        }
+        PolynomialBatchPoints points(count, inX, inY, m_overfillFactor, m_D,
+                                     m_COPinD);
+        correctColor(points, m_coefficients[color], m_overfillFactor, m_D,
+                     m_COPinD, outX, outY);
+    }
+
+    void RGBSymmetricPolynomialBatch::correctRGB(size_t count,
+                                                 const float* inX,
+                                                 const float* inY,
+                                                 float* const outX[3],
+                                                 float* const outY[3]) const {
+        if (!m_valid) {
+            for (size_t color = 0; color < 3; color++) {
+                correct(count, inX, inY, color, outX[color], outY[color]);
+            }
+            return;
+        }
+        PolynomialBatchPoints points(count, inX, inY, m_overfillFactor, m_D,
+                                     m_COPinD);
+        for (size_t color = 0; color < 3; color++) {
+            correctColor(points, m_coefficients[color], m_overfillFactor, m_D,
+                         m_COPinD, outX[color], outY[color]);
+        }
+    }
+
+} // namespace renderkit
+} // namespace osvr
@@ -0,0 +1,106 @@
+/** @file
+    @brief Header
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_DistortionCorrectBatch_h_GUID_5C0E8B0A_3F6D_4C51_9D2B_7A4E1F6C2B93
+#define INCLUDED_DistortionCorrectBatch_h_GUID_5C0E8B0A_3F6D_4C51_9D2B_7A4E1F6C2B93
+
+// Internal Includes
+#include <osvr/RenderKit/Export.h>
+#include "DistortionParameters.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstddef>      // for size_t
+#include <vector>
+
+namespace osvr {
+namespace renderkit {
+
+    /// @brief Batch evaluation of rgb_symmetric_polynomials distortion.
+    ///
+    /// Unpacks the polynomial coefficients, center of projection and
+    /// distance scale from a DistortionParameters once, then distortion
+    /// corrects whole arrays of texture coordinates at a time.  The
+    /// coordinates are passed as separate X and Y arrays so that the
+    /// evaluation is vectorized (SSE/AVX on x86, NEON on ARM, depending
+    /// on the instruction sets enabled for the compiler).
+    ///
+    /// The results match those of DistortionCorrectTextureCoordinate() to
+    /// within floating-point rounding.
+    class RGBSymmetricPolynomialBatch {
+      public:
+        /// Constructor, unpacking the parameters to be used.
+        /// @param distort Distortion parameters; they must be of type
+        ///        rgb_symmetric_polynomials for the batch to be valid.
+        /// @param overfillFactor Overfill factor of the texture that the
+        ///        coordinates are specified in.
+        OSVR_RENDERMANAGER_EXPORT RGBSymmetricPolynomialBatch(
+            const DistortionParameters& distort, float overfillFactor = 1.0f);
+
+        /// Did the parameters passed to the constructor describe a valid
+        /// polynomial distortion?  If not, correction leaves the
+        /// coordinates unchanged.
+        bool valid() const { return m_valid; }
+
+        /// Distortion-correct an array of texture coordinates for a single
+        /// color.  The output arrays may be the same as the input arrays.
+        /// @param count Number of coordinates in each array
+        /// @param inX Texture X coordinates to correct
+        /// @param inY Texture Y coordinates to correct
+        /// @param color red=0, green=1, blue=2
+        /// @param [out] outX Corrected X coordinates
+        /// @param [out] outY Corrected Y coordinates
+        void OSVR_RENDERMANAGER_EXPORT correct(size_t count, const float* inX,
+                                               const float* inY, size_t color,
+                                               float* outX,
+                                               float* outY) const;
+
+        /// Distortion-correct an array of texture coordinates for all three
+        /// colors, sharing the work that does not depend on the color.
+        /// @param count Number of coordinates in each array
+        /// @param inX Texture X coordinates to correct
+        /// @param inY Texture Y coordinates to correct
+        /// @param [out] outX Corrected X coordinates for red, green, blue
+        /// @param [out] outY Corrected Y coordinates for red, green, blue
+        void OSVR_RENDERMANAGER_EXPORT correctRGB(size_t count,
+                                                  const float* inX,
+                                                  const float* inY,
+                                                  float* const outX[3],
+                                                  float* const outY[3]) const;
+
+      private:
+        bool m_valid = false;
+        float m_overfillFactor = 1.0f;
+        float m_D[2];              ///< Distance scale
+        float m_COPinD[2];         ///< Center of projection in D space
+        std::vector<float> m_coefficients[3]; ///< Per-color polynomials
+    };
+
+} // namespace renderkit
+} // namespace osvr
+
+#endif // INCLUDED_DistortionCorrectBatch_h_GUID_5C0E8B0A_3F6D_4C51_9D2B_7A4E1F6C2B93
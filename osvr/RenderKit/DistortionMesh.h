@@ -34,13 +34,21 @@
 
 // Standard includes
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 
 namespace osvr {
 namespace renderkit {
 
     /// Describes the type of mesh to be constructed for distortion correction.
-    typedef enum { SQUARE, RADIAL } DistortionMeshType;
+    /// SQUARE is a uniform grid; RADIAL is a set of rings around the center
+    /// of projection; ADAPTIVE is a quadtree.  RADIAL and ADAPTIVE are only
+    /// refined where the distortion is too curved to be interpolated
+    /// linearly.
+    typedef enum { SQUARE, RADIAL, ADAPTIVE } DistortionMeshType;
+
+    /// Describes how the indices of a distortion mesh form triangles.
+    typedef enum { TRIANGLE_STRIP, TRIANGLE_LIST } DistortionMeshTopology;
 
     /// Describes a vertex 2D position plus three 2D texture coordinates.
     class DistortionMeshVertex {
@@ -66,6 +74,22 @@ namespace renderkit {
     public:
         std::vector<DistortionMeshVertex> vertices;
         std::vector<uint16_t> indices;
+        DistortionMeshTopology topology = TRIANGLE_STRIP;
+    };
+
+    /// Holds the distortion-corrected texture coordinates for every texel
+    /// of a lookup texture that covers the whole eye, as an alternative to
+    /// a mesh.  Texel (x,y) holds the coordinates for the texture-space
+    /// point (x/(width-1), y/(height-1)), so the outermost texels lie on
+    /// the edges of the eye; a texture coordinate t is looked up at
+    /// (t * (size-1) + 0.5) / size.  Rows run from the bottom (Y=0) up, as
+    /// OpenGL expects them.
+    class DistortionLookupTable {
+    public:
+        size_t width = 0;
+        size_t height = 0;
+        std::vector<float> redGreen; //< Red U,V then green U,V per texel
+        std::vector<float> blue;     //< Blue U,V per texel
     };
 
 } // namespace renderkit
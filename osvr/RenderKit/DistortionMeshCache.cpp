@@ -0,0 +1,451 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "DistortionMeshCache.h"
+#include "Fnv1aHash.h"
+#include "MappedFile.h"
+
+// Library/third-party includes
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <sys/utime.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <utime.h>
+#endif
+
+// Standard includes
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace osvr {
+namespace renderkit {
+
+    /// Bump this whenever the file layout or the mesh computation changes
+    /// in a way that makes previously-cached meshes wrong.
+    static const uint32_t CACHE_FORMAT_VERSION = 2;
+
+    static const char CACHE_MAGIC[8] = {'O', 'S', 'V', 'R', 'D', 'M', 'S', 'H'};
+    static const char CACHE_FILE_PREFIX[] = "osvr_distortion_mesh_";
+    static const char CACHE_FILE_SUFFIX[] = ".bin";
+
+    /// Fixed-size header at the start of each cache file, followed by the
+    /// vertices and then the indices.
+    struct CacheFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t vertexSize;
+        uint32_t topology;
+        uint32_t reserved;
+        uint64_t keyHash;
+        uint64_t keyCheck;
+        uint64_t keySize;
+        uint64_t vertexCount;
+        uint64_t indexCount;
+        double computeSeconds;
+    };
+
+    /// Incremental FNV-1a hash over everything that affects a mesh.  Two
+    /// hashes with different starting values are kept, one to name the
+    /// file and one to check that the file's contents match the key.
+    class MeshKeyHasher {
+      public:
+        void add(const void* data, size_t size) {
+            m_hash = fnv1aHash(data, size, m_hash);
+            m_check = fnv1aHash(data, size, m_check);
+            m_size += size;
+        }
+        template <typename T> void addValue(T value) {
+            add(&value, sizeof(value));
+        }
+        template <typename T> void addVector(std::vector<T> const& v) {
+            addValue(static_cast<uint64_t>(v.size()));
+            if (!v.empty()) {
+                add(v.data(), sizeof(T) * v.size());
+            }
+        }
+        void addMesh(MonoPointDistortionMeshDescriptionPtr const& mesh) {
+            if (!mesh) {
+                addValue(static_cast<uint64_t>(0));
+                return;
+            }
+            addValue(static_cast<uint64_t>(mesh->size()));
+            for (auto const& sample : *mesh) {
+                add(sample.data(), sizeof(sample));
+            }
+        }
+
+        uint64_t m_hash = FNV1A_OFFSET_BASIS;
+        uint64_t m_check = 0x84222325cbf29ce4ULL;
+        uint64_t m_size = 0;
+    };
+
+    static MeshKeyHasher hashKey(size_t eye, DistortionMeshType type,
+                                 DistortionParameters const& distort,
+                                 float overfillFactor) {
+        MeshKeyHasher h;
+        h.addValue(CACHE_FORMAT_VERSION);
+        h.addValue(static_cast<uint64_t>(eye));
+        h.addValue(static_cast<int32_t>(type));
+        h.addValue(overfillFactor);
+        h.addValue(static_cast<int32_t>(distort.m_type));
+        h.addValue(distort.m_desiredTriangles);
+        h.addValue(distort.m_maxMeshErrorPixels);
+        h.addValue(distort.m_eyeWidthPixels);
+        h.addValue(distort.m_eyeHeightPixels);
+        h.addVector(distort.m_distortionPolynomialRed);
+        h.addVector(distort.m_distortionPolynomialGreen);
+        h.addVector(distort.m_distortionPolynomialBlue);
+        h.addVector(distort.m_distortionCOP);
+        h.addVector(distort.m_distortionD);
+        h.addValue(static_cast<uint64_t>(distort.m_monoPointSamples.size()));
+        for (auto const& mesh : distort.m_monoPointSamples) {
+            h.addMesh(mesh);
+        }
+        for (auto const& color : distort.m_rgbPointSamples) {
+            h.addValue(static_cast<uint64_t>(color.size()));
+            for (auto const& mesh : color) {
+                h.addMesh(mesh);
+            }
+        }
+        return h;
+    }
+
+    static std::string joinPath(std::string const& directory,
+                                std::string const& name) {
+        std::string ret = directory;
+        if (!ret.empty() && ret.back() != '/' && ret.back() != '\\') {
+            ret += '/';
+        }
+        return ret + name;
+    }
+
+    static std::string cacheFileName(std::string const& directory,
+                                     uint64_t hash) {
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx",
+                      static_cast<unsigned long long>(hash));
+        return joinPath(directory,
+                        std::string(CACHE_FILE_PREFIX) + hex + CACHE_FILE_SUFFIX);
+    }
+
+    /// A cache file in the directory, as seen when enforcing the size cap.
+    struct CacheFileInfo {
+        std::string path;
+        uint64_t size;
+        int64_t lastUsed;
+    };
+
+    static bool isCacheFileName(std::string const& name) {
+        size_t const prefix = sizeof(CACHE_FILE_PREFIX) - 1;
+        size_t const suffix = sizeof(CACHE_FILE_SUFFIX) - 1;
+        return name.size() > prefix + suffix &&
+               name.compare(0, prefix, CACHE_FILE_PREFIX) == 0 &&
+               name.compare(name.size() - suffix, suffix, CACHE_FILE_SUFFIX) ==
+                   0;
+    }
+
+    static std::vector<CacheFileInfo> listCacheFiles(
+        std::string const& directory) {
+        std::vector<CacheFileInfo> ret;
+        std::string dir = directory.empty() ? "." : directory;
+#ifdef _WIN32
+        WIN32_FIND_DATAA data;
+        HANDLE find = FindFirstFileA(joinPath(dir, "*").c_str(), &data);
+        if (find == INVALID_HANDLE_VALUE) {
+            return ret;
+        }
+        do {
+            std::string name = data.cFileName;
+            if (isCacheFileName(name)) {
+                CacheFileInfo info;
+                info.path = joinPath(directory, name);
+                info.size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) |
+                            data.nFileSizeLow;
+                info.lastUsed =
+                    (static_cast<int64_t>(data.ftLastWriteTime.dwHighDateTime)
+                     << 32) |
+                    data.ftLastWriteTime.dwLowDateTime;
+                ret.push_back(info);
+            }
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
+#else
+        DIR* d = opendir(dir.c_str());
+        if (!d) {
+            return ret;
+        }
+        while (struct dirent* entry = readdir(d)) {
+            std::string name = entry->d_name;
+            if (!isCacheFileName(name)) {
+                continue;
+            }
+            CacheFileInfo info;
+            info.path = joinPath(directory, name);
+            struct stat st;
+            if (stat(info.path.c_str(), &st) != 0) {
+                continue;
+            }
+            info.size = static_cast<uint64_t>(st.st_size);
+            info.lastUsed = static_cast<int64_t>(st.st_mtime);
+            ret.push_back(info);
+        }
+        closedir(d);
+#endif
+        return ret;
+    }
+
+    /// Mark a file as recently used so the size cap evicts it last.
+    static void touchFile(std::string const& path) {
+#ifdef _WIN32
+        _utime(path.c_str(), nullptr);
+#else
+        utime(path.c_str(), nullptr);
+#endif
+    }
+
+    /// Read the header of a mapped cache file into @p header, and check
+    /// that the file was written by this version, for this key, and is
+    /// complete.
+    static bool readValidHeader(MappedFile const& file,
+                                MeshKeyHasher const& key,
+                                CacheFileHeader& header) {
+        if (!file.data() || file.size() < sizeof(header)) {
+            return false;
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        uint64_t const expected =
+            sizeof(header) +
+            header.vertexCount * sizeof(DistortionMeshVertex) +
+            header.indexCount * sizeof(uint16_t);
+        return std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) ==
+                   0 &&
+               header.version == CACHE_FORMAT_VERSION &&
+               header.vertexSize == sizeof(DistortionMeshVertex) &&
+               header.topology <= TRIANGLE_LIST &&
+               header.keyHash == key.m_hash &&
+               header.keyCheck == key.m_check &&
+               header.keySize == key.m_size && header.vertexCount > 0 &&
+               file.size() == expected;
+    }
+
+    DistortionMeshCache::DistortionMeshCache(std::string const& directory,
+                                             uint64_t maxBytes)
+        : m_directory(directory), m_maxBytes(maxBytes) {}
+
+    bool DistortionMeshCache::load(size_t eye, DistortionMeshType type,
+                                   DistortionParameters const& distort,
+                                   float overfillFactor, DistortionMesh& mesh) {
+        auto start = std::chrono::steady_clock::now();
+        MeshKeyHasher key = hashKey(eye, type, distort, overfillFactor);
+        std::string path = cacheFileName(m_directory, key.m_hash);
+
+        bool valid = false;
+        double computeSeconds = 0;
+        {
+            MappedFile file(path);
+            if (!file.data()) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stats.misses++;
+                return false;
+            }
+
+            CacheFileHeader header;
+            valid = readValidHeader(file, key, header);
+            if (valid) {
+                const char* vertices = file.data() + sizeof(header);
+                const char* indices =
+                    vertices + header.vertexCount * sizeof(DistortionMeshVertex);
+                mesh.vertices.clear();
+                mesh.vertices.reserve(static_cast<size_t>(header.vertexCount));
+                for (uint64_t i = 0; i < header.vertexCount; i++) {
+                    float v[8];
+                    std::memcpy(v, vertices + i * sizeof(DistortionMeshVertex),
+                                sizeof(v));
+                    mesh.vertices.emplace_back(Float2{v[0], v[1]},
+                                               Float2{v[2], v[3]},
+                                               Float2{v[4], v[5]},
+                                               Float2{v[6], v[7]});
+                }
+                mesh.indices.resize(static_cast<size_t>(header.indexCount));
+                if (!mesh.indices.empty()) {
+                    std::memcpy(mesh.indices.data(), indices,
+                                mesh.indices.size() * sizeof(uint16_t));
+                }
+                mesh.topology =
+                    static_cast<DistortionMeshTopology>(header.topology);
+                computeSeconds = header.computeSeconds;
+            }
+        }
+
+        if (!valid) {
+            // Out of date or damaged: remove it so it gets rewritten.  This
+            // is done holding the lock, and only if the file is still bad,
+            // so that we do not remove one that store() has just put in
+            // its place.
+            std::lock_guard<std::mutex> lock(m_mutex);
+            {
+                MappedFile file(path);
+                CacheFileHeader header;
+                valid = readValidHeader(file, key, header);
+            }
+            if (!valid) {
+                std::remove(path.c_str());
+            }
+            m_stats.misses++;
+            return false;
+        }
+        touchFile(path);
+
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.hits++;
+        m_stats.secondsSaved += computeSeconds - elapsed.count();
+        return true;
+    }
+
+    bool DistortionMeshCache::store(size_t eye, DistortionMeshType type,
+                                    DistortionParameters const& distort,
+                                    float overfillFactor,
+                                    DistortionMesh const& mesh,
+                                    double computeSeconds) {
+        static_assert(sizeof(DistortionMeshVertex) == 8 * sizeof(float),
+                      "DistortionMeshVertex must be eight packed floats");
+        if (mesh.vertices.empty()) {
+            return false;
+        }
+        MeshKeyHasher key = hashKey(eye, type, distort, overfillFactor);
+        std::string path = cacheFileName(m_directory, key.m_hash);
+
+        CacheFileHeader header;
+        std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        header.version = CACHE_FORMAT_VERSION;
+        header.vertexSize = sizeof(DistortionMeshVertex);
+        header.topology = static_cast<uint32_t>(mesh.topology);
+        header.reserved = 0;
+        header.keyHash = key.m_hash;
+        header.keyCheck = key.m_check;
+        header.keySize = key.m_size;
+        header.vertexCount = mesh.vertices.size();
+        header.indexCount = mesh.indices.size();
+        header.computeSeconds = computeSeconds;
+
+        uint64_t const fileSize =
+            sizeof(header) + mesh.vertices.size() * sizeof(DistortionMeshVertex) +
+            mesh.indices.size() * sizeof(uint16_t);
+        if (fileSize > m_maxBytes) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Write to a temporary file and rename it into place so that
+        // readers never see a partial file.
+        std::string tempPath = path + ".tmp";
+        {
+            std::ofstream out(tempPath.c_str(),
+                              std::ios::binary | std::ios::trunc);
+            if (!out) {
+                std::cerr << "DistortionMeshCache::store: Could not open "
+                          << tempPath << " for writing" << std::endl;
+                return false;
+            }
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(mesh.vertices.data()),
+                      mesh.vertices.size() * sizeof(DistortionMeshVertex));
+            if (!mesh.indices.empty()) {
+                out.write(reinterpret_cast<const char*>(mesh.indices.data()),
+                          mesh.indices.size() * sizeof(uint16_t));
+            }
+            if (!out) {
+                std::cerr << "DistortionMeshCache::store: Could not write "
+                          << tempPath << std::endl;
+                out.close();
+                std::remove(tempPath.c_str());
+                return false;
+            }
+        }
+        // POSIX rename replaces an existing file atomically, so other
+        // processes sharing the directory always see one version or the
+        // other.  Windows will not rename over an existing file, so only
+        // then remove the old one and try again.
+        if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+            std::remove(path.c_str());
+            if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+                std::remove(tempPath.c_str());
+                return false;
+            }
+        }
+        m_stats.stores++;
+
+        // Enforce the size cap, removing the least-recently used files
+        // first.
+        std::vector<CacheFileInfo> files = listCacheFiles(m_directory);
+        uint64_t total = 0;
+        for (auto const& f : files) {
+            total += f.size;
+        }
+        if (total > m_maxBytes) {
+            std::sort(files.begin(), files.end(),
+                      [](CacheFileInfo const& a, CacheFileInfo const& b) {
+                          return a.lastUsed < b.lastUsed;
+                      });
+            for (auto const& f : files) {
+                if (total <= m_maxBytes) {
+                    break;
+                }
+                if (f.path == path || std::remove(f.path.c_str()) != 0) {
+                    continue;
+                }
+                total -= f.size;
+                m_stats.evictions++;
+            }
+        }
+        return true;
+    }
+
+    void DistortionMeshCache::invalidate() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto const& f : listCacheFiles(m_directory)) {
+            std::remove(f.path.c_str());
+        }
+    }
+
+    DistortionMeshCache::Statistics DistortionMeshCache::getStatistics() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+} // namespace renderkit
+} // namespace osvr
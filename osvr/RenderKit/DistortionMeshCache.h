@@ -0,0 +1,123 @@
+/** @file
+    @brief Header
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_DistortionMeshCache_h_GUID_2B7D41C6_9E0F_4A83_B5D1_6F3C8A2E9D47
+#define INCLUDED_DistortionMeshCache_h_GUID_2B7D41C6_9E0F_4A83_B5D1_6F3C8A2E9D47
+
+// Internal Includes
+#include <osvr/RenderKit/Export.h>
+#include "DistortionMesh.h"
+#include "DistortionParameters.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstddef>      // for size_t
+#include <cstdint>
+#include <string>
+#include <mutex>
+
+namespace osvr {
+namespace renderkit {
+
+    /// @brief Persistent on-disk cache of computed distortion meshes.
+    ///
+    /// Each mesh is stored in its own versioned binary file in the cache
+    /// directory, named by a hash of everything that goes into computing
+    /// it: the distortion parameters, the eye, the mesh type and the
+    /// overfill factor.  Files are memory-mapped when they are loaded.
+    /// Changing any of the inputs changes the key, so stale meshes are
+    /// never returned; files written by a different format version or
+    /// that do not match their key are treated as misses and removed.
+    /// When the files in the directory grow beyond the size cap, the
+    /// least-recently used ones are deleted.
+    ///
+    /// All methods are thread-safe.
+    class DistortionMeshCache {
+      public:
+        /// Counters describing how well the cache is working.
+        struct Statistics {
+            size_t hits = 0;      ///< Meshes loaded from the cache
+            size_t misses = 0;    ///< Lookups that found no usable mesh
+            size_t stores = 0;    ///< Meshes written to the cache
+            size_t evictions = 0; ///< Files removed to honor the size cap
+            /// Time spent computing the loaded meshes when they were
+            /// stored, less the time spent loading them.
+            double secondsSaved = 0;
+        };
+
+        /// Constructor.
+        /// @param directory Directory to hold the cache files; it must
+        ///        already exist.
+        /// @param maxBytes Size cap on the total of the cache files.
+        OSVR_RENDERMANAGER_EXPORT DistortionMeshCache(
+            std::string const& directory, uint64_t maxBytes);
+
+        /// Look for a cached mesh.
+        /// @param eye which eye
+        /// @param type type of mesh
+        /// @param distort distortion parameters
+        /// @param overfillFactor overfill factor
+        /// @param [out] mesh Filled in with the cached mesh on a hit.
+        /// @return True on a cache hit.
+        bool OSVR_RENDERMANAGER_EXPORT load(size_t eye, DistortionMeshType type,
+                                            DistortionParameters const& distort,
+                                            float overfillFactor,
+                                            DistortionMesh& mesh);
+
+        /// Write a computed mesh into the cache, evicting older ones if
+        /// needed to stay under the size cap.
+        /// @param eye which eye
+        /// @param type type of mesh
+        /// @param distort distortion parameters
+        /// @param overfillFactor overfill factor
+        /// @param mesh The mesh to store.
+        /// @param computeSeconds How long the mesh took to compute, used
+        ///        to report the time saved by later hits.
+        /// @return True on success.
+        bool OSVR_RENDERMANAGER_EXPORT store(size_t eye, DistortionMeshType type,
+                                             DistortionParameters const& distort,
+                                             float overfillFactor,
+                                             DistortionMesh const& mesh,
+                                             double computeSeconds);
+
+        /// Remove every mesh from the cache directory.
+        void OSVR_RENDERMANAGER_EXPORT invalidate();
+
+        /// Get a copy of the counters.
+        Statistics OSVR_RENDERMANAGER_EXPORT getStatistics() const;
+
+      private:
+        std::string m_directory;
+        uint64_t m_maxBytes;
+        mutable std::mutex m_mutex;
+        Statistics m_stats;
+    };
+
+} // namespace renderkit
+} // namespace osvr
+
+#endif // INCLUDED_DistortionMeshCache_h_GUID_2B7D41C6_9E0F_4A83_B5D1_6F3C8A2E9D47
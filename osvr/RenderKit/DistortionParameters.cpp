@@ -29,13 +29,34 @@
 // Library/third-party includes
 #include "osvr_display_configuration.h"
 
+// Standard includes
+#include <cmath>
+
 namespace osvr {
   namespace renderkit {
 
     OSVR_RENDERMANAGER_EXPORT DistortionParameters::DistortionParameters(
-      OSVRDisplayConfiguration& osvrParams,
+      const OSVRDisplayConfiguration& osvrParams,
       size_t eye) : DistortionParameters() {
       m_desiredTriangles = osvrParams.getDesiredDistortionTriangleCount(eye);
+      m_maxMeshErrorPixels = osvrParams.getDistortionMaxMeshErrorPixels(eye);
+      m_eyeWidthPixels = static_cast<float>(osvrParams.getDisplayWidth());
+      m_eyeHeightPixels = static_cast<float>(osvrParams.getDisplayHeight());
+      if (osvrParams.getDisplayMode() ==
+        OSVRDisplayConfiguration::HORIZONTAL_SIDE_BY_SIDE) {
+        m_eyeWidthPixels /= 2;
+      } else if (osvrParams.getDisplayMode() ==
+        OSVRDisplayConfiguration::VERTICAL_SIDE_BY_SIDE) {
+        m_eyeHeightPixels /= 2;
+      }
+      // The center of projection is also used to center RADIAL meshes,
+      // whatever the distortion type.
+      std::vector<float> COP = {
+        static_cast<float>(
+        osvrParams.getEyes()[eye].m_CenterProjX),
+        static_cast<float>(
+        osvrParams.getEyes()[eye].m_CenterProjY) };
+      m_distortionCOP = COP;
       if (osvrParams.getDistortionType(eye) ==
         OSVRDisplayConfiguration::RGB_SYMMETRIC_POLYNOMIALS) {
         m_type = rgb_symmetric_polynomials;
@@ -51,12 +72,6 @@ namespace osvr {
           osvrParams.getDistortionPolynomalGreen(eye);
         m_distortionPolynomialBlue =
           osvrParams.getDistortionPolynomalBlue(eye);
-        std::vector<float> COP = {
-          static_cast<float>(
-          osvrParams.getEyes()[eye].m_CenterProjX),
-          static_cast<float>(
-          osvrParams.getEyes()[eye].m_CenterProjY) };
-        m_distortionCOP = COP;
       }
       else if (osvrParams.getDistortionType(eye) ==
         OSVRDisplayConfiguration::MONO_POINT_SAMPLES) {
@@ -87,8 +102,36 @@ namespace osvr {
       m_distortionPolynomialGreen = { 0, 1 };
       m_distortionPolynomialBlue = { 0, 1 };
       m_desiredTriangles = 2;
+      m_maxMeshErrorPixels = 0.5f;
+      m_eyeWidthPixels = 0;
+      m_eyeHeightPixels = 0;
     };
 
+    bool DistortionParametersAreMirrored(DistortionParameters const& a,
+                                         DistortionParameters const& b) {
+      if (a.m_type != DistortionParameters::rgb_symmetric_polynomials ||
+          b.m_type != DistortionParameters::rgb_symmetric_polynomials ||
+          a.m_distortionCOP.size() != 2 || b.m_distortionCOP.size() != 2) {
+        return false;
+      }
+      // The centers of projection are read as text from the display
+      // configuration, so 1 - x for one eye may not round to exactly the
+      // same float as the other eye's x.
+      const float COP_TOLERANCE = 1e-6f;
+      return a.m_distortionPolynomialRed == b.m_distortionPolynomialRed &&
+             a.m_distortionPolynomialGreen == b.m_distortionPolynomialGreen &&
+             a.m_distortionPolynomialBlue == b.m_distortionPolynomialBlue &&
+             a.m_distortionD == b.m_distortionD &&
+             a.m_desiredTriangles == b.m_desiredTriangles &&
+             a.m_maxMeshErrorPixels == b.m_maxMeshErrorPixels &&
+             a.m_eyeWidthPixels == b.m_eyeWidthPixels &&
+             a.m_eyeHeightPixels == b.m_eyeHeightPixels &&
+             std::abs(a.m_distortionCOP[0] + b.m_distortionCOP[0] - 1) <=
+                 COP_TOLERANCE &&
+             std::abs(a.m_distortionCOP[1] - b.m_distortionCOP[1]) <=
+                 COP_TOLERANCE;
+    }
+
 } // namespace renderkit
 } // namespace osvr
 
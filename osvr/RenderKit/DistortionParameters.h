@@ -133,7 +133,7 @@ namespace renderkit {
         } Type;
 
         OSVR_RENDERMANAGER_EXPORT DistortionParameters(
-          OSVRDisplayConfiguration& osvrParams,
+          const OSVRDisplayConfiguration& osvrParams,
           size_t eye);
 
         OSVR_RENDERMANAGER_EXPORT DistortionParameters();
@@ -145,10 +145,22 @@ namespace renderkit {
 
         /// How many triangles would we like in the mesh?
         size_t m_desiredTriangles;
+
+        /// Largest texture-coordinate error, in pixels, that an ADAPTIVE
+        /// mesh may leave where it linearly interpolates the distortion.
+        float m_maxMeshErrorPixels;
+
+        /// Width and height in pixels of the part of the display covered
+        /// by this eye, used to measure mesh errors in pixels.  Zero when
+        /// not known.
+        float m_eyeWidthPixels;
+        float m_eyeHeightPixels;
         //@}
 
         /** \name Parameters valid for a mesh of type @c mono_point_samples */
         //@{
+        /// Shared with the display configuration and with copies of these
+        /// parameters; build a new description to change them.
         MonoPointDistortionMeshDescriptions m_monoPointSamples;
         //@}
 
@@ -168,7 +180,8 @@ namespace renderkit {
         /// Constant, linear, quadratic, ... for Blue
         std::vector<float> m_distortionPolynomialBlue;
 
-        /// (X,Y) location of center of projection in texture coords
+        /// (X,Y) location of center of projection in texture coords.
+        /// Also used to center RADIAL meshes for the other types.
         std::vector<float> m_distortionCOP;
 
         /// How many K1's wide and high is (0-1) in texture coords
@@ -176,6 +189,17 @@ namespace renderkit {
         //@}
     };
 
+    /// @brief Is the distortion of one eye the exact left-to-right mirror
+    /// image of that of another?
+    ///
+    /// True when both are rgb_symmetric_polynomials with the same
+    /// polynomials, distance scale and mesh settings, and centers of
+    /// projection that mirror each other about the middle of the screen.
+    /// A mesh built for one can then be drawn for the other by negating its
+    /// X positions and mirroring its X texture coordinates.
+    bool OSVR_RENDERMANAGER_EXPORT DistortionParametersAreMirrored(
+        DistortionParameters const& a, DistortionParameters const& b);
+
 } // namespace renderkit
 } // namespace osvr
 
@@ -0,0 +1,275 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "DistortionSampleFile.h"
+#include "Fnv1aHash.h"
+#include "MappedFile.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+namespace osvr {
+namespace renderkit {
+
+    static const uint32_t SAMPLE_FILE_VERSION = 2;
+    static const uint32_t SAMPLE_FILE_BYTE_ORDER = 0x01020304;
+    static const char SAMPLE_FILE_MAGIC[8] = {'O', 'S', 'V', 'R',
+                                              'D', 'S', 'B', '\0'};
+    static const char SAMPLE_FILE_SUFFIX[] = ".bin";
+
+    /// Fixed-size header at the start of each sample file.
+    struct SampleFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint64_t sourceSize;
+        uint64_t sourceHash;
+        uint32_t arrayCount;
+        uint32_t reserved;
+    };
+
+    typedef MonoPointDistortionMeshDescription::value_type SamplePoint;
+    static_assert(sizeof(SamplePoint) == 4 * sizeof(double),
+                  "Point samples must be stored as four packed doubles");
+
+    static uint64_t padTo(uint64_t offset, uint64_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    std::string getDistortionSampleFileName(std::string const& jsonFilename) {
+        return jsonFilename + SAMPLE_FILE_SUFFIX;
+    }
+
+    DistortionSampleSource
+    describeDistortionSampleSource(std::string const& text) {
+        DistortionSampleSource ret;
+        ret.size = text.size();
+        ret.hash = fnv1aHash(text.data(), text.size());
+        return ret;
+    }
+
+    bool writeDistortionSampleFile(
+        std::string const& filename, std::vector<std::string> const& keys,
+        std::vector<MonoPointDistortionMeshDescriptions> const& samples,
+        DistortionSampleSource const& source, std::string& error) {
+        if (keys.size() != samples.size()) {
+            error = "Need one sample array per name";
+            return false;
+        }
+
+        // Lay out the header and tables in memory, then write them and the
+        // samples in one pass.
+        std::vector<char> head(sizeof(SampleFileHeader));
+        SampleFileHeader header = {};
+        std::memcpy(header.magic, SAMPLE_FILE_MAGIC, sizeof(header.magic));
+        header.version = SAMPLE_FILE_VERSION;
+        header.byteOrder = SAMPLE_FILE_BYTE_ORDER;
+        header.sourceSize = source.size;
+        header.sourceHash = source.hash;
+        header.arrayCount = static_cast<uint32_t>(keys.size());
+        std::memcpy(head.data(), &header, sizeof(header));
+        auto append = [&](const void* data, size_t size) {
+            const char* bytes = static_cast<const char*>(data);
+            head.insert(head.end(), bytes, bytes + size);
+        };
+        for (size_t k = 0; k < keys.size(); k++) {
+            uint32_t nameLength = static_cast<uint32_t>(keys[k].size());
+            append(&nameLength, sizeof(nameLength));
+            append(keys[k].data(), keys[k].size());
+            head.resize(static_cast<size_t>(padTo(head.size(), 4)), 0);
+            uint32_t eyeCount = static_cast<uint32_t>(samples[k].size());
+            append(&eyeCount, sizeof(eyeCount));
+            for (auto const& eye : samples[k]) {
+                if (!eye || eye->empty()) {
+                    error = "Empty list of samples for an eye in \"" +
+                            keys[k] + "\"";
+                    return false;
+                }
+                uint32_t count = static_cast<uint32_t>(eye->size());
+                append(&count, sizeof(count));
+            }
+        }
+        head.resize(static_cast<size_t>(padTo(head.size(), 8)), 0);
+
+        std::ofstream out(filename, std::ios::out | std::ios::binary |
+                                        std::ios::trunc);
+        if (!out) {
+            error = "Couldn't create " + filename;
+            return false;
+        }
+        out.write(head.data(), head.size());
+        for (auto const& arrays : samples) {
+            for (auto const& eye : arrays) {
+                out.write(reinterpret_cast<const char*>(eye->data()),
+                          eye->size() * sizeof(SamplePoint));
+            }
+        }
+        out.close();
+        if (!out) {
+            error = "Couldn't write " + filename;
+            std::remove(filename.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    /// One array found in the table of a sample file.
+    struct SampleFileArray {
+        std::string name;
+        std::vector<uint32_t> eyeCounts;
+        uint64_t dataOffset;
+    };
+
+    bool readDistortionSampleFile(
+        std::string const& filename, std::vector<std::string> const& keys,
+        DistortionSampleSource const* source,
+        std::vector<MonoPointDistortionMeshDescriptions>& samples,
+        std::string& error) {
+        error.clear();
+        MappedFile file(filename);
+        if (!file.data()) {
+            if (std::ifstream(filename)) {
+                error = "Couldn't map " + filename + " into memory";
+            }
+            return false;
+        }
+        const char* const data = file.data();
+        const uint64_t size = file.size();
+
+        SampleFileHeader header;
+        if (size < sizeof(header)) {
+            error = "File is too short for its header";
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, SAMPLE_FILE_MAGIC,
+                        sizeof(header.magic)) != 0) {
+            error = "Not a distortion sample file";
+            return false;
+        }
+        if (header.version != SAMPLE_FILE_VERSION) {
+            std::ostringstream s;
+            s << "Unsupported version " << header.version;
+            error = s.str();
+            return false;
+        }
+        if (header.byteOrder != SAMPLE_FILE_BYTE_ORDER) {
+            error = "Written on a machine with a different byte order";
+            return false;
+        }
+        if (source && (header.sourceSize != source->size ||
+                       header.sourceHash != source->hash)) {
+            error = "Converted from a different version of the JSON file";
+            return false;
+        }
+
+        // Walk the tables, checking that each field and then all of the
+        // samples fit within the file.
+        uint64_t offset = sizeof(header);
+        auto readUint32 = [&](uint32_t& value) {
+            if (size - offset < sizeof(value)) {
+                return false;
+            }
+            std::memcpy(&value, data + offset, sizeof(value));
+            offset += sizeof(value);
+            return true;
+        };
+        // Each table takes at least its name length and eye count.
+        if ((size - offset) / (2 * sizeof(uint32_t)) < header.arrayCount) {
+            error = "Truncated array table";
+            return false;
+        }
+        std::vector<SampleFileArray> arrays(header.arrayCount);
+        for (auto& array : arrays) {
+            uint32_t nameLength;
+            uint32_t eyeCount;
+            if (!readUint32(nameLength) || size - offset < nameLength) {
+                error = "Truncated array table";
+                return false;
+            }
+            array.name.assign(data + offset, nameLength);
+            offset = padTo(offset + nameLength, 4);
+            if (offset > size || !readUint32(eyeCount) ||
+                (size - offset) / sizeof(uint32_t) < eyeCount) {
+                error = "Truncated array table";
+                return false;
+            }
+            array.eyeCounts.resize(eyeCount);
+            for (auto& count : array.eyeCounts) {
+                readUint32(count);
+            }
+        }
+        offset = padTo(offset, 8);
+        for (auto& array : arrays) {
+            array.dataOffset = offset;
+            for (auto count : array.eyeCounts) {
+                offset += uint64_t(count) * sizeof(SamplePoint);
+            }
+        }
+        if (offset > size) {
+            error = "Truncated sample data";
+            return false;
+        }
+
+        samples.assign(keys.size(), MonoPointDistortionMeshDescriptions());
+        for (size_t k = 0; k < keys.size(); k++) {
+            const SampleFileArray* found = nullptr;
+            for (auto const& array : arrays) {
+                if (array.name == keys[k]) {
+                    found = &array;
+                }
+            }
+            if (!found || found->eyeCounts.empty()) {
+                error = "No \"" + keys[k] + "\" entry";
+                return false;
+            }
+            uint64_t eyeOffset = found->dataOffset;
+            for (auto count : found->eyeCounts) {
+                if (count == 0) {
+                    error = "Empty list of samples for an eye in \"" +
+                            keys[k] + "\"";
+                    return false;
+                }
+                auto eye =
+                    std::make_shared<MonoPointDistortionMeshDescription>(count);
+                std::memcpy(eye->data(), data + eyeOffset,
+                            count * sizeof(SamplePoint));
+                eyeOffset += uint64_t(count) * sizeof(SamplePoint);
+                samples[k].push_back(std::move(eye));
+            }
+        }
+        return true;
+    }
+
+} // namespace renderkit
+} // namespace osvr
@@ -0,0 +1,119 @@
+/** @file
+    @brief Header
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_DistortionSampleFile_h_GUID_8E3A1F6C_2B94_4D07_95C1_7A4E0D6B3F28
+#define INCLUDED_DistortionSampleFile_h_GUID_8E3A1F6C_2B94_4D07_95C1_7A4E0D6B3F28
+
+// Internal Includes
+#include <osvr/RenderKit/Export.h>
+#include "MonoPointMeshTypes.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace osvr {
+namespace renderkit {
+
+    // Binary form of the point-sample arrays in an external distortion
+    // file, which can be loaded without parsing.  The file holds a fixed
+    // header, one table per array and then the samples themselves.  All
+    // fields are in the byte order of the machine that wrote the file,
+    // which the header records so that a reader on a machine of the other
+    // order rejects it.
+    //
+    //   Header:  char[8] magic "OSVRDSB\0", uint32 version (2), uint32
+    //            byte order mark 0x01020304, uint64 size and uint64
+    //            FNV-1a hash of the JSON file converted, uint32 array
+    //            count, uint32 zero.
+    //   Table:   per array, uint32 name length, the name (not
+    //            terminated) padded with zeros to a multiple of 4 bytes,
+    //            uint32 eye count, then uint32 sample count per eye.
+    //   Samples: starting at the next multiple of 8 bytes, each eye of
+    //            each array in table order, as (inX, inY, outX, outY)
+    //            doubles.
+    //
+    // The sample layout is that of MonoPointDistortionMeshDescription, so
+    // each eye is copied into its description with a single memcpy.
+
+    /// Name of the binary file that, when present next to an external
+    /// distortion JSON file, is loaded in its place.
+    OSVR_RENDERMANAGER_EXPORT std::string
+    getDistortionSampleFileName(std::string const& jsonFilename);
+
+    /// Identifies the contents of the JSON file that a binary sample file
+    /// was converted from, so that a reader can tell that it has changed
+    /// since, even if its size has not.
+    struct DistortionSampleSource {
+        uint64_t size;
+        uint64_t hash;
+    };
+
+    /// Describe the contents of a JSON file, given all of its text.
+    OSVR_RENDERMANAGER_EXPORT DistortionSampleSource
+    describeDistortionSampleSource(std::string const& text);
+
+    /// @brief Write point-sample arrays to a binary distortion sample file.
+    /// @param filename File to create or replace.
+    /// @param keys Names of the arrays, as in the JSON file.
+    /// @param samples One entry per key, each holding one description per
+    ///        eye.
+    /// @param source Description of the JSON file the samples came from,
+    ///        which readers use to notice that it has since changed.
+    /// @param [out] error Describes the problem on failure.
+    /// @return True on success.
+    OSVR_RENDERMANAGER_EXPORT bool writeDistortionSampleFile(
+        std::string const& filename, std::vector<std::string> const& keys,
+        std::vector<MonoPointDistortionMeshDescriptions> const& samples,
+        DistortionSampleSource const& source, std::string& error);
+
+    /// @brief Read point-sample arrays from a binary distortion sample file.
+    ///
+    /// The file is mapped into memory and the samples are copied from the
+    /// mapping into their descriptions.
+    ///
+    /// @param filename File to read.
+    /// @param keys Names of the arrays wanted; the file may hold others.
+    /// @param source Description of the JSON file the binary file should
+    ///        have been converted from, or null to skip that check.
+    /// @param [out] samples Filled in with one entry per key, each holding
+    ///        one description per eye; undefined on failure.
+    /// @param [out] error Describes the problem on failure.  Left empty if
+    ///        the file does not exist, which is not treated as a problem.
+    /// @return True on success.
+    OSVR_RENDERMANAGER_EXPORT bool readDistortionSampleFile(
+        std::string const& filename, std::vector<std::string> const& keys,
+        DistortionSampleSource const* source,
+        std::vector<MonoPointDistortionMeshDescriptions>& samples,
+        std::string& error);
+
+} // namespace renderkit
+} // namespace osvr
+
+#endif // INCLUDED_DistortionSampleFile_h_GUID_8E3A1F6C_2B94_4D07_95C1_7A4E0D6B3F28
@@ -0,0 +1,426 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "DistortionSampleParser.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <array>
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+namespace osvr {
+namespace renderkit {
+
+    /// Walks over JSON text without storing it.  The text must be
+    /// null-terminated, as that of a std::string is, so that numbers can
+    /// be converted in place.  Comments are skipped, as the JSON reader
+    /// used for the rest of the configuration allows them.
+    class JsonScanner {
+      public:
+        JsonScanner(const char* begin, const char* end)
+            : m_begin(begin), m_cur(begin), m_end(end),
+              m_decimalPoint(std::localeconv()->decimal_point) {}
+
+        const char* position() const { return m_cur; }
+        void setPosition(const char* pos) { m_cur = pos; }
+
+        /// Skip whitespace and comments, then return the next character
+        /// without consuming it, or 0 at the end of the text.
+        char peek() {
+            skipWhitespace();
+            return m_cur < m_end ? *m_cur : 0;
+        }
+
+        /// Consume the next character if it is the one expected.
+        bool expect(char c) {
+            if (peek() != c) {
+                return fail(std::string("Expected '") + c + "'");
+            }
+            m_cur++;
+            return true;
+        }
+
+        /// Consume a string, handing back the span between its quotes
+        /// (escape sequences are left as they are).
+        bool string(const char*& begin, const char*& end) {
+            if (!expect('"')) {
+                return false;
+            }
+            begin = m_cur;
+            while (m_cur < m_end && *m_cur != '"') {
+                if (*m_cur == '\\') {
+                    m_cur++;
+                }
+                m_cur++;
+            }
+            if (m_cur >= m_end) {
+                return fail("Unterminated string");
+            }
+            end = m_cur++;
+            return true;
+        }
+
+        bool number(double& value) {
+            char c = peek();
+            if (c != '-' && (c < '0' || c > '9')) {
+                return fail("Expected a number");
+            }
+            char* numberEnd = nullptr;
+            if (m_decimalPoint == ".") {
+                value = std::strtod(m_cur, &numberEnd);
+                if (numberEnd == m_cur || numberEnd > m_end) {
+                    return fail("Malformed number");
+                }
+                m_cur = numberEnd;
+                return true;
+            }
+
+            // strtod expects the decimal point of the application's
+            // locale, which JSON does not use; convert a copy of the
+            // number with its point replaced.
+            m_number.clear();
+            for (const char* p = m_cur; p < m_end; p++) {
+                if (*p == '.') {
+                    m_number += m_decimalPoint;
+                } else if ((*p >= '0' && *p <= '9') || *p == '-' ||
+                           *p == '+' || *p == 'e' || *p == 'E') {
+                    m_number += *p;
+                } else {
+                    break;
+                }
+            }
+            const char* copyBegin = m_number.c_str();
+            value = std::strtod(copyBegin, &numberEnd);
+            if (numberEnd == copyBegin) {
+                return fail("Malformed number");
+            }
+            // Step over as much of the original as strtod used.
+            for (const char* used = copyBegin; used < numberEnd; m_cur++) {
+                used += *m_cur == '.' ? m_decimalPoint.size() : 1;
+            }
+            return true;
+        }
+
+        /// Consume a value of any type.
+        bool skipValue(int depth = 0) {
+            if (depth > 256) {
+                return fail("Nesting too deep");
+            }
+            const char* begin;
+            const char* end;
+            double number;
+            switch (peek()) {
+            case '{':
+                m_cur++;
+                if (peek() == '}') {
+                    m_cur++;
+                    return true;
+                }
+                do {
+                    if (!string(begin, end) || !expect(':') ||
+                        !skipValue(depth + 1)) {
+                        return false;
+                    }
+                } while (comma());
+                return expect('}');
+            case '[':
+                m_cur++;
+                if (peek() == ']') {
+                    m_cur++;
+                    return true;
+                }
+                do {
+                    if (!skipValue(depth + 1)) {
+                        return false;
+                    }
+                } while (comma());
+                return expect(']');
+            case '"':
+                return string(begin, end);
+            case 't':
+                return literal("true");
+            case 'f':
+                return literal("false");
+            case 'n':
+                return literal("null");
+            default:
+                return this->number(number);
+            }
+        }
+
+        /// Consume a comma if there is one.
+        bool comma() {
+            if (peek() == ',') {
+                m_cur++;
+                return true;
+            }
+            return false;
+        }
+
+        /// Scan the object that starts here for members with the names
+        /// given and point each entry of @p values at the value of the
+        /// last member with that name, or leave it null.  Leaves the
+        /// scanner after the object.
+        bool findMembers(std::vector<std::string> const& names,
+                         std::vector<const char*>& values) {
+            values.assign(names.size(), nullptr);
+            if (!expect('{')) {
+                return false;
+            }
+            if (peek() == '}') {
+                m_cur++;
+                return true;
+            }
+            do {
+                const char* begin;
+                const char* end;
+                if (!string(begin, end) || !expect(':')) {
+                    return false;
+                }
+                peek();
+                for (size_t i = 0; i < names.size(); i++) {
+                    if (names[i].size() == static_cast<size_t>(end - begin) &&
+                        std::memcmp(names[i].data(), begin, end - begin) ==
+                            0) {
+                        values[i] = m_cur;
+                    }
+                }
+                if (!skipValue()) {
+                    return false;
+                }
+            } while (comma());
+            return expect('}');
+        }
+
+        /// Record a problem at the current position, unless one has
+        /// already been recorded.
+        /// @return false, for convenience.
+        bool fail(std::string const& what) {
+            if (m_error.empty()) {
+                size_t line = 1;
+                for (const char* c = m_begin; c < m_cur && c < m_end; c++) {
+                    if (*c == '\n') {
+                        line++;
+                    }
+                }
+                std::ostringstream s;
+                s << what << " at line " << line;
+                m_error = s.str();
+            }
+            return false;
+        }
+
+        /// Description of the first problem found, if any.
+        std::string const& error() const { return m_error; }
+
+      private:
+        void skipWhitespace() {
+            while (m_cur < m_end) {
+                char c = *m_cur;
+                if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                    m_cur++;
+                } else if (c == '/' && m_cur + 1 < m_end &&
+                           m_cur[1] == '/') {
+                    while (m_cur < m_end && *m_cur != '\n') {
+                        m_cur++;
+                    }
+                } else if (c == '/' && m_cur + 1 < m_end &&
+                           m_cur[1] == '*') {
+                    const char* close = std::strstr(m_cur + 2, "*/");
+                    m_cur = (close && close < m_end) ? close + 2 : m_end;
+                } else {
+                    return;
+                }
+            }
+        }
+
+        bool literal(const char* word) {
+            size_t len = std::strlen(word);
+            if (static_cast<size_t>(m_end - m_cur) < len ||
+                std::strncmp(m_cur, word, len) != 0) {
+                return fail("Unexpected character");
+            }
+            m_cur += len;
+            return true;
+        }
+
+        const char* m_begin;
+        const char* m_cur;
+        const char* m_end;
+        std::string m_error;
+        /// Decimal point of the C locale when the scanner was made.
+        std::string m_decimalPoint;
+        /// Copy of a number being converted, when that is not '.'.
+        std::string m_number;
+    };
+
+    /// Convert the samples for one eye, which are an array of
+    /// [[inX, inY], [outX, outY]] entries.
+    static bool parseEyeSamples(JsonScanner& scanner,
+                                MonoPointDistortionMeshDescription& eye) {
+        if (!scanner.expect('[')) {
+            return false;
+        }
+        if (scanner.peek() == ']') {
+            return scanner.fail("Empty list of samples for an eye");
+        }
+        do {
+            std::array<std::array<double, 2>, 2> point;
+            if (!scanner.expect('[')) {
+                return false;
+            }
+            for (size_t i = 0; i < 2; i++) {
+                if ((i == 1 && !scanner.expect(',')) || !scanner.expect('[') ||
+                    !scanner.number(point[i][0]) || !scanner.expect(',') ||
+                    !scanner.number(point[i][1]) || !scanner.expect(']')) {
+                    return false;
+                }
+            }
+            if (!scanner.expect(']')) {
+                return false;
+            }
+            eye.push_back(point);
+        } while (scanner.comma());
+        eye.shrink_to_fit();
+        return scanner.expect(']');
+    }
+
+    bool parseDistortionSampleArrays(
+        std::string const& text, std::vector<std::string> const& keys,
+        std::vector<MonoPointDistortionMeshDescriptions>& samples,
+        std::string& error) {
+        // With nothing to read there are no eyes to convert below.
+        if (keys.empty()) {
+            samples.clear();
+            return true;
+        }
+        const char* const begin = text.c_str();
+        const char* const end = begin + text.size();
+        JsonScanner scanner(begin, end);
+
+        // Find the distortion object, skipping over everything else.
+        const char* const path[] = {"display", "hmd", "distortion"};
+        for (auto const& name : path) {
+            std::vector<const char*> found;
+            if (!scanner.findMembers({name}, found)) {
+                error = scanner.error();
+                return false;
+            }
+            if (!found[0]) {
+                error = std::string("No \"") + name + "\" entry";
+                return false;
+            }
+            scanner.setPosition(found[0]);
+        }
+        std::vector<const char*> arrays;
+        if (!scanner.findMembers(keys, arrays)) {
+            error = scanner.error();
+            return false;
+        }
+
+        // Locate the array for each eye of each key, so that they can be
+        // converted independently.
+        struct EyeTask {
+            const char* begin;
+            const char* end;
+            size_t key;
+            size_t eye;
+            std::string error;
+        };
+        std::vector<EyeTask> tasks;
+        samples.assign(keys.size(), MonoPointDistortionMeshDescriptions());
+        for (size_t k = 0; k < keys.size(); k++) {
+            if (!arrays[k]) {
+                error = "No \"" + keys[k] + "\" entry";
+                return false;
+            }
+            scanner.setPosition(arrays[k]);
+            if (!scanner.expect('[')) {
+                error = scanner.error();
+                return false;
+            }
+            if (scanner.peek() == ']') {
+                error = "Empty \"" + keys[k] + "\" entry";
+                return false;
+            }
+            size_t eye = 0;
+            do {
+                scanner.peek();
+                const char* eyeBegin = scanner.position();
+                if (!scanner.skipValue()) {
+                    error = scanner.error();
+                    return false;
+                }
+                tasks.push_back({eyeBegin, scanner.position(), k, eye++,
+                                 std::string()});
+            } while (scanner.comma());
+            if (!scanner.expect(']')) {
+                error = scanner.error();
+                return false;
+            }
+            samples[k].resize(eye);
+        }
+
+        // Convert the eyes in parallel.  Each one is scanned only within
+        // its own span of the text, which was checked above.
+        auto convert = [&](EyeTask& task) {
+            JsonScanner eyeScanner(begin, task.end);
+            eyeScanner.setPosition(task.begin);
+            auto eye = std::make_shared<MonoPointDistortionMeshDescription>();
+            if (!parseEyeSamples(eyeScanner, *eye)) {
+                task.error =
+                    "In \"" + keys[task.key] + "\": " + eyeScanner.error();
+                return;
+            }
+            samples[task.key][task.eye] = std::move(eye);
+        };
+        std::vector<std::thread> workers;
+        for (size_t t = 1; t < tasks.size(); t++) {
+            workers.emplace_back(convert, std::ref(tasks[t]));
+        }
+        convert(tasks[0]);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (auto const& task : tasks) {
+            if (!task.error.empty()) {
+                error = task.error;
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace renderkit
+} // namespace osvr
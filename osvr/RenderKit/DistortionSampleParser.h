@@ -0,0 +1,70 @@
+/** @file
+    @brief Header
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_DistortionSampleParser_h_GUID_5C0E8B2A_71D4_4F96_A3E8_19B6D2F04C73
+#define INCLUDED_DistortionSampleParser_h_GUID_5C0E8B2A_71D4_4F96_A3E8_19B6D2F04C73
+
+// Internal Includes
+#include <osvr/RenderKit/Export.h>
+#include "MonoPointMeshTypes.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace osvr {
+namespace renderkit {
+
+    /// @brief Parse point-sample arrays out of the JSON text of an external
+    /// distortion file without building a document tree.
+    ///
+    /// The text is scanned in place down to the
+    /// display/hmd/distortion object, whose members named in @p keys must
+    /// each hold one array of point samples per eye, in the same layout as
+    /// "mono_point_samples".  Everything else in the file is skipped
+    /// without being stored.  The eye arrays are located first and are then
+    /// converted on separate threads, straight into their final
+    /// descriptions.
+    ///
+    /// @param text Contents of the file.
+    /// @param keys Names of the sample arrays to read.
+    /// @param [out] samples Filled in with one entry per key, each holding
+    ///        one description per eye; undefined on failure.
+    /// @param [out] error Describes the problem on failure.
+    /// @return True on success; false if the text is not valid JSON, lacks
+    ///         one of the arrays, or has a malformed or empty one.
+    OSVR_RENDERMANAGER_EXPORT bool parseDistortionSampleArrays(
+        std::string const& text, std::vector<std::string> const& keys,
+        std::vector<MonoPointDistortionMeshDescriptions>& samples,
+        std::string& error);
+
+} // namespace renderkit
+} // namespace osvr
+
+#endif // INCLUDED_DistortionSampleParser_h_GUID_5C0E8B2A_71D4_4F96_A3E8_19B6D2F04C73
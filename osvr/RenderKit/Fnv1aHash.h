@@ -0,0 +1,59 @@
+/** @file
+    @brief Header
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_Fnv1aHash_h_GUID_4C6E2A91_7B3D_4F08_A5E2_91D0C3B67F14
+#define INCLUDED_Fnv1aHash_h_GUID_4C6E2A91_7B3D_4F08_A5E2_91D0C3B67F14
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstddef>
+#include <cstdint>
+
+namespace osvr {
+namespace renderkit {
+
+    /// Standard starting value of the 64-bit FNV-1a hash.
+    static const uint64_t FNV1A_OFFSET_BASIS = 14695981039346656037ULL;
+
+    /// @brief Continue a 64-bit FNV-1a hash of some bytes.
+    /// @param hash The hash of what came before, or a starting value.
+    inline uint64_t fnv1aHash(const void* data, size_t size,
+                              uint64_t hash = FNV1A_OFFSET_BASIS) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+} // namespace renderkit
+} // namespace osvr
+
+#endif // INCLUDED_Fnv1aHash_h_GUID_4C6E2A91_7B3D_4F08_A5E2_91D0C3B67F14
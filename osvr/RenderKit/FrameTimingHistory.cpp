@@ -0,0 +1,89 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "FrameTimingHistory.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <cmath>
+
+namespace osvr {
+namespace renderkit {
+
+    const size_t FrameTimingHistory::CAPACITY;
+
+    uint64_t FrameTimingHistory::size() const { return m_records.size(); }
+
+    void FrameTimingHistory::record(OSVR_FrameTimingRecord record) {
+        record.frameNumber = m_records.size();
+        m_records.push(record);
+    }
+
+    void FrameTimingHistory::snapshot(
+        std::vector<OSVR_FrameTimingRecord>& records) const {
+        records.clear();
+        const uint64_t count = size();
+        const uint64_t first = m_records.first(count);
+        records.reserve(static_cast<size_t>(count - first));
+        OSVR_FrameTimingRecord record;
+        for (uint64_t index = first; index < count; index++) {
+            // Records that the writer overwrote while we were copying are
+            // dropped; the ones after them are newer and still wanted.
+            if (m_records.read(index, record)) {
+                records.push_back(record);
+            }
+        }
+    }
+
+    bool FrameTimingHistory::percentile(OSVR_FrameTimingStage stage,
+                                        double percentile, double& ms) const {
+        if (stage < 0 || stage >= OSVR_FRAME_TIMING_STAGE_COUNT ||
+            !(percentile >= 0 && percentile <= 100)) {
+            return false;
+        }
+        std::vector<OSVR_FrameTimingRecord> records;
+        snapshot(records);
+        if (records.empty()) {
+            return false;
+        }
+        std::vector<double> values;
+        values.reserve(records.size());
+        for (auto const& record : records) {
+            values.push_back(record.stageMS[stage]);
+        }
+        size_t rank =
+            static_cast<size_t>(std::ceil(percentile / 100 * values.size()));
+        auto nth = values.begin() + (rank > 0 ? rank - 1 : 0);
+        std::nth_element(values.begin(), nth, values.end());
+        ms = *nth;
+        return true;
+    }
+
+} // namespace renderkit
+} // namespace osvr
@@ -0,0 +1,86 @@
+/** @file
+    @brief Header
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_FrameTimingHistory_h_GUID_3B7D95E2_0C4A_4E18_9F63_D52A81C7E40B
+#define INCLUDED_FrameTimingHistory_h_GUID_3B7D95E2_0C4A_4E18_9F63_D52A81C7E40B
+
+// Internal Includes
+#include "SeqlockRing.h"
+#include <osvr/RenderKit/RenderManagerC.h>
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace osvr {
+namespace renderkit {
+
+    /// @brief Fixed-size ring of the timing records of recently presented
+    /// frames.
+    ///
+    /// One thread (the one presenting) adds records; any number of others
+    /// may copy them out at the same time.  Neither side takes a lock or
+    /// allocates in record(); see SeqlockRing.
+    class FrameTimingHistory {
+      public:
+        /// Number of frames kept, about five seconds at 90 Hz.
+        static const size_t CAPACITY = 512;
+
+        FrameTimingHistory() = default;
+        FrameTimingHistory(FrameTimingHistory const&) = delete;
+        FrameTimingHistory& operator=(FrameTimingHistory const&) = delete;
+
+        /// Number of records added so far, which is also the frameNumber
+        /// that record() will give the next one.
+        uint64_t size() const;
+
+        /// Add a record, setting its frameNumber and overwriting the oldest
+        /// one if the ring is full.  Must only be called from one thread at
+        /// a time.
+        void record(OSVR_FrameTimingRecord record);
+
+        /// Copy out the records that are kept, oldest first.
+        void snapshot(std::vector<OSVR_FrameTimingRecord>& records) const;
+
+        /// @brief Find a percentile of the time taken by a stage over the
+        /// records that are kept.
+        /// @param percentile From 0 to 100; the nearest-rank value is used.
+        /// @return False if there are no records or an argument is out of
+        /// range.
+        bool percentile(OSVR_FrameTimingStage stage, double percentile,
+                        double& ms) const;
+
+      private:
+        SeqlockRing<OSVR_FrameTimingRecord, CAPACITY> m_records;
+    };
+
+} // namespace renderkit
+} // namespace osvr
+
+#endif // INCLUDED_FrameTimingHistory_h_GUID_3B7D95E2_0C4A_4E18_9F63_D52A81C7E40B
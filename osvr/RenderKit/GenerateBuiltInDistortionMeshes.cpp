@@ -0,0 +1,129 @@
+/** @file
+    @brief Build-time tool that converts the built-in distortion meshes from
+           the JSON text embedded in osvr_display_config_built_in_osvr_hdks.h
+           into typed arrays, so that the library does not have to parse
+           them at run time.
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "osvr_display_config_built_in_osvr_hdks.h"
+
+// Library/third-party includes
+#include <json/reader.h>
+#include <json/value.h>
+
+// Standard includes
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+struct BuiltInNameAndData {
+    const char* name;
+    const char* dataString;
+};
+
+static const BuiltInNameAndData BUILT_IN_TABLES[] = {
+    {"osvr_display_config_built_in_osvr_hdk13_v1",
+     osvr_display_config_built_in_osvr_hdk13_v1},
+    {"osvr_display_config_built_in_osvr_hdk13_v2",
+     osvr_display_config_built_in_osvr_hdk13_v2},
+    {"osvr_display_config_built_in_osvr_hdk20_v1",
+     osvr_display_config_built_in_osvr_hdk20_v1}};
+
+/// Write one table as a flat array of (inX, inY, outX, outY) samples, eye
+/// after eye, along with an array holding the number of samples per eye.
+static bool writeTable(FILE* out, BuiltInNameAndData const& table) {
+    Json::Reader reader;
+    Json::Value root;
+    if (!reader.parse(std::string(table.dataString), root, false)) {
+        std::cerr << "GenerateBuiltInDistortionMeshes: Couldn't parse "
+                  << table.name << ": "
+                  << reader.getFormattedErrorMessages() << std::endl;
+        return false;
+    }
+    Json::Value const& eyes =
+        root["display"]["hmd"]["distortion"]["mono_point_samples"];
+    if (!eyes.isArray() || eyes.empty()) {
+        std::cerr << "GenerateBuiltInDistortionMeshes: No mono_point_samples "
+                     "in "
+                  << table.name << std::endl;
+        return false;
+    }
+
+    std::fprintf(out, "static const double %s_mono_point_samples[] = {\n",
+                 table.name);
+    for (auto const& eye : eyes) {
+        for (auto const& elt : eye) {
+            if ((elt.size() != 2) || (elt[0].size() != 2) ||
+                (elt[1].size() != 2)) {
+                std::cerr << "GenerateBuiltInDistortionMeshes: Malformed "
+                             "sample in "
+                          << table.name << std::endl;
+                return false;
+            }
+            // Print enough digits that each value reads back exactly as
+            // the JSON parser produced it.
+            std::fprintf(out, "  %.17g, %.17g, %.17g, %.17g,\n",
+                         elt[0][0].asDouble(), elt[0][1].asDouble(),
+                         elt[1][0].asDouble(), elt[1][1].asDouble());
+        }
+    }
+    std::fprintf(out, "};\n");
+
+    std::fprintf(out, "static const size_t %s_mono_point_counts[] = {",
+                 table.name);
+    for (auto const& eye : eyes) {
+        std::fprintf(out, " %u,", eye.size());
+    }
+    std::fprintf(out, " };\n\n");
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " OutputHeader" << std::endl;
+        return -1;
+    }
+    FILE* out = std::fopen(argv[1], "w");
+    if (!out) {
+        std::cerr << "GenerateBuiltInDistortionMeshes: Couldn't open "
+                  << argv[1] << " for writing" << std::endl;
+        return -1;
+    }
+    std::fprintf(out, "// Generated at build time by "
+                      "GenerateBuiltInDistortionMeshes from\n"
+                      "// osvr_display_config_built_in_osvr_hdks.h; do not "
+                      "edit.\n\n"
+                      "#include <cstddef>\n\n");
+    bool ok = true;
+    for (auto const& table : BUILT_IN_TABLES) {
+        ok = writeTable(out, table) && ok;
+    }
+    std::fclose(out);
+    if (!ok) {
+        std::remove(argv[1]);
+        return -1;
+    }
+    return 0;
+}
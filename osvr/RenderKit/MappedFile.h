@@ -0,0 +1,130 @@
+/** @file
+    @brief Header
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_MappedFile_h_GUID_3F7B0C52_9D1E_4A86_B2E4_6C08F15A9D37
+#define INCLUDED_MappedFile_h_GUID_3F7B0C52_9D1E_4A86_B2E4_6C08F15A9D37
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Standard includes
+#include <cstddef>
+#include <string>
+
+namespace osvr {
+namespace renderkit {
+
+    /// Read-only memory mapping of an entire file.
+    class MappedFile {
+      public:
+        explicit MappedFile(std::string const& path) {
+#ifdef _WIN32
+            m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                 nullptr, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE) {
+                return;
+            }
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+                return;
+            }
+            m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0,
+                                           0, nullptr);
+            if (!m_mapping) {
+                return;
+            }
+            m_data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+            if (m_data) {
+                m_size = static_cast<size_t>(size.QuadPart);
+            }
+#else
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                return;
+            }
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0) {
+                void* data = mmap(nullptr, static_cast<size_t>(st.st_size),
+                                  PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED) {
+                    m_data = data;
+                    m_size = static_cast<size_t>(st.st_size);
+                }
+            }
+            close(fd);
+#endif
+        }
+
+        ~MappedFile() {
+#ifdef _WIN32
+            if (m_data) {
+                UnmapViewOfFile(m_data);
+            }
+            if (m_mapping) {
+                CloseHandle(m_mapping);
+            }
+            if (m_file != INVALID_HANDLE_VALUE) {
+                CloseHandle(m_file);
+            }
+#else
+            if (m_data) {
+                munmap(m_data, m_size);
+            }
+#endif
+        }
+
+        MappedFile(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile const&) = delete;
+
+        const char* data() const { return static_cast<const char*>(m_data); }
+        size_t size() const { return m_size; }
+
+      private:
+        void* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping = nullptr;
+#endif
+    };
+
+} // namespace renderkit
+} // namespace osvr
+
+#endif // INCLUDED_MappedFile_h_GUID_3F7B0C52_9D1E_4A86_B2E4_6C08F15A9D37
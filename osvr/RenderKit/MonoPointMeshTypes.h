@@ -33,6 +33,8 @@
 
 // Standard includes
 #include <array>
+#include <cstddef>
+#include <memory>
 #include <vector>
 
 namespace osvr {
@@ -48,8 +50,70 @@ namespace renderkit {
             ,
             2> > MonoPointDistortionMeshDescription;
 
+    /// Point samples are immutable once they have been parsed, so that
+    /// the display configuration, the DistortionParameters made from it and
+    /// the mesh interpolators can share a single copy of them.
+    typedef std::shared_ptr<const MonoPointDistortionMeshDescription>
+        MonoPointDistortionMeshDescriptionPtr;
+
     typedef std::vector< //!< One mapping per eye
-        MonoPointDistortionMeshDescription> MonoPointDistortionMeshDescriptions;
+        MonoPointDistortionMeshDescriptionPtr>
+        MonoPointDistortionMeshDescriptions;
+
+    /// The same kind of mapping as a MonoPointDistortionMeshDescription,
+    /// packed into one float array per coordinate so that loops over the
+    /// points read contiguous memory and can be vectorized.  Entry i of
+    /// each array belongs to point i.
+    struct PackedMonoPointSamples {
+        std::vector<float> inX;  ///< Physical-display X of each point
+        std::vector<float> inY;  ///< Physical-display Y of each point
+        std::vector<float> outX; ///< Canonical-display X of each point
+        std::vector<float> outY; ///< Canonical-display Y of each point
+
+        size_t size() const { return inX.size(); }
+        bool empty() const { return inX.empty(); }
+
+        void reserve(size_t n) {
+            inX.reserve(n);
+            inY.reserve(n);
+            outX.reserve(n);
+            outY.reserve(n);
+        }
+
+        void push_back(float fromX, float fromY, float toX, float toY) {
+            inX.push_back(fromX);
+            inY.push_back(fromY);
+            outX.push_back(toX);
+            outY.push_back(toY);
+        }
+    };
+
+    /// Pack a point-sample description, as parsed from a display
+    /// configuration, into float arrays.
+    inline PackedMonoPointSamples
+    packMonoPointSamples(MonoPointDistortionMeshDescription const& points) {
+        PackedMonoPointSamples ret;
+        ret.reserve(points.size());
+        for (auto const& point : points) {
+            ret.push_back(static_cast<float>(point[0][0]),
+                          static_cast<float>(point[0][1]),
+                          static_cast<float>(point[1][0]),
+                          static_cast<float>(point[1][1]));
+        }
+        return ret;
+    }
+
+    /// Turn packed samples back into a point-sample description, for code
+    /// that works with the description.
+    inline MonoPointDistortionMeshDescription
+    unpackMonoPointSamples(PackedMonoPointSamples const& samples) {
+        MonoPointDistortionMeshDescription ret(samples.size());
+        for (size_t i = 0; i < samples.size(); i++) {
+            ret[i][0] = {{samples.inX[i], samples.inY[i]}};
+            ret[i][1] = {{samples.outX[i], samples.outY[i]}};
+        }
+        return ret;
+    }
 
 } // namespace renderkit
 } // namespace osvr
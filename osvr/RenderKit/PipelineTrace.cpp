@@ -0,0 +1,139 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "PipelineTrace.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <cstdio>
+
+namespace osvr {
+namespace renderkit {
+
+    /// Size at which buffered events are written to the file.
+    static const size_t TRACE_FLUSH_BYTES = 64 * 1024;
+
+    /// Traces that are open, by file name, so that RenderManagers naming
+    /// the same file share one.
+    static std::mutex s_openTracesMutex;
+    static std::map<std::string, std::weak_ptr<PipelineTrace> > s_openTraces;
+
+    std::shared_ptr<PipelineTrace>
+    PipelineTrace::open(std::string const& filename) {
+        std::lock_guard<std::mutex> lock(s_openTracesMutex);
+        std::shared_ptr<PipelineTrace> ret = s_openTraces[filename].lock();
+        if (!ret) {
+            ret.reset(new PipelineTrace(filename));
+            if (!ret->m_file) {
+                s_openTraces.erase(filename);
+                return nullptr;
+            }
+            s_openTraces[filename] = ret;
+        }
+        return ret;
+    }
+
+    PipelineTrace::PipelineTrace(std::string const& filename)
+        : m_file(filename, std::ios::out | std::ios::trunc) {
+        osvrTimeValueGetNow(&m_start);
+        m_buffer = "[\n";
+        std::lock_guard<std::mutex> lock(m_mutex);
+        write("process_name", 'M', nullptr, 0);
+        m_buffer += ",\"args\":{\"name\":\"RenderManager\"}}";
+    }
+
+    PipelineTrace::~PipelineTrace() {
+        m_buffer += "\n]\n";
+        m_file << m_buffer;
+    }
+
+    void PipelineTrace::begin(const char* name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        write(name, 'B', nullptr, 0);
+        m_buffer += "}";
+    }
+
+    void PipelineTrace::end(const char* name, const Arg* args,
+                            size_t numArgs) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        write(name, 'E', args, numArgs);
+        m_buffer += "}";
+        if (m_buffer.size() >= TRACE_FLUSH_BYTES) {
+            m_file << m_buffer;
+            m_file.flush();
+            m_buffer.clear();
+        }
+    }
+
+    void PipelineTrace::nameThread(const char* name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        write("thread_name", 'M', nullptr, 0);
+        m_buffer += ",\"args\":{\"name\":\"";
+        m_buffer += name;
+        m_buffer += "\"}}";
+    }
+
+    double PipelineTrace::traceTime(OSVR_TimeValue const& time) const {
+        return osvrTimeValueDurationSeconds(&time, &m_start) * 1e6;
+    }
+
+    void PipelineTrace::write(const char* name, char phase, const Arg* args,
+                              size_t numArgs) {
+        OSVR_TimeValue now;
+        osvrTimeValueGetNow(&now);
+        char event[256];
+        std::snprintf(event, sizeof(event),
+                      "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.1f,"
+                      "\"pid\":1,\"tid\":%d",
+                      m_firstEvent ? "" : ",\n", name, phase,
+                      traceTime(now), threadId());
+        m_firstEvent = false;
+        m_buffer += event;
+        for (size_t i = 0; i < numArgs; i++) {
+            std::snprintf(event, sizeof(event), "%s\"%s\":%.3f",
+                          i == 0 ? ",\"args\":{" : ",", args[i].name,
+                          args[i].value);
+            m_buffer += event;
+        }
+        if (numArgs > 0) {
+            m_buffer += "}";
+        }
+    }
+
+    int PipelineTrace::threadId() {
+        auto found = m_threadIds.find(std::this_thread::get_id());
+        if (found != m_threadIds.end()) {
+            return found->second;
+        }
+        int id = static_cast<int>(m_threadIds.size()) + 1;
+        m_threadIds[std::this_thread::get_id()] = id;
+        return id;
+    }
+
+} // namespace renderkit
+} // namespace osvr
@@ -0,0 +1,161 @@
+/** @file
+    @brief Header
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_PipelineTrace_h_GUID_C41E6A07_93D2_4B5F_8A1C_6E0F27B9D354
+#define INCLUDED_PipelineTrace_h_GUID_C41E6A07_93D2_4B5F_8A1C_6E0F27B9D354
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+#include <osvr/Util/TimeValueC.h>
+
+// Standard includes
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace osvr {
+namespace renderkit {
+
+    /// @brief Writes begin and end events for the stages of rendering and
+    /// presentation to a file, as a timeline of all of the threads involved.
+    ///
+    /// The file is in the JSON form of the Chrome trace event format, which
+    /// chrome://tracing and the Perfetto UI both load.  Times are in
+    /// microseconds since the trace was opened, on the clock that tracker
+    /// reports are stamped with, so that pose timestamps attached to
+    /// events line up with the events themselves.
+    ///
+    /// Events are buffered and written out in blocks, and the file is
+    /// completed when the last RenderManager using it is destroyed.  A
+    /// file that was not completed can still be loaded.
+    class PipelineTrace {
+      public:
+        /// Get the trace writing to @p filename, creating the file if no
+        /// other RenderManager in this process is already writing it.  This
+        /// lets a time-warp wrapper and the RenderManager it harnesses put
+        /// their threads on one timeline.
+        /// @return nullptr if the file could not be created.
+        static std::shared_ptr<PipelineTrace>
+        open(std::string const& filename);
+
+        ~PipelineTrace();
+        PipelineTrace(PipelineTrace const&) = delete;
+        PipelineTrace& operator=(PipelineTrace const&) = delete;
+
+        /// A value attached to an event.
+        struct Arg {
+            const char* name;
+            double value;
+        };
+
+        /// Begin an event on the calling thread.  @p name must be a
+        /// string literal, or otherwise outlive the trace, and need no
+        /// escaping in JSON.
+        void begin(const char* name);
+
+        /// End the most recent event begun on the calling thread.
+        void end(const char* name, const Arg* args = nullptr,
+                 size_t numArgs = 0);
+
+        /// Label the calling thread on the timeline.
+        void nameThread(const char* name);
+
+        /// Microseconds from the opening of the trace to @p time.
+        double traceTime(OSVR_TimeValue const& time) const;
+
+        /// Begins an event when constructed and ends it when destroyed.
+        /// Does nothing if given a null trace, so that code can be
+        /// instrumented whether or not tracing is enabled.
+        class Scope {
+          public:
+            Scope(PipelineTrace* trace, const char* name)
+                : m_trace(trace), m_name(name) {
+                if (m_trace) {
+                    m_trace->begin(m_name);
+                }
+            }
+            ~Scope() {
+                if (m_trace) {
+                    m_trace->end(m_name, m_args, m_numArgs);
+                }
+            }
+            Scope(Scope const&) = delete;
+            Scope& operator=(Scope const&) = delete;
+
+            /// Attach a value to the end of the event.
+            void arg(const char* name, double value) {
+                if (m_trace && m_numArgs < MAX_ARGS) {
+                    m_args[m_numArgs].name = name;
+                    m_args[m_numArgs].value = value;
+                    m_numArgs++;
+                }
+            }
+
+            /// Attach a time, converted to the timeline of the trace.
+            /// Times of (0,0), which mean "unknown", are left out.
+            void timeArg(const char* name, OSVR_TimeValue const& time) {
+                if (m_trace && (time.seconds != 0 || time.microseconds != 0)) {
+                    arg(name, m_trace->traceTime(time));
+                }
+            }
+
+          private:
+            static const size_t MAX_ARGS = 6;
+            PipelineTrace* m_trace;
+            const char* m_name;
+            Arg m_args[MAX_ARGS];
+            size_t m_numArgs = 0;
+        };
+
+      private:
+        explicit PipelineTrace(std::string const& filename);
+
+        /// Append an event to the buffer, writing the buffer out when it
+        /// has grown large.  Must be called with m_mutex locked.
+        void write(const char* name, char phase, const Arg* args,
+                   size_t numArgs);
+
+        /// Small number identifying the calling thread in the trace.  Must
+        /// be called with m_mutex locked.
+        int threadId();
+
+        std::mutex m_mutex;
+        std::ofstream m_file;
+        std::string m_buffer;
+        bool m_firstEvent = true;
+        OSVR_TimeValue m_start;
+        std::map<std::thread::id, int> m_threadIds;
+    };
+
+} // namespace renderkit
+} // namespace osvr
+
+#endif // INCLUDED_PipelineTrace_h_GUID_C41E6A07_93D2_4B5F_8A1C_6E0F27B9D354
@@ -0,0 +1,186 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "PoseHistory.h"
+#include "DeltaQuatDeadReckoning.h"
+
+// Library/third-party includes
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+// Standard includes
+// - none
+
+namespace osvr {
+namespace renderkit {
+
+    const size_t PoseHistory::CAPACITY;
+
+    static Eigen::Quaterniond toEigen(OSVR_Quaternion const& q) {
+        return Eigen::Quaterniond(q.data[0], q.data[1], q.data[2], q.data[3]);
+    }
+
+    static OSVR_Quaternion fromEigen(Eigen::Quaterniond const& q) {
+        OSVR_Quaternion ret;
+        ret.data[0] = q.w();
+        ret.data[1] = q.x();
+        ret.data[2] = q.y();
+        ret.data[3] = q.z();
+        return ret;
+    }
+
+    uint64_t PoseHistory::size() const { return m_samples.size(); }
+
+    void PoseHistory::record(Sample const& sample) { m_samples.push(sample); }
+
+    bool PoseHistory::latest(Sample& sample) const {
+        // If the writer laps us while we copy the newest sample, there is
+        // a newer one to take instead.
+        for (;;) {
+            const uint64_t count = size();
+            if (count == 0) {
+                return false;
+            }
+            if (m_samples.read(count - 1, sample)) {
+                return true;
+            }
+        }
+    }
+
+    bool PoseHistory::poseAt(OSVR_TimeValue const& when, OSVR_PoseState& pose,
+                             bool estimateVelocity) const {
+        // Walk back from the newest sample to the first one at or before
+        // the time asked for; queries are usually near the present, so
+        // this is only a few steps.
+        Sample sample, next;
+        uint64_t index;
+        for (;;) {
+            const uint64_t count = size();
+            if (count == 0) {
+                return false;
+            }
+            const uint64_t oldest = m_samples.first(count);
+            index = count - 1;
+            if (!m_samples.read(index, sample)) {
+                continue; // Lapped while reading the newest; start over.
+            }
+            if (!osvrTimeValueGreater(&sample.time, &when)) {
+                break;
+            }
+            bool lapped = false;
+            do {
+                if (index == oldest) {
+                    // Older than anything we have.
+                    pose = sample.pose;
+                    return true;
+                }
+                next = sample;
+                index--;
+                lapped = !m_samples.read(index, sample);
+            } while (!lapped && osvrTimeValueGreater(&sample.time, &when));
+            if (lapped) {
+                // The writer overwrote a sample before we got to it; start
+                // over from the new newest one.
+                continue;
+            }
+
+            // Interpolate between the samples on either side.
+            double span = osvrTimeValueDurationSeconds(&next.time, &sample.time);
+            double fraction =
+                span > 0
+                    ? osvrTimeValueDurationSeconds(&when, &sample.time) / span
+                    : 1;
+            for (int i = 0; i < 3; i++) {
+                pose.translation.data[i] =
+                    sample.pose.translation.data[i] +
+                    fraction * (next.pose.translation.data[i] -
+                                sample.pose.translation.data[i]);
+            }
+            pose.rotation =
+                fromEigen(toEigen(sample.pose.rotation)
+                              .slerp(fraction, toEigen(next.pose.rotation)));
+            return true;
+        }
+
+        // The time is at or after the newest sample: extrapolate from it,
+        // using the sample before it for whatever velocity is missing if
+        // asked to.  That difference is over a single tracker interval, so
+        // it carries the tracker's noise, scaled up by the prediction.
+        Sample const& newest = sample;
+        double ahead = osvrTimeValueDurationSeconds(&when, &newest.time);
+        pose = newest.pose;
+        if (ahead <= 0) {
+            return true;
+        }
+        Sample previous;
+        double span = 0;
+        if (estimateVelocity && index > 0 &&
+            m_samples.read(index - 1, previous) &&
+            !osvrTimeValueGreater(&previous.time, &newest.time)) {
+            span = osvrTimeValueDurationSeconds(&newest.time, &previous.time);
+        }
+
+        if (newest.velocity.linearVelocityValid) {
+            for (int i = 0; i < 3; i++) {
+                pose.translation.data[i] +=
+                    newest.velocity.linearVelocity.data[i] * ahead;
+            }
+        } else if (span > 0) {
+            for (int i = 0; i < 3; i++) {
+                pose.translation.data[i] +=
+                    (newest.pose.translation.data[i] -
+                     previous.pose.translation.data[i]) *
+                    ahead / span;
+            }
+        }
+
+        if (newest.velocity.angularVelocityValid &&
+            newest.velocity.angularVelocity.dt > 0) {
+            pose.rotation = fromEigen(osvr::util::applyQuatDeadReckoning(
+                toEigen(newest.pose.rotation),
+                newest.velocity.angularVelocity.dt,
+                toEigen(newest.velocity.angularVelocity.incrementalRotation),
+                ahead));
+        } else if (span > 0) {
+            // Keep turning at the rate of the last interval: the change
+            // over it is scaled by angle rather than applied repeatedly, as
+            // the interval may be much shorter than the prediction.
+            Eigen::Quaterniond delta = toEigen(newest.pose.rotation) *
+                                       toEigen(previous.pose.rotation)
+                                           .inverse();
+            if (delta.w() < 0) {
+                delta.coeffs() = -delta.coeffs();
+            }
+            Eigen::AngleAxisd turn(delta);
+            turn.angle() *= ahead / span;
+            pose.rotation = fromEigen(Eigen::Quaterniond(turn) *
+                                      toEigen(newest.pose.rotation));
+        }
+        return true;
+    }
+
+} // namespace renderkit
+} // namespace osvr
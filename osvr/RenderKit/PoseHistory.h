@@ -0,0 +1,98 @@
+/** @file
+    @brief Header
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_PoseHistory_h_GUID_9E4A7C12_B6D3_4F85_8A21_3C5F0E9D7B64
+#define INCLUDED_PoseHistory_h_GUID_9E4A7C12_B6D3_4F85_8A21_3C5F0E9D7B64
+
+// Internal Includes
+#include "SeqlockRing.h"
+
+// Library/third-party includes
+#include <osvr/Util/ClientReportTypesC.h>
+#include <osvr/Util/TimeValueC.h>
+
+// Standard includes
+#include <cstddef>
+#include <cstdint>
+
+namespace osvr {
+namespace renderkit {
+
+    /// @brief Fixed-size ring of the most recent timestamped poses of one
+    /// tracker, with queries for the pose at any time.
+    ///
+    /// One thread (the one that updates the client context) adds samples;
+    /// any number of others may read them at the same time without
+    /// locking; see SeqlockRing.
+    class PoseHistory {
+      public:
+        /// Number of samples kept, over 100ms of a 1kHz tracker.
+        static const size_t CAPACITY = 128;
+
+        /// One report of the tracker.
+        struct Sample {
+            OSVR_TimeValue time;
+            OSVR_PoseState pose;
+            /// The most recent velocity reported at that time; its valid
+            /// flags are false if there has been none.
+            OSVR_VelocityState velocity;
+        };
+
+        PoseHistory() = default;
+        PoseHistory(PoseHistory const&) = delete;
+        PoseHistory& operator=(PoseHistory const&) = delete;
+
+        /// Number of samples added so far.
+        uint64_t size() const;
+
+        /// Add a sample, overwriting the oldest if the ring is full.
+        /// Samples should be added in time order.  Must only be called
+        /// from one thread at a time.
+        void record(Sample const& sample);
+
+        /// Copy the newest sample.
+        /// @return False if there are no samples.
+        bool latest(Sample& sample) const;
+
+        /// @brief Find the pose at time @p when.
+        ///
+        /// Between two samples, the translation is interpolated linearly
+        /// and the rotation spherically.  Past the newest sample, the pose
+        /// is extrapolated using the parts of its velocity that are valid;
+        /// if @p estimateVelocity is true, the change from the sample
+        /// before it stands in for the others, otherwise they are taken
+        /// as zero.  Before the oldest sample kept, it is the oldest pose.
+        /// @return False if there are no samples.
+        bool poseAt(OSVR_TimeValue const& when, OSVR_PoseState& pose,
+                    bool estimateVelocity = false) const;
+
+      private:
+        SeqlockRing<Sample, CAPACITY> m_samples;
+    };
+
+} // namespace renderkit
+} // namespace osvr
+
+#endif // INCLUDED_PoseHistory_h_GUID_9E4A7C12_B6D3_4F85_8A21_3C5F0E9D7B64
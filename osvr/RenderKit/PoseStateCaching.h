@@ -26,7 +26,7 @@
 #define INCLUDED_PoseStateCaching_h_GUID_0424A36E_4123_45A3_6DB8_3A6E4B90665B
 
 // Internal Includes
-// - none
+#include "PoseHistory.h"
 
 // Library/third-party includes
 #include <osvr/ClientKit/ContextC.h>
@@ -41,6 +41,10 @@ namespace osvr {
 namespace renderkit {
     /// A class that handles stashing poses with optionally overridden timestamps.
     ///
+    /// The recent poses are kept in a PoseHistory, so they can be read from
+    /// other threads than the one updating the context, and the pose at a
+    /// given time can be looked up.
+    ///
     /// The associated client context must outlive it.
     class PoseStateCaching {
       public:
@@ -53,6 +57,7 @@ namespace renderkit {
                 return;
             }
             osvrRegisterPoseCallback(iface_, &handleReport, this);
+            osvrRegisterVelocityCallback(iface_, &handleVelocityReport, this);
         }
 
         /// Destructor: cleans up the client interface object.
@@ -70,7 +75,7 @@ namespace renderkit {
         PoseStateCaching& operator=(PoseStateCaching const&) = delete;
 
         /// Indicates whether this object has observed a pose report yet.
-        bool hasReport() const { return hasPose_; }
+        bool hasReport() const { return history_.size() > 0; }
 
         /// Retrieve the last report, if one exists.
         /// If none exists, out params are unchanged.
@@ -80,33 +85,57 @@ namespace renderkit {
         ///
         /// @return true if there was a report observed and returned in the out params.
         bool getLastReport(util::time::TimeValue& tv, OSVR_Pose3& pose) const {
-            if (!hasPose_) {
+            PoseHistory::Sample sample;
+            if (!history_.latest(sample)) {
                 return false;
             }
 
-            tv = lastTimestamp_;
-            pose = pose_;
+            tv = sample.time;
+            pose = sample.pose;
             return true;
         }
 
+        /// Retrieve the pose at a given time, interpolated between the reports
+        /// around it or predicted from the last one; see PoseHistory::poseAt().
+        /// If no report exists, the out param is unchanged.
+        ///
+        /// @param tv Time to find the pose at, in the same clock as the report
+        /// timestamps.
+        /// @param [out] pose The pose at that time.
+        /// @param estimateVelocity Predict from the change between the last
+        /// two reports where the tracker reports no velocity?
+        ///
+        /// @return true if there was a report observed to find the pose from.
+        bool getPoseAt(util::time::TimeValue const& tv, OSVR_Pose3& pose,
+                       bool estimateVelocity = false) const {
+            return history_.poseAt(tv, pose, estimateVelocity);
+        }
+
       private:
         static void handleReport(void* userdata, const struct OSVR_TimeValue* timestamp,
                                  const struct OSVR_PoseReport* report) {
             auto self = static_cast<PoseStateCaching*>(userdata);
-            self->hasPose_ = true;
-            self->pose_ = report->pose;
+            PoseHistory::Sample sample;
+            sample.pose = report->pose;
+            sample.velocity = self->velocity_;
             if (self->overrideTime_) {
-                osvrTimeValueGetNow(&self->lastTimestamp_);
+                osvrTimeValueGetNow(&sample.time);
             } else {
-                self->lastTimestamp_ = *timestamp;
+                sample.time = *timestamp;
             }
+            self->history_.record(sample);
+        }
+        static void handleVelocityReport(void* userdata, const struct OSVR_TimeValue* /*timestamp*/,
+                                         const struct OSVR_VelocityReport* report) {
+            // Only read by handleReport(), on the same thread.
+            auto self = static_cast<PoseStateCaching*>(userdata);
+            self->velocity_ = report->state;
         }
         OSVR_ClientContext ctx_;
         bool overrideTime_;
         OSVR_ClientInterface iface_ = nullptr;
-        bool hasPose_ = false;
-        util::time::TimeValue lastTimestamp_;
-        OSVR_Pose3 pose_;
+        OSVR_VelocityState velocity_ = {};
+        PoseHistory history_;
     };
 
 } // namespace renderkit
@@ -41,7 +41,7 @@ namespace renderkit {
 
     typedef std::array< //!< One mapping per color red, green, blue
         std::vector<    //!< One mapping per eye
-            MonoPointDistortionMeshDescription>,
+            MonoPointDistortionMeshDescriptionPtr>,
         3> RGBPointDistortionMeshDescriptions;
 
 } // namespace renderkit
@@ -33,10 +33,13 @@ Russ Taylor <russ@sensics.com>
 #include "UnstructuredMeshInterpolator.h"
 #include "Float2.h"
 #include "DistortionMesh.h"
+#include "DistortionMeshCache.h"
+#include "VsyncWaitScheduler.h"
 
 // Library/third-party includes
 #include <osvr/ClientKit/ContextC.h>
 #include <osvr/ClientKit/InterfaceC.h>
+#include <osvr/Util/ClientReportTypesC.h>
 #include <osvr/Util/TimeValueC.h>
 #include <osvr/Util/Logger.h>
 
@@ -46,6 +49,10 @@ Russ Taylor <russ@sensics.com>
 #include <memory>
 #include <mutex>
 #include <array>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <condition_variable>
 
 // Forward declaration so that we can avoid including this header in
 // files that the client has to include.
@@ -61,6 +68,10 @@ namespace osvr {
 namespace renderkit {
     // forward declaration to avoid dragging in dependencies.
     class PoseStateCaching;
+    class FrameTimingHistory;
+    class PipelineTrace;
+    class TrackerIngestionThread;
+    struct TrackerSnapshot;
 
     //=========================================================================
     // Handles optimizing rendering given a description of the desired rendering
@@ -496,6 +507,76 @@ namespace renderkit {
         bool OSVR_RENDERMANAGER_EXPORT
           PresentSolidColor(const RGBColorf &color);
 
+        ///-------------------------------------------------------------
+        /// @brief Get the counters of the on-disk distortion mesh cache
+        ///
+        /// Reports how many meshes were loaded from or missing in the
+        /// cache, and how much time the hits saved.
+        /// @return False if the cache is not enabled, true and filled-in
+        /// statistics if it is.
+        bool OSVR_RENDERMANAGER_EXPORT GetDistortionMeshCacheStatistics(
+            DistortionMeshCache::Statistics& stats);
+
+        ///-------------------------------------------------------------
+        /// @brief Get how the waits for maxMsBeforeVsync have gone
+        ///
+        /// Reports how late the waits ended compared to when they were
+        /// predicted to, and how much of each is spent spinning.
+        /// @return True, with filled-in statistics.
+        bool OSVR_RENDERMANAGER_EXPORT GetVsyncWaitStatistics(
+            VsyncWaitScheduler::Statistics& stats);
+
+        ///-------------------------------------------------------------
+        /// @brief Time spent in each phase of starting up, in milliseconds
+        struct StartupTimings {
+            /// Waiting for the server to report the display.
+            double waitForDisplayMS = 0;
+            /// Reading the display and pipeline configurations.
+            double parseConfigurationMS = 0;
+            /// Constructing the renderer.
+            double createRendererMS = 0;
+            /// Computing the distortion meshes on a worker thread, which
+            /// starts when the renderer has been constructed and runs
+            /// alongside the application's set-up and OpenDisplay().
+            double distortionMeshComputeMS = 0;
+            /// Time OpenDisplay() spent waiting for the worker to finish.
+            double distortionMeshWaitMS = 0;
+            /// From the start of createRenderManager() to the end of the
+            /// first presented frame; 0 until that frame is presented.
+            double firstPresentMS = 0;
+        };
+
+        ///-------------------------------------------------------------
+        /// @brief Get the time spent in each phase of starting up
+        ///
+        /// The same report is written to the log when the first frame has
+        /// been presented.
+        /// @return False if this RenderManager was not made by
+        /// createRenderManager(), true and filled-in timings if it was.
+        bool OSVR_RENDERMANAGER_EXPORT GetStartupTimings(
+            StartupTimings& timings);
+
+        ///-------------------------------------------------------------
+        /// @brief Get the timing records of recently presented frames
+        ///
+        /// A fixed number of records is kept, the oldest being overwritten.
+        /// This does not wait for a frame being presented to finish, so it
+        /// can be called from any thread at any time.
+        /// @param [out] records The records kept, oldest first.
+        void OSVR_RENDERMANAGER_EXPORT GetFrameTimings(
+            std::vector<OSVR_FrameTimingRecord>& records);
+
+        ///-------------------------------------------------------------
+        /// @brief Find a percentile of the time taken by a stage of
+        /// presentation over the recently presented frames.
+        /// @param stage Stage of interest.
+        /// @param percentile From 0 to 100, for example 50 or 99.
+        /// @param [out] ms The time at that percentile.
+        /// @return False if no frames have been presented or an argument is
+        /// out of range.
+        bool OSVR_RENDERMANAGER_EXPORT GetFrameTimingPercentile(
+            OSVR_FrameTimingStage stage, double percentile, double& ms);
+
         ///-------------------------------------------------------------
         /// @brief Get rendering-time statistics for upcoming frame
         ///
@@ -531,6 +612,7 @@ namespace renderkit {
                 m_numBuffers = 2;
                 m_verticalSync = true;
                 m_verticalSyncBlocksRendering = false;
+                m_estimateVsyncFromSwaps = false;
                 m_renderLibrary = ""; ////< Unspecified, which is invalid.
 
                 m_windowTitle = "OSVR";
@@ -541,12 +623,22 @@ namespace renderkit {
 
                 m_renderOverfillFactor = 1.0f;
                 m_renderOversampleFactor = 1.0f;
+                m_distortionMeshType = SQUARE;
+                m_distortionMeshThreads = 1;
+                m_distortionMeshCacheMaxBytes = 64 * 1024 * 1024;
+                m_compactDistortionVertices = false;
+                m_distortionLookupTexture = false;
+                m_distortionLookupTextureDownsample = 1;
                 m_enableTimeWarp = true;
                 m_asynchronousTimeWarp = false;
                 m_maxMSBeforeVsyncTimeWarp = 0.0f;
 
                 m_clientPredictionEnabled = false;
                 m_clientPredictionLocalTimeOverride = false;
+                m_clientPredictionEstimateVelocity = false;
+
+                m_trackerIngestionThread = false;
+                m_trackerIngestionIntervalMS = 1.0f;
 
                 m_graphicsLibrary = GraphicsLibrary();
             }
@@ -577,6 +669,12 @@ namespace renderkit {
             bool m_verticalSync;   ///< Do we wait for Vsync to swap buffers?
             bool m_verticalSyncBlocksRendering; ///< Block rendering waiting for
             // sync?
+            /// When vertical sync is on and an OpenGL toolkit cannot report
+            /// retrace timing, wait for each frame's swaps to complete
+            /// (which stalls the presenting thread) and estimate it from
+            /// when they do?  The asynchronous time warp thread always
+            /// does, as it presents on a thread of its own.
+            bool m_estimateVsyncFromSwaps;
             std::string m_renderLibrary; ///< Which rendering library to use
 
             std::string m_windowTitle; ///< Title of any window we create
@@ -613,6 +711,51 @@ namespace renderkit {
             std::vector<DistortionParameters>
                 m_distortionParameters; ///< One set per eye x display
 
+            /// Type of distortion mesh to construct.  SQUARE (the
+            /// default) is a uniform grid; RADIAL is a polar mesh around
+            /// each eye's center of projection and ADAPTIVE a quadtree,
+            /// both using far fewer vertices for the same error,
+            /// concentrated where the distortion is strongly curved.
+            DistortionMeshType m_distortionMeshType;
+
+            /// How many threads to use when constructing distortion
+            /// meshes.  The eyes are built concurrently and each eye's
+            /// vertex grid is split into tiles across the threads; the
+            /// meshes are identical to those built serially.  1 (the
+            /// default) builds them on the calling thread and 0 uses one
+            /// thread per hardware thread.
+            unsigned m_distortionMeshThreads;
+
+            /// Directory in which to cache computed distortion meshes
+            /// between runs, which must already exist.  Empty (the default)
+            /// disables the cache.
+            std::string m_distortionMeshCacheDirectory;
+
+            /// Size cap on the files in the distortion mesh cache; the
+            /// least-recently used meshes are removed to stay under it.
+            uint64_t m_distortionMeshCacheMaxBytes;
+
+            /// Store the distortion mesh used by the OpenGL present pass in
+            /// a compact form: 16-bit normalized positions and texture
+            /// coordinates, less than half the size of the float vertices.
+            /// Where the context supports it, SQUARE meshes are drawn
+            /// without position or index buffers, with the positions
+            /// computed in the vertex shader from gl_VertexID.  Off by
+            /// default.
+            bool m_compactDistortionVertices;
+
+            /// Have the OpenGL present pass look up the distortion-corrected
+            /// texture coordinates for each pixel in a floating-point
+            /// texture, baked once when the distortion changes, rather than
+            /// interpolating them across a mesh.  Needs desktop OpenGL 3.0
+            /// or later; falls back to the mesh otherwise.  Off by default.
+            bool m_distortionLookupTexture;
+
+            /// How many eye pixels each texel of the distortion lookup
+            /// texture covers in each direction, with bilinear filtering in
+            /// between.  1 (the default) bakes one texel per pixel.
+            unsigned m_distortionLookupTextureDownsample;
+
             bool m_enableTimeWarp;       ///< Use time warp?
             bool m_justInTimeWarp;       ///< Use just-in-timewarp?
                                          ///(requires enable)
@@ -629,8 +772,24 @@ namespace renderkit {
             /// Static Delay + Delay from present to eye start
             std::vector<float> m_eyeDelaysMS;
             bool m_clientPredictionLocalTimeOverride;  ///< Override tracker timestamp?
-
-            std::shared_ptr<OSVRDisplayConfiguration>
+            /// Where a tracker reports no velocity, predict from the change
+            /// between its last two reports?  That amplifies tracker noise.
+            bool m_clientPredictionEstimateVelocity;
+
+            /// Update the tracker state on a thread of its own rather than
+            /// when rendering or presenting, which then only read the most
+            /// recent state.  Callbacks on our context are called on that
+            /// thread.
+            bool m_trackerIngestionThread;
+            /// How often that thread updates, in milliseconds.
+            float m_trackerIngestionIntervalMS;
+
+            /// File to write a trace of the rendering and presentation
+            /// stages of every thread to, for viewing in chrome://tracing
+            /// or the Perfetto UI.  Empty (the default) disables tracing.
+            std::string m_traceFile;
+
+            std::shared_ptr<const OSVRDisplayConfiguration>
                 m_displayConfiguration; ///< Display configuration
 
             std::string m_roomFromHeadName; ///< Transform to use for head space
@@ -676,6 +835,39 @@ namespace renderkit {
                 distort ///< Distortion parameters
             );
 
+        //=============================================================
+        // Compute new distortion meshes on a worker thread while the old
+        // ones stay in use, and swap them in at the start of the next
+        // PresentRenderBuffers() (or Render()) after they are ready, so
+        // that a parameter change does not stall presentation.  The
+        // returned future becomes true once the new meshes are in use and
+        // false if they could not be built or were superseded: by a later
+        // call before they were swapped in, or by a call to
+        // UpdateDistortionMeshes().  Renderers that bake distortion lookup
+        // textures still bake them when the swap happens.
+        virtual OSVR_RENDERMANAGER_EXPORT std::shared_future<bool>
+        UpdateDistortionMeshesAsync(
+            DistortionMeshType type, ///< Type of mesh to produce
+            std::vector<DistortionParameters> const&
+                distort ///< Distortion parameters
+            );
+
+        //=============================================================
+        // Update the distortion meshes when only the parameters of some
+        // eyes have changed since the last update, as when a lens is being
+        // calibrated interactively.  Only the meshes for those eyes are
+        // recomputed, and where the renderer supports it the existing
+        // graphics buffers are refilled in place instead of being
+        // destroyed and re-created.  Falls back to UpdateDistortionMeshes()
+        // when the mesh type or the number of eyes has changed.
+        virtual OSVR_RENDERMANAGER_EXPORT bool UpdateDistortionMeshesForEyes(
+            DistortionMeshType type, ///< Type of mesh to produce
+            std::vector<DistortionParameters> const&
+                distort, ///< Distortion parameters for all eyes
+            std::vector<size_t> const&
+                eyes ///< Eyes whose parameters have changed
+            );
+
         //=============================================================
         // Updates the internal "room to world" transformation (applied to all
         // tracker data for this client context instance) based on the user's
@@ -744,6 +936,16 @@ namespace renderkit {
                 distort ///< Distortion parameters
             ) = 0;
 
+        /// Renderers that can update the meshes of some eyes in place
+        /// override this; the default rebuilds all of them.
+        virtual bool OSVR_RENDERMANAGER_EXPORT
+        UpdateDistortionMeshesForEyesInternal(
+            DistortionMeshType type,
+            std::vector<DistortionParameters> const& distort,
+            std::vector<size_t> const& /*eyes*/) {
+            return UpdateDistortionMeshesInternal(type, distort);
+        }
+
         std::vector<RenderInfo>
             m_latchedRenderInfo; ///< Stores vector of latched RenderInfo
         virtual size_t OSVR_RENDERMANAGER_EXPORT
@@ -866,6 +1068,53 @@ namespace renderkit {
         double timePresentDisplayFinalize = 0;
         double timePresentFrameFinalize = 0;
 
+        /// The above and more, kept for each recent frame.  Asynchronous
+        /// time warp wrappers share theirs with the RenderManager they
+        /// harness, which is the one that records into it.
+        std::shared_ptr<FrameTimingHistory> m_frameTimings;
+
+        /// Set by asynchronous time warp wrappers before handing a frame
+        /// to their harnessed RenderManager, to the number of times they
+        /// have already handed it the same images.
+        unsigned m_atwRepresentCount = 0;
+
+        /// Timestamp of the head pose read by the latest
+        /// GetRenderInfo(), (0,0) if none has been read.
+        OSVR_TimeValue m_renderInfoPoseTime = {0, 0};
+
+        /// When presentation of the previous frame started.
+        OSVR_TimeValue m_lastPresentStart = {0, 0};
+
+        /// Trace being written if m_params.m_traceFile is set, shared with
+        /// any other RenderManager writing to the same file; else null.
+        std::shared_ptr<PipelineTrace> m_trace;
+
+        /// Call osvrClientUpdate() on our context, tracing the call.  When
+        /// there is a tracker ingestion thread, this instead takes its most
+        /// recent snapshot, which all reads of tracker state use until the
+        /// next call.
+        /// @return False if the update failed.
+        bool clientUpdate();
+
+        /// Updates our context if m_params.m_trackerIngestionThread is set;
+        /// null otherwise.
+        std::unique_ptr<TrackerIngestionThread> m_trackerIngestion;
+        /// Tracker state taken by the last clientUpdate() when there is an
+        /// ingestion thread.
+        std::unique_ptr<TrackerSnapshot> m_trackerSnapshot;
+
+        /// Lock out the tracker ingestion thread, if there is one, so that
+        /// m_context can be used directly while the lock is held.
+        std::unique_lock<std::mutex> lockContext();
+
+        /// Latest pose of @p iface, from the tracker snapshot if there is
+        /// an ingestion thread or from the interface otherwise.
+        bool getTrackerPose(OSVR_ClientInterface iface, OSVR_TimeValue& tv,
+                            OSVR_PoseState& pose) const;
+        /// Latest velocity of @p iface, as for getTrackerPose().
+        bool getTrackerVelocity(OSVR_ClientInterface iface, OSVR_TimeValue& tv,
+                                OSVR_VelocityState& velocity) const;
+
         /// NOTE: The base-class implementation constructs a texture matrix
         /// that is apropriate for use in OpenGL or D3D (it checks internally
         /// for the type and produces the appropriate warps.
@@ -1190,6 +1439,114 @@ namespace renderkit {
         /// Logger to use for writing information, warning, and errors.
         util::log::LoggerPtr m_log;
 
+        /// On-disk cache of distortion meshes, if enabled.
+        std::unique_ptr<DistortionMeshCache> m_distortionMeshCache;
+
+        /// Write the distortion mesh cache counters to the log, if the
+        /// cache is enabled.
+        void logDistortionMeshCacheStatistics();
+
+        /// Paces the wait for maxMsBeforeVsync in PresentRenderBuffers.
+        VsyncWaitScheduler m_vsyncWait;
+
+        /// Fill in m_distortionMeshSourceEye: each eye whose distortion is
+        /// the mirror image of that of an earlier eye on the same display
+        /// (see DistortionParametersAreMirrored()) is pointed at that eye.
+        /// The assignment is logged when it changes.
+        void assignDistortionMeshSourceEyes(
+            std::vector<DistortionParameters> const& distort);
+
+        /// Compute the distortion meshes for all eyes.  Meshes for eyes
+        /// that assignDistortionMeshSourceEyes() finds to be mirror images
+        /// are not computed and are left empty, to be drawn by mirroring
+        /// the earlier eye's mesh.
+        std::vector<DistortionMesh> computeDistortionMeshesForEyes(
+            DistortionMeshType type,
+            std::vector<DistortionParameters> const& distort);
+
+        /// For each eye, the eye whose distortion mesh is drawn for it.  An
+        /// eye other than itself means that the mesh is drawn mirrored left
+        /// to right.
+        std::vector<size_t> m_distortionMeshSourceEye;
+
+        /// Find, without changing any state, the eye whose mesh each eye
+        /// will draw, as assignDistortionMeshSourceEyes() records it.
+        std::vector<size_t> findDistortionMeshSourceEyes(
+            std::vector<DistortionParameters> const& distort);
+
+        /// Compute the meshes of the eyes that are their own source eye,
+        /// leaving the others empty.
+        std::vector<DistortionMesh> computeDistortionMeshesForSourceEyes(
+            DistortionMeshType type,
+            std::vector<DistortionParameters> const& distort,
+            std::vector<size_t> const& sourceEyes);
+
+        /// A set of meshes requested by UpdateDistortionMeshesAsync().
+        struct AsyncDistortionMeshUpdate {
+            DistortionMeshType type;
+            std::vector<DistortionParameters> distort;
+            std::vector<DistortionMesh> meshes; ///< Filled in by the worker
+            uint64_t generation = 0;
+            std::promise<bool> done;
+        };
+
+        /// Worker thread for UpdateDistortionMeshesAsync(), started by the
+        /// first call to it.  It takes requests from
+        /// m_asyncDistortionMeshRequest and leaves the results in
+        /// m_asyncDistortionMeshReady.
+        void asyncDistortionMeshWorker();
+
+        /// Swap in the meshes that the worker has finished, if any.  Called
+        /// with m_mutex held at the start of each presented frame.
+        void applyAsyncDistortionMeshes();
+
+        /// Fail any requested or computed meshes that have not been
+        /// swapped in yet, including one the worker is busy computing.
+        void cancelAsyncDistortionMeshes();
+
+        std::thread m_asyncDistortionMeshThread;
+        std::mutex m_asyncDistortionMeshMutex; ///< Guards the members below
+        std::condition_variable m_asyncDistortionMeshCondition;
+        bool m_asyncDistortionMeshQuit = false;
+        uint64_t m_asyncDistortionMeshGeneration = 0; ///< Of the last request
+        uint64_t m_asyncDistortionMeshCancelled = 0;  ///< Fail requests up to
+        std::shared_ptr<AsyncDistortionMeshUpdate> m_asyncDistortionMeshRequest;
+        std::shared_ptr<AsyncDistortionMeshUpdate> m_asyncDistortionMeshReady;
+
+        /// Meshes being swapped in, which computeDistortionMeshesForEyes()
+        /// returns instead of computing them again.  Only set during
+        /// applyAsyncDistortionMeshes().
+        std::shared_ptr<AsyncDistortionMeshUpdate> m_asyncDistortionMeshApplying;
+
+        /// Startup phase times, recorded when made by createRenderManager().
+        bool m_startupTimed = false;
+        bool m_startupReported = false; ///< Written to the log yet?
+        StartupTimings m_startupTimings;
+        std::chrono::steady_clock::time_point m_startupBegin;
+
+        /// Meshes computed by startDistortionMeshesEarly().
+        struct EarlyDistortionMeshes {
+            std::vector<DistortionMesh> meshes;
+            double computeMS = 0;
+        };
+
+        /// Start computing the meshes for m_params on a worker thread, so
+        /// that the OpenDisplay() call that needs them does not have to
+        /// compute them itself while the window and shaders are set up.
+        /// Only for renderers that build their own meshes, rather than
+        /// forwarding to a harnessed one.
+        void startDistortionMeshesEarly();
+
+        /// The computation started by startDistortionMeshesEarly(), which
+        /// computeDistortionMeshesForEyes() takes over if it is asked for
+        /// the same meshes, and the source eyes it used.
+        std::future<EarlyDistortionMeshes> m_earlyDistortionMeshes;
+        std::vector<size_t> m_earlyDistortionMeshSourceEyes;
+
+        /// Complete the startup timings and log them, the first time that
+        /// a frame is presented.
+        void reportStartupTimings();
+
         bool hasHeadPose() const;
         bool getLastHeadPose(OSVR_TimeValue& tv, OSVR_Pose3& pose) const;
 		bool hasLeftViewpointPose() const;
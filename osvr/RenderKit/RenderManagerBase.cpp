@@ -27,12 +27,16 @@ Russ Taylor <russ@sensics.com>
 #include "RenderManagerBackends.h"
 #include "RenderManagerOpenGLVersion.h"
 #include "DistortionCorrectTextureCoordinate.h"
+#include "ComputeDistortionMesh.h"
 #include "DistortionParameters.h"
 #include "UnstructuredMeshInterpolator.h"
 #include "osvr_display_configuration.h"
 #include "DirectModeVendors.h"
 #include "CleanPNPIDString.h"
 #include "PoseStateCaching.h"
+#include "FrameTimingHistory.h"
+#include "PipelineTrace.h"
+#include "TrackerIngestionThread.h"
 
 #ifdef RM_USE_D3D11
 #include "RenderManagerD3D.h"
@@ -111,6 +115,7 @@ namespace renderkit {
 #include <memory>
 #include <map>
 #include <algorithm>
+#include <cmath>
 
 /// Abbreviated namespace.
 namespace ei = osvr::util::eigen_interop;
@@ -263,6 +268,16 @@ static void OSVR_from_q(OSVR_PoseState& pose, const q_xyz_quat_type& xform) {
     osvrQuatSetW(&pose.rotation, xform.quat[Q_W]);
 }
 
+/// @brief Static helper function to move a time forward by a non-negative
+/// number of seconds.
+static void addSecondsToTimeValue(OSVR_TimeValue& tv, double seconds) {
+    OSVR_TimeValue offset;
+    offset.seconds = static_cast<OSVR_TimeValue_Seconds>(seconds);
+    offset.microseconds = static_cast<OSVR_TimeValue_Microseconds>(
+        (seconds - offset.seconds) * 1e6);
+    osvrTimeValueSum(&tv, &offset);
+}
+
 namespace osvr {
 namespace renderkit {
 
@@ -287,6 +302,15 @@ namespace renderkit {
 		m_leftViewpointPoseCache.reset(new PoseStateCaching(m_context, "/me/viewpoint/left", p.m_clientPredictionLocalTimeOverride));
 		m_rightViewpointPoseCache.reset(new PoseStateCaching(m_context, "/me/viewpoint/right", p.m_clientPredictionLocalTimeOverride));
 
+        m_frameTimings = std::make_shared<FrameTimingHistory>();
+        if (!p.m_traceFile.empty()) {
+            m_trace = PipelineTrace::open(p.m_traceFile);
+            if (!m_trace) {
+                m_log->error() << "RenderManager::RenderManager(): Could not "
+                                  "create trace file " << p.m_traceFile;
+            }
+        }
+
         // Initialize all of the variables that don't have to be done in the
         // list above, so we don't get warnings about out-of-order
         // initialization if they are re-ordered in the header file.
@@ -347,6 +371,35 @@ namespace renderkit {
 
         // We haven't yet registered our render buffers, so can't present them
         m_renderBuffersRegistered = false;
+
+        // Keep computed distortion meshes between runs if asked to.
+        if (!m_params.m_distortionMeshCacheDirectory.empty()) {
+            m_distortionMeshCache.reset(new DistortionMeshCache(
+                m_params.m_distortionMeshCacheDirectory,
+                m_params.m_distortionMeshCacheMaxBytes));
+        }
+
+        // Hand the updating of our context to a thread of its own if asked
+        // to, now that we are done setting up the interfaces it reads.
+        if (m_params.m_trackerIngestionThread) {
+            m_trackerSnapshot.reset(new TrackerSnapshot);
+            m_trackerIngestion.reset(new TrackerIngestionThread(
+                m_context, m_params.m_trackerIngestionIntervalMS / 1e3,
+                m_trace));
+            auto lock = m_trackerIngestion->lockContext();
+            m_trackerIngestion->addInterface(lock, m_roomFromHeadInterface,
+                                             m_headPoseCache.get());
+            if (m_roomFromLeftViewpointInterface) {
+                m_trackerIngestion->addInterface(
+                    lock, m_roomFromLeftViewpointInterface,
+                    m_leftViewpointPoseCache.get());
+            }
+            if (m_roomFromRightViewpointInterface) {
+                m_trackerIngestion->addInterface(
+                    lock, m_roomFromRightViewpointInterface,
+                    m_rightViewpointPoseCache.get());
+            }
+        }
     }
 
     bool RenderManager::SetDisplayCallback(DisplayCallback callback,
@@ -412,11 +465,14 @@ namespace renderkit {
         // If this is not world space, construct an interface
         // description so we can render objects here.
         if ((interfaceName.size() > 0) && (interfaceName != "/")) {
+            auto contextLock = lockContext();
             if (osvrClientGetInterface(m_context, interfaceName.c_str(),
                                        &cb.m_interface) ==
                 OSVR_RETURN_FAILURE) {
                 m_log->error() << "RenderManager::AddRenderCallback(): Can't get "
                                << "interface " << interfaceName;
+            } else if (m_trackerIngestion) {
+                m_trackerIngestion->addInterface(contextLock, cb.m_interface);
             }
         }
 
@@ -442,6 +498,11 @@ namespace renderkit {
             if ((interfaceName == ci.m_interfaceName) &&
                 (callback == ci.m_callback) && (userData == ci.m_userData)) {
                 if (ci.m_interface != nullptr) {
+                    auto contextLock = lockContext();
+                    if (m_trackerIngestion) {
+                        m_trackerIngestion->removeInterface(contextLock,
+                                                            ci.m_interface);
+                    }
                     if (osvrClientFreeInterface(m_context,
                                                 ci.m_interface) ==
                         OSVR_RETURN_FAILURE) {
@@ -464,6 +525,26 @@ namespace renderkit {
             m_log->flush();
         }
 
+        // Stop updating the context from the ingestion thread before we
+        // start tearing down what it reads.
+        m_trackerIngestion.reset();
+
+        // Let the early distortion meshes finish if they were never used,
+        // then stop the distortion mesh worker, failing anything it has
+        // not yet handed over.
+        if (m_earlyDistortionMeshes.valid()) {
+            m_earlyDistortionMeshes.wait();
+        }
+        cancelAsyncDistortionMeshes();
+        {
+            std::lock_guard<std::mutex> lock(m_asyncDistortionMeshMutex);
+            m_asyncDistortionMeshQuit = true;
+        }
+        m_asyncDistortionMeshCondition.notify_one();
+        if (m_asyncDistortionMeshThread.joinable()) {
+            m_asyncDistortionMeshThread.join();
+        }
+
         // Unregister any remaining callback handlers for devices that
         // are set to update our transformation matrices.
         while (m_callbacks.size() > 0) {
@@ -487,6 +568,7 @@ namespace renderkit {
         // All public methods that use internal state should be guarded
         // by a mutex.
         std::lock_guard<std::mutex> lock(m_mutex);
+        PipelineTrace::Scope trace(m_trace.get(), "Render");
 
         // Make sure we're doing okay.
         if (!doingOkay()) {
@@ -505,7 +587,7 @@ namespace renderkit {
 
         // Update the transformations so that we have the most-recent
         // state in them.
-        if (osvrClientUpdate(m_context) == OSVR_RETURN_FAILURE) {
+        if (!clientUpdate()) {
             m_log->error() << "RenderManager::Render(): client context update failed.";
             return false;
         }
@@ -515,8 +597,11 @@ namespace renderkit {
         m_renderInfoForRender = GetRenderInfoInternal(params);
 
         // Initialize the rendering for the whole frame.
-        if (!RenderFrameInitialize()) {
-            return false;
+        {
+            PipelineTrace::Scope stage(m_trace.get(), "RenderFrameInitialize");
+            if (!RenderFrameInitialize()) {
+                return false;
+            }
         }
 
         // One of the RenderDisplayInitialize() or RenderEyeInitialize()
@@ -526,9 +611,12 @@ namespace renderkit {
         // effectively its own display.
         for (size_t display = 0; display < GetNumDisplays(); display++) {
 
-            if (!RenderDisplayInitialize(display)) {
-                m_log->error() << "RenderManager::Render(): Could not initialize display " << display;
-                return false;
+            {
+                PipelineTrace::Scope stage(m_trace.get(), "RenderDisplayInitialize");
+                if (!RenderDisplayInitialize(display)) {
+                    m_log->error() << "RenderManager::Render(): Could not initialize display " << display;
+                    return false;
+                }
             }
 
             // Render for each eye, setting up the appropriate projection matrix
@@ -548,9 +636,14 @@ namespace renderkit {
                 // as well.
                 // Every eye is on its own display now, so we need to
                 // initialize and finalize the displays as well.
-                if (!RenderEyeInitialize(eye)) {
-                    m_log->error() << "RenderManager::Render(): Could not initialize eye.";
-                    return false;
+                PipelineTrace::Scope eyeTrace(m_trace.get(), "RenderEye");
+                eyeTrace.arg("eye", static_cast<double>(eye));
+                {
+                    PipelineTrace::Scope stage(m_trace.get(), "RenderEyeInitialize");
+                    if (!RenderEyeInitialize(eye)) {
+                        m_log->error() << "RenderManager::Render(): Could not initialize eye.";
+                        return false;
+                    }
                 }
                 if (m_viewCallback.m_callback != nullptr) {
                     m_viewCallback.m_callback(
@@ -582,6 +675,8 @@ namespace renderkit {
                     if (!ConstructModelView(i, eye, params, pose)) {
                         continue;
                     }
+                    PipelineTrace::Scope stage(m_trace.get(), "RenderSpace");
+                    stage.arg("space", static_cast<double>(i));
                     if (!RenderSpace(i, eye, pose,
                                      m_renderInfoForRender[eye].viewport,
                                      m_renderInfoForRender[eye].projection)) {
@@ -590,12 +685,14 @@ namespace renderkit {
                 }
 
                 // Done with this eye.
+                PipelineTrace::Scope stage(m_trace.get(), "RenderEyeFinalize");
                 if (!RenderEyeFinalize(eye)) {
                     m_log->error() << "RenderManager::Render(): Could not finalize eye.";
                     return false;
                 }
             }
 
+            PipelineTrace::Scope stage(m_trace.get(), "RenderDisplayFinalize");
             if (!RenderDisplayFinalize(display)) {
                 m_log->error() << "RenderManager::Render(): Could not finalize display " << display;
                 return false;
@@ -603,8 +700,11 @@ namespace renderkit {
         }
 
         // Finalize the rendering for the whole frame.
-        if (!RenderFrameFinalize()) {
-            return false;
+        {
+            PipelineTrace::Scope stage(m_trace.get(), "RenderFrameFinalize");
+            if (!RenderFrameFinalize()) {
+                return false;
+            }
         }
 
         // Keep track of the timing information.
@@ -640,6 +740,8 @@ namespace renderkit {
 
     std::vector<RenderInfo>
     RenderManager::GetRenderInfoInternal(const RenderParams& params) {
+        PipelineTrace::Scope trace(m_trace.get(), "GetRenderInfo");
+
         // Start with an empty vector, which will be returned as such on
         // failure.
         std::vector<RenderInfo> ret;
@@ -653,7 +755,7 @@ namespace renderkit {
 
         // Update the transformations so that we have the most-recent
         // state in them.
-        if (osvrClientUpdate(m_context) == OSVR_RETURN_FAILURE) {
+        if (!clientUpdate()) {
             m_log->error() << "RenderManager::GetRenderInfo(): client context "
                               "update failed.";
             ret.clear();
@@ -701,9 +803,57 @@ namespace renderkit {
             ret.push_back(info);
         }
 
+        trace.timeArg("poseTime", m_renderInfoPoseTime);
         return ret;
     }
 
+    bool RenderManager::clientUpdate() {
+        if (m_trackerIngestion) {
+            PipelineTrace::Scope trace(m_trace.get(), "LatchTrackerSnapshot");
+            return m_trackerIngestion->latch(*m_trackerSnapshot);
+        }
+        PipelineTrace::Scope trace(m_trace.get(), "osvrClientUpdate");
+        return osvrClientUpdate(m_context) != OSVR_RETURN_FAILURE;
+    }
+
+    std::unique_lock<std::mutex> RenderManager::lockContext() {
+        if (!m_trackerIngestion) {
+            return std::unique_lock<std::mutex>();
+        }
+        return m_trackerIngestion->lockContext();
+    }
+
+    bool RenderManager::getTrackerPose(OSVR_ClientInterface iface,
+                                       OSVR_TimeValue& tv,
+                                       OSVR_PoseState& pose) const {
+        if (m_trackerIngestion) {
+            auto state = m_trackerSnapshot->find(iface);
+            if (!state || !state->poseValid) {
+                return false;
+            }
+            tv = state->poseTime;
+            pose = state->pose;
+            return true;
+        }
+        return osvrGetPoseState(iface, &tv, &pose) == OSVR_RETURN_SUCCESS;
+    }
+
+    bool RenderManager::getTrackerVelocity(OSVR_ClientInterface iface,
+                                           OSVR_TimeValue& tv,
+                                           OSVR_VelocityState& velocity) const {
+        if (m_trackerIngestion) {
+            auto state = m_trackerSnapshot->find(iface);
+            if (!state || !state->velocityValid) {
+                return false;
+            }
+            tv = state->velocityTime;
+            velocity = state->velocity;
+            return true;
+        }
+        return osvrGetVelocityState(iface, &tv, &velocity) ==
+               OSVR_RETURN_SUCCESS;
+    }
+
     bool RenderManager::RegisterRenderBuffers(
         const std::vector<RenderBuffer>& buffers,
         bool appWillNotOverwriteBeforeNewPresent) {
@@ -758,6 +908,13 @@ namespace renderkit {
         timePresentFrameFinalize = 0;
 
         vrpn_gettimeofday(&allStart, nullptr);
+        OSVR_FrameTimingRecord frameTiming = {};
+        osvrTimeValueGetNow(&frameTiming.presentStart);
+        frameTiming.poseTime = m_renderInfoPoseTime;
+        frameTiming.atwRepresentCount = m_atwRepresentCount;
+        PipelineTrace::Scope trace(m_trace.get(), "PresentRenderBuffers");
+        trace.arg("frameNumber", static_cast<double>(m_frameTimings->size()));
+        trace.arg("atwRepresentCount", m_atwRepresentCount);
 
         // Make sure we're doing okay.
         if (!doingOkay()) {
@@ -772,12 +929,19 @@ namespace renderkit {
             return false;
         }
 
+        // Swap in any distortion meshes that have been computed in the
+        // background, between frames.
+        applyAsyncDistortionMeshes();
+
         // Initialize the presentation for the whole frame.
         vrpn_gettimeofday(&start, nullptr);
-        if (!PresentFrameInitialize()) {
-            m_log->error() << "RenderManager::PresentRenderBuffers(): "
-                              "PresentFrameInitialize() failed.";
-            return false;
+        {
+            PipelineTrace::Scope stage(m_trace.get(), "PresentFrameInitialize");
+            if (!PresentFrameInitialize()) {
+                m_log->error() << "RenderManager::PresentRenderBuffers(): "
+                                  "PresentFrameInitialize() failed.";
+                return false;
+            }
         }
         vrpn_gettimeofday(&stop, nullptr);
         timePresentFrameInitialize += vrpn_TimevalDurationSeconds(stop, start);
@@ -791,6 +955,7 @@ namespace renderkit {
         vrpn_gettimeofday(&start, nullptr);
         if (m_params.m_enableTimeWarp &&
             (m_params.m_maxMSBeforeVsyncTimeWarp > 0)) {
+            PipelineTrace::Scope stage(m_trace.get(), "WaitForSync");
             int count = 0;
 
             // Compute the threshold interval we need to be below.
@@ -802,6 +967,7 @@ namespace renderkit {
             threshold.microseconds =
                 static_cast<OSVR_TimeValue_Microseconds>(thresholdF * 1e6);
 
+            bool waiting = false;
             bool proceed;
             do {
                 // Go ahead unless something stops us.
@@ -809,7 +975,7 @@ namespace renderkit {
 
                 // Update the client context so we keep getting all required
                 // callbacks called during our busy-wait.
-                if (osvrClientUpdate(m_context) == OSVR_RETURN_FAILURE) {
+                if (!clientUpdate()) {
                     m_log->error() << "RenderManager::PresentRenderBuffers(): "
                                       "Client context update failed.";
                     return false;
@@ -828,21 +994,58 @@ namespace renderkit {
                                             &info.timeSincelastVerticalRetrace);
                     if (osvrTimeValueGreater(&nextRetrace, &threshold)) {
                         proceed = false;
+
+                        // Sleep through as much of the time still to go
+                        // as we can, rather than spinning for all of it.
+                        osvrTimeValueDifference(&nextRetrace, &threshold);
+                        double toGo = nextRetrace.seconds +
+                                      nextRetrace.microseconds / 1e6;
+                        if (!waiting) {
+                            m_vsyncWait.begin(toGo);
+                            waiting = true;
+                        }
+                        m_vsyncWait.pause(toGo);
                     }
                 }
 
                 ++count;
             } while (!proceed);
+            if (waiting) {
+                stage.arg("overshootMS", m_vsyncWait.end() * 1e3);
+            }
         }
         vrpn_gettimeofday(&stop, nullptr);
         timeWaitForSync += vrpn_TimevalDurationSeconds(stop, start);
 
+        // Find the vertical retrace that this frame is aimed at, which is
+        // the next one to start.
+        double displayInterval = 0;
+        OSVR_RenderTimingInfo vsyncInfo;
+        if (GetTimingInfo(0, vsyncInfo)) {
+            displayInterval = vsyncInfo.hardwareDisplayInterval.seconds +
+                vsyncInfo.hardwareDisplayInterval.microseconds / 1e6;
+            double sinceRetrace = vsyncInfo.timeSincelastVerticalRetrace.seconds +
+                vsyncInfo.timeSincelastVerticalRetrace.microseconds / 1e6;
+            if (displayInterval > 0) {
+                osvrTimeValueGetNow(&frameTiming.targetVsync);
+                addSecondsToTimeValue(frameTiming.targetVsync, displayInterval -
+                    std::fmod(std::max(sinceRetrace, 0.0), displayInterval));
+            }
+        }
+
         // Use the current and previous parameters to construct info
         // needed to perform Time Warp.
         std::vector<RenderInfo> currentRenderInfo =
             GetRenderInfoInternal(renderParams);
+        if (m_params.m_enableTimeWarp) {
+            // The images will be warped to the pose just read.
+            frameTiming.poseTime = m_renderInfoPoseTime;
+        }
+        trace.timeArg("poseTime", frameTiming.poseTime);
+        trace.timeArg("targetVsync", frameTiming.targetVsync);
         // @todo make the depth for time warp a parameter?
         if (m_params.m_enableTimeWarp) {
+            PipelineTrace::Scope stage(m_trace.get(), "ComputeAsynchronousTimeWarps");
             if (!ComputeAsynchronousTimeWarps(renderInfoUsed, currentRenderInfo,
                                               2.0f)) {
                 m_log->error() << "RenderManager::PresentRenderBuffers: "
@@ -867,10 +1070,13 @@ namespace renderkit {
 
             // Set up the appropriate display before setting up its eye(s).
             vrpn_gettimeofday(&start, nullptr);
-            if (!PresentDisplayInitialize(swappedDisplay)) {
-                m_log->error() << "RenderManager::PresentRenderBuffers(): "
-                                  "PresentDisplayInitialize() failed.";
-                return false;
+            {
+                PipelineTrace::Scope stage(m_trace.get(), "PresentDisplayInitialize");
+                if (!PresentDisplayInitialize(swappedDisplay)) {
+                    m_log->error() << "RenderManager::PresentRenderBuffers(): "
+                                      "PresentDisplayInitialize() failed.";
+                    return false;
+                }
             }
             vrpn_gettimeofday(&stop, nullptr);
             timePresentDisplayInitialize += vrpn_TimevalDurationSeconds(stop, start);
@@ -956,10 +1162,14 @@ namespace renderkit {
                 p.m_normalizedCroppingViewport = bufferCrop;
 
                 vrpn_gettimeofday(&start, nullptr);
-                if (!PresentEye(p)) {
-                    m_log->error() << "RenderManager::PresentRenderBuffers(): "
-                                      "PresentEye failed.";
-                    return false;
+                {
+                    PipelineTrace::Scope stage(m_trace.get(), "PresentEye");
+                    stage.arg("eye", static_cast<double>(eye));
+                    if (!PresentEye(p)) {
+                        m_log->error() << "RenderManager::PresentRenderBuffers(): "
+                                          "PresentEye failed.";
+                        return false;
+                    }
                 }
                 vrpn_gettimeofday(&stop, nullptr);
                 timePresentEye += vrpn_TimevalDurationSeconds(stop, start);
@@ -967,10 +1177,13 @@ namespace renderkit {
 
             // We're done with this display.
             vrpn_gettimeofday(&start, nullptr);
-            if (!PresentDisplayFinalize(swappedDisplay)) {
-                m_log->error() << "RenderManager::PresentRenderBuffers(): "
-                                  "PresentDisplayFinalize failed.";
-                return false;
+            {
+                PipelineTrace::Scope stage(m_trace.get(), "PresentDisplayFinalize");
+                if (!PresentDisplayFinalize(swappedDisplay)) {
+                    m_log->error() << "RenderManager::PresentRenderBuffers(): "
+                                      "PresentDisplayFinalize failed.";
+                    return false;
+                }
             }
             vrpn_gettimeofday(&stop, nullptr);
             timePresentDisplayFinalize += vrpn_TimevalDurationSeconds(stop, start);
@@ -978,20 +1191,48 @@ namespace renderkit {
 
         // Finalize the rendering for the whole frame.
         vrpn_gettimeofday(&start, nullptr);
-        if (!PresentFrameFinalize()) {
-            m_log->error() << "RenderManager::PresentRenderBuffers(): "
-                              "PresentFrameFinalize failed.";
-            return false;
+        {
+            PipelineTrace::Scope stage(m_trace.get(), "PresentFrameFinalize");
+            if (!PresentFrameFinalize()) {
+                m_log->error() << "RenderManager::PresentRenderBuffers(): "
+                                  "PresentFrameFinalize failed.";
+                return false;
+            }
         }
         vrpn_gettimeofday(&stop, nullptr);
         timePresentFrameFinalize += vrpn_TimevalDurationSeconds(stop, start);
 
-        // Keep track of the timing information.
-        /// @todo
-
         vrpn_gettimeofday(&allStop, nullptr);
         timePresentRenderBuffers = vrpn_TimevalDurationSeconds(allStop, allStart);
 
+        // Keep track of the timing information.
+        frameTiming.stageMS[OSVR_FRAME_TIMING_TOTAL] = timePresentRenderBuffers * 1e3;
+        frameTiming.stageMS[OSVR_FRAME_TIMING_FRAME_INITIALIZE] = timePresentFrameInitialize * 1e3;
+        frameTiming.stageMS[OSVR_FRAME_TIMING_WAIT_FOR_SYNC] = timeWaitForSync * 1e3;
+        frameTiming.stageMS[OSVR_FRAME_TIMING_DISPLAY_INITIALIZE] = timePresentDisplayInitialize * 1e3;
+        frameTiming.stageMS[OSVR_FRAME_TIMING_PRESENT_EYE] = timePresentEye * 1e3;
+        frameTiming.stageMS[OSVR_FRAME_TIMING_DISPLAY_FINALIZE] = timePresentDisplayFinalize * 1e3;
+        frameTiming.stageMS[OSVR_FRAME_TIMING_FRAME_FINALIZE] = timePresentFrameFinalize * 1e3;
+        if (displayInterval > 0) {
+            OSVR_TimeValue presentEnd;
+            osvrTimeValueGetNow(&presentEnd);
+            if (osvrTimeValueDurationSeconds(&presentEnd, &frameTiming.targetVsync) >
+                displayInterval / 2) {
+                frameTiming.flags |= OSVR_FRAME_TIMING_FLAG_LATE;
+            }
+            if (m_lastPresentStart.seconds != 0 &&
+                osvrTimeValueDurationSeconds(&frameTiming.presentStart, &m_lastPresentStart) >
+                displayInterval * 1.5) {
+                frameTiming.flags |= OSVR_FRAME_TIMING_FLAG_SKIPPED_VSYNC;
+            }
+        }
+        m_lastPresentStart = frameTiming.presentStart;
+        m_frameTimings->record(frameTiming);
+        trace.arg("flags", frameTiming.flags);
+
+        if (m_startupTimed && !m_startupReported) {
+            reportStartupTimings();
+        }
         return true;
     }
 
@@ -1061,6 +1302,9 @@ namespace renderkit {
         return false;
       }
 
+      if (m_startupTimed && !m_startupReported) {
+        reportStartupTimings();
+      }
       return true;
     }
 
@@ -1074,14 +1318,363 @@ namespace renderkit {
         // by a mutex.
         std::lock_guard<std::mutex> lock(m_mutex);
 
+        cancelAsyncDistortionMeshes();
         return UpdateDistortionMeshesInternal(type, distort);
     }
 
+    bool RenderManager::UpdateDistortionMeshesForEyes(
+        DistortionMeshType type //< Type of mesh to produce
+        ,
+        std::vector<DistortionParameters> const&
+            distort //< Distortion parameters
+        ,
+        std::vector<size_t> const& eyes //< Eyes that changed
+        ) {
+        // All public methods that use internal state should be guarded
+        // by a mutex.
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        cancelAsyncDistortionMeshes();
+        return UpdateDistortionMeshesForEyesInternal(type, distort, eyes);
+    }
+
+    bool RenderManager::GetDistortionMeshCacheStatistics(
+        DistortionMeshCache::Statistics& stats) {
+        // All public methods that use internal state should be guarded
+        // by a mutex.
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_distortionMeshCache) {
+            return false;
+        }
+        stats = m_distortionMeshCache->getStatistics();
+        return true;
+    }
+
+    bool RenderManager::GetVsyncWaitStatistics(
+        VsyncWaitScheduler::Statistics& stats) {
+        // All public methods that use internal state should be guarded
+        // by a mutex.
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        stats = m_vsyncWait.getStatistics();
+        return true;
+    }
+
+    bool RenderManager::GetStartupTimings(StartupTimings& timings) {
+        // All public methods that use internal state should be guarded
+        // by a mutex.
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_startupTimed) {
+            return false;
+        }
+        timings = m_startupTimings;
+        return true;
+    }
+
+    void RenderManager::GetFrameTimings(
+        std::vector<OSVR_FrameTimingRecord>& records) {
+        // No need to lock the mutex, which is held while a frame is being
+        // presented; the history can be read while it is being written.
+        m_frameTimings->snapshot(records);
+    }
+
+    bool RenderManager::GetFrameTimingPercentile(OSVR_FrameTimingStage stage,
+                                                 double percentile,
+                                                 double& ms) {
+        return m_frameTimings->percentile(stage, percentile, ms);
+    }
+
+    void RenderManager::reportStartupTimings() {
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - m_startupBegin;
+        m_startupTimings.firstPresentMS = elapsed.count();
+        m_startupReported = true;
+        m_log->info() << "Startup: waited "
+                      << m_startupTimings.waitForDisplayMS
+                      << " ms for the display, parsed configuration in "
+                      << m_startupTimings.parseConfigurationMS
+                      << " ms, created renderer in "
+                      << m_startupTimings.createRendererMS
+                      << " ms, computed distortion meshes in "
+                      << m_startupTimings.distortionMeshComputeMS
+                      << " ms (OpenDisplay waited "
+                      << m_startupTimings.distortionMeshWaitMS
+                      << " ms for them), first frame presented after "
+                      << m_startupTimings.firstPresentMS << " ms";
+    }
+
+    void RenderManager::logDistortionMeshCacheStatistics() {
+        if (!m_distortionMeshCache || !m_log) {
+            return;
+        }
+        // Meshes may be updated many times a second while a lens is being
+        // calibrated, so keep this out of the normal log.
+        DistortionMeshCache::Statistics stats =
+            m_distortionMeshCache->getStatistics();
+        m_log->debug() << "Distortion mesh cache: " << stats.hits
+                       << " hits, " << stats.misses << " misses, "
+                       << stats.stores << " stores, " << stats.evictions
+                       << " evictions, " << stats.secondsSaved * 1e3
+                       << " ms saved";
+    }
+
+    std::vector<size_t> RenderManager::findDistortionMeshSourceEyes(
+        std::vector<DistortionParameters> const& distort) {
+        size_t const numEyes = std::min(GetNumEyes(), distort.size());
+
+        // Meshes are computed for a list of eyes and the position in the
+        // list is taken as the eye, which only polynomial distortion
+        // ignores; so only drop eyes from the list when all of them are
+        // polynomial.
+        std::vector<size_t> ret(numEyes);
+        bool allPolynomial = true;
+        for (size_t eye = 0; eye < numEyes; eye++) {
+            ret[eye] = eye;
+            allPolynomial = allPolynomial &&
+                distort[eye].m_type ==
+                    DistortionParameters::rgb_symmetric_polynomials;
+        }
+        for (size_t eye = 0; eye < numEyes; eye++) {
+            for (size_t other = 0; allPolynomial && other < eye; other++) {
+                if (ret[other] == other &&
+                    GetDisplayUsedByEye(other) == GetDisplayUsedByEye(eye) &&
+                    DistortionParametersAreMirrored(distort[other],
+                                                    distort[eye])) {
+                    ret[eye] = other;
+                    break;
+                }
+            }
+        }
+        return ret;
+    }
+
+    void RenderManager::assignDistortionMeshSourceEyes(
+        std::vector<DistortionParameters> const& distort) {
+        std::vector<size_t> const previous = m_distortionMeshSourceEye;
+        m_distortionMeshSourceEye = findDistortionMeshSourceEyes(distort);
+
+        // Meshes may be updated many times a second while a lens is being
+        // calibrated, so only report the assignment when it changes.
+        if (m_distortionMeshSourceEye == previous || !m_log) {
+            return;
+        }
+        size_t const numEyes = m_distortionMeshSourceEye.size();
+        size_t numUnique = 0;
+        for (size_t eye = 0; eye < numEyes; eye++) {
+            if (m_distortionMeshSourceEye[eye] == eye) {
+                numUnique++;
+            } else {
+                m_log->info() << "Distortion mesh for eye " << eye
+                              << " is the mirror image of the one for eye "
+                              << m_distortionMeshSourceEye[eye];
+            }
+        }
+        if (numUnique == numEyes && numEyes > 1) {
+            m_log->info() << "Eye distortions are not mirror images of each "
+                             "other; computing a distortion mesh per eye";
+        }
+    }
+
+    std::vector<DistortionMesh>
+    RenderManager::computeDistortionMeshesForSourceEyes(
+        DistortionMeshType type,
+        std::vector<DistortionParameters> const& distort,
+        std::vector<size_t> const& sourceEyes) {
+        size_t const numEyes = sourceEyes.size();
+        std::vector<DistortionParameters> unique;
+        std::vector<size_t> uniqueEyes;
+        for (size_t eye = 0; eye < numEyes; eye++) {
+            if (sourceEyes[eye] == eye) {
+                unique.push_back(distort[eye]);
+                uniqueEyes.push_back(eye);
+            }
+        }
+        PipelineTrace::Scope trace(m_trace.get(), "ComputeDistortionMeshes");
+        trace.arg("eyes", static_cast<double>(unique.size()));
+
+        std::vector<DistortionMesh> computed = ComputeDistortionMeshes(
+            type, unique, m_params.m_renderOverfillFactor,
+            m_params.m_distortionMeshThreads, m_distortionMeshCache.get());
+        logDistortionMeshCacheStatistics();
+
+        std::vector<DistortionMesh> ret(numEyes);
+        for (size_t i = 0; i < uniqueEyes.size(); i++) {
+            ret[uniqueEyes[i]] = std::move(computed[i]);
+        }
+        return ret;
+    }
+
+    std::vector<DistortionMesh> RenderManager::computeDistortionMeshesForEyes(
+        DistortionMeshType type,
+        std::vector<DistortionParameters> const& distort) {
+        assignDistortionMeshSourceEyes(distort);
+
+        // Meshes being swapped in from the worker thread were computed
+        // with the same source eyes.
+        if (m_asyncDistortionMeshApplying &&
+            m_asyncDistortionMeshApplying->type == type &&
+            m_asyncDistortionMeshApplying->meshes.size() ==
+                m_distortionMeshSourceEye.size()) {
+            return std::move(m_asyncDistortionMeshApplying->meshes);
+        }
+
+        // So may the meshes started when we were created, if this is the
+        // request for our own parameters that they anticipated.
+        if (m_earlyDistortionMeshes.valid() &&
+            type == m_params.m_distortionMeshType &&
+            &distort == &m_params.m_distortionParameters &&
+            m_distortionMeshSourceEye == m_earlyDistortionMeshSourceEyes) {
+            auto waitStart = std::chrono::steady_clock::now();
+            EarlyDistortionMeshes early = m_earlyDistortionMeshes.get();
+            std::chrono::duration<double, std::milli> waited =
+                std::chrono::steady_clock::now() - waitStart;
+            m_startupTimings.distortionMeshWaitMS = waited.count();
+            m_startupTimings.distortionMeshComputeMS = early.computeMS;
+            if (early.meshes.size() == m_distortionMeshSourceEye.size()) {
+                return std::move(early.meshes);
+            }
+        }
+        return computeDistortionMeshesForSourceEyes(type, distort,
+                                                    m_distortionMeshSourceEye);
+    }
+
+    void RenderManager::startDistortionMeshesEarly() {
+        if (m_params.m_distortionParameters.empty()) {
+            return;
+        }
+        m_earlyDistortionMeshSourceEyes =
+            findDistortionMeshSourceEyes(m_params.m_distortionParameters);
+        DistortionMeshType const type = m_params.m_distortionMeshType;
+        std::vector<DistortionParameters> const distort =
+            m_params.m_distortionParameters;
+        std::vector<size_t> const sourceEyes = m_earlyDistortionMeshSourceEyes;
+        m_earlyDistortionMeshes = std::async(std::launch::async, [=] {
+            auto start = std::chrono::steady_clock::now();
+            EarlyDistortionMeshes ret;
+            ret.meshes =
+                computeDistortionMeshesForSourceEyes(type, distort, sourceEyes);
+            std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::steady_clock::now() - start;
+            ret.computeMS = elapsed.count();
+            return ret;
+        });
+    }
+
+    std::shared_future<bool> RenderManager::UpdateDistortionMeshesAsync(
+        DistortionMeshType type //< Type of mesh to produce
+        ,
+        std::vector<DistortionParameters> const&
+            distort //< Distortion parameters
+        ) {
+        auto request = std::make_shared<AsyncDistortionMeshUpdate>();
+        request->type = type;
+        request->distort = distort;
+        std::shared_future<bool> ret = request->done.get_future().share();
+
+        std::lock_guard<std::mutex> lock(m_asyncDistortionMeshMutex);
+        request->generation = ++m_asyncDistortionMeshGeneration;
+        if (m_asyncDistortionMeshRequest) {
+            m_asyncDistortionMeshRequest->done.set_value(false);
+        }
+        m_asyncDistortionMeshRequest = request;
+        if (!m_asyncDistortionMeshThread.joinable()) {
+            m_asyncDistortionMeshThread =
+                std::thread(&RenderManager::asyncDistortionMeshWorker, this);
+        }
+        m_asyncDistortionMeshCondition.notify_one();
+        return ret;
+    }
+
+    void RenderManager::asyncDistortionMeshWorker() {
+        std::unique_lock<std::mutex> lock(m_asyncDistortionMeshMutex);
+        while (true) {
+            m_asyncDistortionMeshCondition.wait(lock, [&] {
+                return m_asyncDistortionMeshQuit ||
+                       m_asyncDistortionMeshRequest;
+            });
+            if (m_asyncDistortionMeshQuit) {
+                return;
+            }
+            std::shared_ptr<AsyncDistortionMeshUpdate> request =
+                std::move(m_asyncDistortionMeshRequest);
+            m_asyncDistortionMeshRequest.reset();
+
+            // Compute without holding the lock, so that new requests and
+            // the present thread never wait for us.
+            lock.unlock();
+            std::vector<size_t> const sourceEyes =
+                findDistortionMeshSourceEyes(request->distort);
+            request->meshes = computeDistortionMeshesForSourceEyes(
+                request->type, request->distort, sourceEyes);
+            bool ok = !sourceEyes.empty();
+            for (size_t eye = 0; eye < sourceEyes.size(); eye++) {
+                if (sourceEyes[eye] == eye &&
+                    request->meshes[eye].vertices.empty()) {
+                    m_log->error() << "RenderManager::"
+                                      "UpdateDistortionMeshesAsync: Could "
+                                      "not create mesh for eye "
+                                   << eye;
+                    ok = false;
+                }
+            }
+            lock.lock();
+
+            // Drop results that have failed or been cancelled while we
+            // were computing them.
+            if (!ok || m_asyncDistortionMeshQuit ||
+                request->generation <= m_asyncDistortionMeshCancelled) {
+                request->done.set_value(false);
+                continue;
+            }
+            if (m_asyncDistortionMeshReady) {
+                m_asyncDistortionMeshReady->done.set_value(false);
+            }
+            m_asyncDistortionMeshReady = std::move(request);
+        }
+    }
+
+    void RenderManager::applyAsyncDistortionMeshes() {
+        {
+            std::lock_guard<std::mutex> lock(m_asyncDistortionMeshMutex);
+            m_asyncDistortionMeshApplying =
+                std::move(m_asyncDistortionMeshReady);
+            m_asyncDistortionMeshReady.reset();
+        }
+        if (!m_asyncDistortionMeshApplying) {
+            return;
+        }
+        bool ok = UpdateDistortionMeshesInternal(
+            m_asyncDistortionMeshApplying->type,
+            m_asyncDistortionMeshApplying->distort);
+        if (!ok) {
+            m_log->error() << "RenderManager::applyAsyncDistortionMeshes: "
+                              "Could not swap in new distortion meshes";
+        }
+        m_asyncDistortionMeshApplying->done.set_value(ok);
+        m_asyncDistortionMeshApplying.reset();
+    }
+
+    void RenderManager::cancelAsyncDistortionMeshes() {
+        std::lock_guard<std::mutex> lock(m_asyncDistortionMeshMutex);
+        m_asyncDistortionMeshCancelled = m_asyncDistortionMeshGeneration;
+        if (m_asyncDistortionMeshRequest) {
+            m_asyncDistortionMeshRequest->done.set_value(false);
+            m_asyncDistortionMeshRequest.reset();
+        }
+        if (m_asyncDistortionMeshReady) {
+            m_asyncDistortionMeshReady->done.set_value(false);
+            m_asyncDistortionMeshReady.reset();
+        }
+    }
+
     void RenderManager::SetRoomRotationUsingHead() {
         // All public methods that use internal state should be guarded
         // by a mutex.
         std::lock_guard<std::mutex> lock(m_mutex);
 
+        auto contextLock = lockContext();
         osvrClientSetRoomRotationUsingHead(m_context);
     }
 
@@ -1090,6 +1683,7 @@ namespace renderkit {
         // by a mutex.
         std::lock_guard<std::mutex> lock(m_mutex);
 
+        auto contextLock = lockContext();
         osvrClientClearRoomToWorldTransform(m_context);
     }
 
@@ -1538,9 +2132,11 @@ namespace renderkit {
 				/// DO NOT update the client here, so that we're using the
 				/// same state for all eyes.
 				OSVR_TimeValue timestamp;
-				if (!m_headPoseCache || !m_headPoseCache->getLastReport(timestamp, m_roomFromHead)) {
+				if (!getLastHeadPose(timestamp, m_roomFromHead)) {
 					// This it not an error -- they may have put in an invalid
 					// state name for the head; we just ignore that case.
+				} else {
+					m_renderInfoPoseTime = timestamp;
 				}
 
 				// Do prediction of where this eye will be when it is presented
@@ -1575,25 +2171,36 @@ namespace renderkit {
 					}
 					float predictionIntervalSec = predictionIntervalms / 1e3f;
 
-					// Find out the pose velocity information, if available.
-					// Set the valid flags to false so that if to call to get
-					// velocity fails, we will not try and use the info.
-					OSVR_VelocityState vel;
-					vel.linearVelocityValid = false;
-					vel.angularVelocityValid = false;
-					if (osvrGetVelocityState(m_roomFromHeadInterface, &timestamp, &vel) != OSVR_RETURN_SUCCESS) {
-						// We're okay with failure here, we just use a zero
-						// velocity to predict.
-						// Using normal get state calls here because we're effectively
-						// throwing away the returned timestamp for this data.
-					}
+					// Without a tracker ingestion thread, the pose cache holds
+					// the recent reports and can find the pose at the time it
+					// will be presented, using the velocity where one was
+					// reported (and, if configured, the change between reports
+					// otherwise).
+					OSVR_TimeValue presentTime = timestamp;
+					addSecondsToTimeValue(presentTime, predictionIntervalSec);
+					if (m_trackerIngestion || !m_headPoseCache ||
+						!m_headPoseCache->getPoseAt(presentTime, m_roomFromHead,
+							m_params.m_clientPredictionEstimateVelocity)) {
+						// Find out the pose velocity information, if available.
+						// Set the valid flags to false so that if to call to get
+						// velocity fails, we will not try and use the info.
+						OSVR_VelocityState vel;
+						vel.linearVelocityValid = false;
+						vel.angularVelocityValid = false;
+						if (!getTrackerVelocity(m_roomFromHeadInterface, timestamp, vel)) {
+							// We're okay with failure here, we just use a zero
+							// velocity to predict.
+							// Using normal get state calls here because we're effectively
+							// throwing away the returned timestamp for this data.
+						}
 
-					// Predict the future pose of the head based on the velocity
-					// information and how long we should predict.  Check the
-					// linear and angular velocity terms to see if we should be
-					// using each.  Replace the pose with the predicted pose.
-					PredictFuturePose(m_roomFromHead, vel,
-						predictionIntervalSec, m_roomFromHead);
+						// Predict the future pose of the head based on the velocity
+						// information and how long we should predict.  Check the
+						// linear and angular velocity terms to see if we should be
+						// using each.  Replace the pose with the predicted pose.
+						PredictFuturePose(m_roomFromHead, vel,
+							predictionIntervalSec, m_roomFromHead);
+					}
 				}
 
 				// Bring the pose into quatlib world.
@@ -1639,9 +2246,9 @@ namespace renderkit {
 			}
 			else {
 				OSVR_TimeValue timestamp;
-				if (osvrGetPoseState(
-					m_callbacks[whichSpace].m_interface, &timestamp,
-					&m_callbacks[whichSpace].m_state) == OSVR_RETURN_FAILURE) {
+				if (!getTrackerPose(
+					m_callbacks[whichSpace].m_interface, timestamp,
+					m_callbacks[whichSpace].m_state)) {
 					// They asked for a space that does not exist.  Return false to
 					// let them know we didn't get the one they wanted.
 					return false;
@@ -1671,7 +2278,7 @@ namespace renderkit {
 					/// DO NOT update the client here, so that we're using the
 					/// same state for all eyes.
 					OSVR_TimeValue timestamp;
-					if (!m_leftViewpointPoseCache || !m_leftViewpointPoseCache->getLastReport(timestamp, m_roomFromLeftViewpoint)) {
+					if (!getLastLeftViewpointPose(timestamp, m_roomFromLeftViewpoint)) {
 						// This it not an error -- they may have put in an invalid
 						// state name for the left eye; we just ignore that case.
 					}
@@ -1708,25 +2315,36 @@ namespace renderkit {
 						}
 						float predictionIntervalSec = predictionIntervalms / 1e3f;
 
-						// Find out the pose velocity information, if available.
-						// Set the valid flags to false so that if to call to get
-						// velocity fails, we will not try and use the info.
-						OSVR_VelocityState vel;
-						vel.linearVelocityValid = false;
-						vel.angularVelocityValid = false;
-						if (osvrGetVelocityState(m_roomFromLeftViewpointInterface, &timestamp, &vel) != OSVR_RETURN_SUCCESS) {
-							// We're okay with failure here, we just use a zero
-							// velocity to predict.
-							// Using normal get state calls here because we're effectively
-							// throwing away the returned timestamp for this data.
+						// Without a tracker ingestion thread, the pose cache holds
+						// the recent reports and can find the pose at the time it
+						// will be presented, using the velocity where one was
+						// reported (and, if configured, the change between reports
+						// otherwise).
+						OSVR_TimeValue presentTime = timestamp;
+						addSecondsToTimeValue(presentTime, predictionIntervalSec);
+						if (m_trackerIngestion || !m_leftViewpointPoseCache ||
+							!m_leftViewpointPoseCache->getPoseAt(presentTime, m_roomFromLeftViewpoint,
+								m_params.m_clientPredictionEstimateVelocity)) {
+							// Find out the pose velocity information, if available.
+							// Set the valid flags to false so that if to call to get
+							// velocity fails, we will not try and use the info.
+							OSVR_VelocityState vel;
+							vel.linearVelocityValid = false;
+							vel.angularVelocityValid = false;
+							if (!getTrackerVelocity(m_roomFromLeftViewpointInterface, timestamp, vel)) {
+								// We're okay with failure here, we just use a zero
+								// velocity to predict.
+								// Using normal get state calls here because we're effectively
+								// throwing away the returned timestamp for this data.
+							}
+
+							// Predict the future pose of the head based on the velocity
+							// information and how long we should predict.  Check the
+							// linear and angular velocity terms to see if we should be
+							// using each.  Replace the pose with the predicted pose.
+							PredictFuturePose(m_roomFromLeftViewpoint, vel,
+								predictionIntervalSec, m_roomFromLeftViewpoint);
 						}
-
-						// Predict the future pose of the head based on the velocity
-						// information and how long we should predict.  Check the
-						// linear and angular velocity terms to see if we should be
-						// using each.  Replace the pose with the predicted pose.
-						PredictFuturePose(m_roomFromLeftViewpoint, vel,
-							predictionIntervalSec, m_roomFromLeftViewpoint);
 					}
 
 					// Bring the pose into quatlib world.
@@ -1747,7 +2365,7 @@ namespace renderkit {
 					/// DO NOT update the client here, so that we're using the
 					/// same state for all eyes.
 					OSVR_TimeValue timestamp;
-					if (!m_rightViewpointPoseCache || !m_rightViewpointPoseCache->getLastReport(timestamp, m_roomFromRightViewpoint)) {
+					if (!getLastRightViewpointPose(timestamp, m_roomFromRightViewpoint)) {
 						// This it not an error -- they may have put in an invalid
 						// state name for the right eye; we just ignore that case.
 					}
@@ -1784,25 +2402,36 @@ namespace renderkit {
 						}
 						float predictionIntervalSec = predictionIntervalms / 1e3f;
 
-						// Find out the pose velocity information, if available.
-						// Set the valid flags to false so that if to call to get
-						// velocity fails, we will not try and use the info.
-						OSVR_VelocityState vel;
-						vel.linearVelocityValid = false;
-						vel.angularVelocityValid = false;
-						if (osvrGetVelocityState(m_roomFromRightViewpointInterface, &timestamp, &vel) != OSVR_RETURN_SUCCESS) {
-							// We're okay with failure here, we just use a zero
-							// velocity to predict.
-							// Using normal get state calls here because we're effectively
-							// throwing away the returned timestamp for this data.
+						// Without a tracker ingestion thread, the pose cache holds
+						// the recent reports and can find the pose at the time it
+						// will be presented, using the velocity where one was
+						// reported (and, if configured, the change between reports
+						// otherwise).
+						OSVR_TimeValue presentTime = timestamp;
+						addSecondsToTimeValue(presentTime, predictionIntervalSec);
+						if (m_trackerIngestion || !m_rightViewpointPoseCache ||
+							!m_rightViewpointPoseCache->getPoseAt(presentTime, m_roomFromRightViewpoint,
+								m_params.m_clientPredictionEstimateVelocity)) {
+							// Find out the pose velocity information, if available.
+							// Set the valid flags to false so that if to call to get
+							// velocity fails, we will not try and use the info.
+							OSVR_VelocityState vel;
+							vel.linearVelocityValid = false;
+							vel.angularVelocityValid = false;
+							if (!getTrackerVelocity(m_roomFromRightViewpointInterface, timestamp, vel)) {
+								// We're okay with failure here, we just use a zero
+								// velocity to predict.
+								// Using normal get state calls here because we're effectively
+								// throwing away the returned timestamp for this data.
+							}
+
+							// Predict the future pose of the head based on the velocity
+							// information and how long we should predict.  Check the
+							// linear and angular velocity terms to see if we should be
+							// using each.  Replace the pose with the predicted pose.
+							PredictFuturePose(m_roomFromRightViewpoint, vel,
+								predictionIntervalSec, m_roomFromRightViewpoint);
 						}
-
-						// Predict the future pose of the head based on the velocity
-						// information and how long we should predict.  Check the
-						// linear and angular velocity terms to see if we should be
-						// using each.  Replace the pose with the predicted pose.
-						PredictFuturePose(m_roomFromRightViewpoint, vel,
-							predictionIntervalSec, m_roomFromRightViewpoint);
 					}
 
 					// Bring the pose into quatlib world.
@@ -1848,9 +2477,9 @@ namespace renderkit {
 			}
 			else {
 				OSVR_TimeValue timestamp;
-				if (osvrGetPoseState(
-					m_callbacks[whichSpace].m_interface, &timestamp,
-					&m_callbacks[whichSpace].m_state) == OSVR_RETURN_FAILURE) {
+				if (!getTrackerPose(
+					m_callbacks[whichSpace].m_interface, timestamp,
+					m_callbacks[whichSpace].m_state)) {
 					// They asked for a space that does not exist.  Return false to
 					// let them know we didn't get the one they wanted.
 					return false;
@@ -2046,7 +2675,7 @@ namespace renderkit {
       OSVR_VelocityState vel;
       vel.linearVelocityValid = false;
       vel.angularVelocityValid = false;
-      if (osvrGetVelocityState(m_roomFromHeadInterface, &timestamp, &vel) != OSVR_RETURN_SUCCESS) {
+      if (!getTrackerVelocity(m_roomFromHeadInterface, timestamp, vel)) {
         // No velocity information available, so we return the do-nothing result.
         return ret;
       }
@@ -2062,13 +2691,14 @@ namespace renderkit {
       // passed in as RenderParam because all of our differential transform
       // work here takes place below it.
       OSVR_PoseState pose;
-      if (osvrGetPoseState(m_roomFromHeadInterface, &timestamp, &pose) != OSVR_RETURN_SUCCESS) {
+      if (!getTrackerPose(m_roomFromHeadInterface, timestamp, pose)) {
         // No pose information available, so we return the do-nothing result.
         return ret;
       }
       osvr::common::Transform xform(ei::map(pose).matrix(),
         ei::map(pose).matrix().inverse());
-      xform.transform(m_context->getRoomToWorldTransform());
+      xform.transform(m_trackerIngestion ? m_trackerSnapshot->roomToWorld
+                                         : m_context->getRoomToWorldTransform());
       Eigen::Quaterniond localRot = xform.transformDerivative(
         ei::map(vel.angularVelocity.incrementalRotation));
 
@@ -2217,14 +2847,20 @@ namespace renderkit {
         return true;
     }
 
+    // With a tracker ingestion thread, the pose caches are written by
+    // that thread, so we read what it copied out of them into the
+    // snapshot instead.
+
     bool RenderManager::hasHeadPose() const {
-        if (!m_headPoseCache) {
-            return false;
-        }
-        return m_headPoseCache->hasReport();
+        OSVR_TimeValue tv;
+        OSVR_Pose3 pose;
+        return getLastHeadPose(tv, pose);
     }
 
     bool RenderManager::getLastHeadPose(OSVR_TimeValue& tv, OSVR_Pose3& pose) const {
+        if (m_trackerIngestion) {
+            return getTrackerPose(m_roomFromHeadInterface, tv, pose);
+        }
         if (!m_headPoseCache) {
             return false;
         }
@@ -2232,20 +2868,21 @@ namespace renderkit {
     }
 
 	bool RenderManager::hasLeftViewpointPose() const {
-		if (!m_leftViewpointPoseCache) {
-			return false;
-		}
-		return m_leftViewpointPoseCache->hasReport();
+		OSVR_TimeValue tv;
+		OSVR_Pose3 pose;
+		return getLastLeftViewpointPose(tv, pose);
 	}
 
 	bool RenderManager::hasRightViewpointPose() const {
-		if (!m_rightViewpointPoseCache) {
-			return false;
-		}
-		return m_rightViewpointPoseCache->hasReport();
+		OSVR_TimeValue tv;
+		OSVR_Pose3 pose;
+		return getLastRightViewpointPose(tv, pose);
 	}
 
 	bool RenderManager::getLastLeftViewpointPose(OSVR_TimeValue& tv, OSVR_Pose3& pose) const {
+		if (m_trackerIngestion) {
+			return getTrackerPose(m_roomFromLeftViewpointInterface, tv, pose);
+		}
 		if (!m_leftViewpointPoseCache) {
 			return false;
 		}
@@ -2253,6 +2890,9 @@ namespace renderkit {
 	}
 
 	bool RenderManager::getLastRightViewpointPose(OSVR_TimeValue& tv, OSVR_Pose3& pose) const {
+		if (m_trackerIngestion) {
+			return getTrackerPose(m_roomFromRightViewpointInterface, tv, pose);
+		}
 		if (!m_rightViewpointPoseCache) {
 			return false;
 		}
@@ -2430,24 +3070,42 @@ namespace renderkit {
         // display device.
         // @todo Verify that waiting for the display is sufficient to be
         // sure we'll get the RenderManager string.
+        // The client library has no notification for this, so we poll:
+        // quickly at first, so that we notice the display soon after the
+        // server reports it, backing off if it takes a while.
+        typedef std::chrono::steady_clock StartupClock;
+        auto msSince = [](StartupClock::time_point begin) {
+            std::chrono::duration<double, std::milli> elapsed =
+                StartupClock::now() - begin;
+            return elapsed.count();
+        };
+        RenderManager::StartupTimings timings;
+        StartupClock::time_point const startupBegin = StartupClock::now();
         OSVR_ReturnCode displayReturnCode;
         OSVR_DisplayConfig display;
         std::chrono::time_point<std::chrono::system_clock> start, end;
         start = std::chrono::system_clock::now();
+        std::chrono::milliseconds pollDelay(1);
+        std::chrono::milliseconds const maxPollDelay(32);
         do {
           osvrClientUpdate(contextParameter);
           displayReturnCode = osvrClientGetDisplay(contextParameter, &display);
+          if (displayReturnCode == OSVR_RETURN_FAILURE) {
             end = std::chrono::system_clock::now();
             std::chrono::duration<double> elapsed = end - start;
             if (elapsed.count() >= 1) {
                 m_log->error() << "Waiting to get Display from server...";
                 start = end;
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            std::this_thread::sleep_for(pollDelay);
+            pollDelay = std::min(pollDelay * 2, maxPollDelay);
+          }
         } while (displayReturnCode == OSVR_RETURN_FAILURE);
         m_log->info() << "Got Display info from server "
                      "(ignore earlier errors that occured while we were "
                      "waiting to connect)";
+        timings.waitForDisplayMS = msSince(startupBegin);
+        StartupClock::time_point const parseBegin = StartupClock::now();
 
         // Check the information in the display and pipeline configuration to determine
         // what kind of renderer to instantiate.  Also fill in the parameters
@@ -2455,19 +3113,25 @@ namespace renderkit {
         RenderManager::ConstructorParameters p;
         p.m_graphicsLibrary = graphicsLibrary;
 
-        std::string jsonString;
+        // The display descriptor may hold large distortion tables, so parse
+        // it on a worker while we read the pipeline configuration.
+        std::future<std::shared_ptr<const OSVRDisplayConfiguration> >
+            displayConfiguration;
         try {
           std::string jsonString =
             osvrRenderManagerGetString(contextParameter, "/display");
-          p.m_displayConfiguration.reset(new OSVRDisplayConfiguration(jsonString));
+          displayConfiguration = std::async(std::launch::async, [jsonString] {
+              return OSVRDisplayConfiguration::getShared(jsonString);
+          });
         }
         catch (std::exception& /*e*/) {
-          m_log->error() << "Could not parse /display string "
+          m_log->error() << "Could not get /display string "
             "from server.";
           return nullptr;
         }
 
         osvr::client::RenderManagerConfigPtr pipelineConfig;
+        std::string configString;
         try {
             // @todo
             // this should be a temporary workaround to an issue with
@@ -2475,7 +3139,7 @@ namespace renderkit {
             // C++ cross-dll boundary issue, and making it
             // a header-only lib might fix it, but we're moving the code here
             // for now.
-          std::string configString = osvrRenderManagerGetString(contextParameter,
+          configString = osvrRenderManagerGetString(contextParameter,
               "/renderManagerConfig");
             osvr::client::RenderManagerConfigPtr cfg(
                 new osvr::client::RenderManagerConfig(configString));
@@ -2496,6 +3160,14 @@ namespace renderkit {
                          "pipelineconfig).";
             return nullptr;
         }
+        try {
+          p.m_displayConfiguration = displayConfiguration.get();
+        }
+        catch (std::exception& /*e*/) {
+          m_log->error() << "Could not parse /display string "
+            "from server.";
+          return nullptr;
+        }
         p.m_directMode = pipelineConfig->getDirectMode();
         p.m_directDisplayIndex = pipelineConfig->getDisplayIndex();
         p.m_directHighPriority = pipelineConfig->getDirectHighPriority();
@@ -2551,6 +3223,91 @@ namespace renderkit {
         p.m_clientPredictionLocalTimeOverride =
           pipelineConfig->getclientPredictionLocalTimeOverride();
 
+        // Diagnostic settings that RenderManagerConfig does not know about
+        // are read from the same configuration here.
+        {
+            Json::Value root;
+            Json::Reader reader;
+            if (reader.parse(configString, root, false) && root.isObject()) {
+                Json::Value const& config = root["renderManagerConfig"];
+                if (config.isObject() && config["traceFile"].isString()) {
+                    p.m_traceFile = config["traceFile"].asString();
+                    m_log->info() << "Writing a trace of rendering to "
+                                  << p.m_traceFile;
+                }
+                if (config.isObject() && config["prediction"].isObject() &&
+                    config["prediction"]["estimateVelocity"].isBool()) {
+                    p.m_clientPredictionEstimateVelocity =
+                        config["prediction"]["estimateVelocity"].asBool();
+                }
+                if (config.isObject() &&
+                    config["estimateVsyncFromSwaps"].isBool()) {
+                    p.m_estimateVsyncFromSwaps =
+                        config["estimateVsyncFromSwaps"].asBool();
+                }
+                if (config.isObject() &&
+                    config["trackerIngestionThread"].isBool()) {
+                    p.m_trackerIngestionThread =
+                        config["trackerIngestionThread"].asBool();
+                }
+                if (config.isObject() &&
+                    config["trackerIngestionIntervalMS"].isNumeric() &&
+                    config["trackerIngestionIntervalMS"].asFloat() > 0) {
+                    p.m_trackerIngestionIntervalMS =
+                        config["trackerIngestionIntervalMS"].asFloat();
+                }
+                if (config.isObject() &&
+                    config["distortionMeshType"].isString()) {
+                    std::string const type =
+                        config["distortionMeshType"].asString();
+                    if (type == "square") {
+                        p.m_distortionMeshType = SQUARE;
+                    } else if (type == "radial") {
+                        p.m_distortionMeshType = RADIAL;
+                    } else if (type == "adaptive") {
+                        p.m_distortionMeshType = ADAPTIVE;
+                    } else {
+                        m_log->warn() << "Unrecognized distortionMeshType ("
+                                      << type << ") in rendermanager config "
+                                                 "file, using square";
+                    }
+                }
+                if (config.isObject() &&
+                    config["distortionMeshThreads"].isUInt()) {
+                    p.m_distortionMeshThreads =
+                        config["distortionMeshThreads"].asUInt();
+                }
+                if (config.isObject() &&
+                    config["distortionMeshCacheDirectory"].isString()) {
+                    p.m_distortionMeshCacheDirectory =
+                        config["distortionMeshCacheDirectory"].asString();
+                }
+                if (config.isObject() &&
+                    config["distortionMeshCacheMaxMB"].isNumeric() &&
+                    config["distortionMeshCacheMaxMB"].asDouble() > 0) {
+                    p.m_distortionMeshCacheMaxBytes = static_cast<uint64_t>(
+                        config["distortionMeshCacheMaxMB"].asDouble() * 1024 *
+                        1024);
+                }
+                if (config.isObject() &&
+                    config["compactDistortionVertices"].isBool()) {
+                    p.m_compactDistortionVertices =
+                        config["compactDistortionVertices"].asBool();
+                }
+                if (config.isObject() &&
+                    config["distortionLookupTexture"].isBool()) {
+                    p.m_distortionLookupTexture =
+                        config["distortionLookupTexture"].asBool();
+                }
+                if (config.isObject() &&
+                    config["distortionLookupTextureDownsample"].isUInt() &&
+                    config["distortionLookupTextureDownsample"].asUInt() > 0) {
+                    p.m_distortionLookupTextureDownsample =
+                        config["distortionLookupTextureDownsample"].asUInt();
+                }
+            }
+        }
+
         // Determine the appropriate display VendorIds based on the name of the
         // display device.  Don't push any back if we don't recognize the vendor
         // name.
@@ -2585,6 +3342,12 @@ namespace renderkit {
           DistortionParameters distortion(*p.m_displayConfiguration, i);
           p.m_distortionParameters.push_back(distortion);
         }
+        timings.parseConfigurationMS = msSince(parseBegin);
+        StartupClock::time_point const createBegin = StartupClock::now();
+
+        // Set for the renderers that build their own distortion meshes,
+        // rather than forwarding to a harnessed renderer.
+        bool buildsOwnDistortionMeshes = false;
 
         // @todo Read the info we need from Core.
 
@@ -2616,6 +3379,7 @@ namespace renderkit {
                         // get a pointer to a RenderManager that has access to the
                         // DirectMode display we want to use.
                         ret.reset(openRenderManagerDirectMode(contextParameter, p));
+                        buildsOwnDistortionMeshes = true;
                     }
                     if (ret == nullptr) {
                         m_log->error() << "Could not open the"
@@ -2623,6 +3387,7 @@ namespace renderkit {
                     }
                 } else {
                     ret.reset(new RenderManagerD3D11(contextParameter, p));
+                    buildsOwnDistortionMeshes = true;
                 }
   #ifdef RM_USE_SENSICS
             }
@@ -2677,9 +3442,11 @@ namespace renderkit {
                     ret.reset(new RenderManagerOpenGLATW(contextParameter, p));
                 } else {
                     ret.reset(new RenderManagerOpenGL(contextParameter, p));
+                    buildsOwnDistortionMeshes = true;
                 }
     #else
                 ret.reset(new RenderManagerOpenGL(contextParameter, p));
+                buildsOwnDistortionMeshes = true;
     #endif
 #else
                 m_log->error() << "OpenGL render library not compiled in";
@@ -2697,6 +3464,15 @@ namespace renderkit {
         if (!ret || !ret->doingOkay()) {
             return nullptr;
         }
+        timings.createRendererMS = msSince(createBegin);
+        ret->m_startupTimed = true;
+        ret->m_startupBegin = startupBegin;
+        ret->m_startupTimings = timings;
+
+        // Distortion lookup textures are computed in place of the meshes.
+        if (buildsOwnDistortionMeshes && !p.m_distortionLookupTexture) {
+            ret->startDistortionMeshesEarly();
+        }
 
         // Return the render manager.
         return ret.release();
@@ -39,6 +39,7 @@
 /* none */
 
 // Standard includes
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -66,6 +67,40 @@ osvrRenderManagerGetDoingOkay(OSVR_RenderManager renderManager) {
     return rm->doingOkay() ? OSVR_RETURN_SUCCESS : OSVR_RETURN_FAILURE;
 }
 
+OSVR_ReturnCode
+osvrRenderManagerGetFrameTimings(OSVR_RenderManager renderManager,
+                                 OSVR_FrameTimingRecord* recordsOut,
+                                 size_t maxCount, size_t* countOut) {
+    if (!countOut) {
+        return OSVR_RETURN_FAILURE;
+    }
+    auto rm = reinterpret_cast<osvr::renderkit::RenderManager*>(renderManager);
+    std::vector<OSVR_FrameTimingRecord> records;
+    rm->GetFrameTimings(records);
+    if (!recordsOut) {
+        *countOut = records.size();
+        return OSVR_RETURN_SUCCESS;
+    }
+    // Hand back the most recent ones if there is not room for them all.
+    size_t count = std::min(maxCount, records.size());
+    std::copy(records.end() - count, records.end(), recordsOut);
+    *countOut = count;
+    return OSVR_RETURN_SUCCESS;
+}
+
+OSVR_ReturnCode
+osvrRenderManagerGetFrameTimingPercentile(OSVR_RenderManager renderManager,
+                                          OSVR_FrameTimingStage stage,
+                                          double percentile, double* msOut) {
+    if (!msOut) {
+        return OSVR_RETURN_FAILURE;
+    }
+    auto rm = reinterpret_cast<osvr::renderkit::RenderManager*>(renderManager);
+    return rm->GetFrameTimingPercentile(stage, percentile, *msOut)
+               ? OSVR_RETURN_SUCCESS
+               : OSVR_RETURN_FAILURE;
+}
+
 OSVR_ReturnCode
 osvrRenderManagerGetDefaultRenderParams(OSVR_RenderParams* renderParamsOut) {
     auto& _renderParamsOut = *renderParamsOut;
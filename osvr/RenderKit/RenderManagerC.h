@@ -115,6 +115,58 @@ typedef struct OSVR_RenderTimingInfo {
     OSVR_TimeValue timeUntilNextPresentRequired;
 } OSVR_RenderTimingInfo;
 
+/// @brief Stages of presenting a frame, as timed in OSVR_FrameTimingRecord
+typedef enum {
+    OSVR_FRAME_TIMING_TOTAL,              //< All of the presentation
+    OSVR_FRAME_TIMING_FRAME_INITIALIZE,   //< PresentFrameInitialize()
+    OSVR_FRAME_TIMING_WAIT_FOR_SYNC,      //< Waiting to be near vsync
+    OSVR_FRAME_TIMING_DISPLAY_INITIALIZE, //< PresentDisplayInitialize()
+    OSVR_FRAME_TIMING_PRESENT_EYE,        //< PresentEye(), all eyes
+    OSVR_FRAME_TIMING_DISPLAY_FINALIZE,   //< PresentDisplayFinalize()
+    OSVR_FRAME_TIMING_FRAME_FINALIZE,     //< PresentFrameFinalize()
+    OSVR_FRAME_TIMING_STAGE_COUNT
+} OSVR_FrameTimingStage;
+
+/// Set in OSVR_FrameTimingRecord::flags when presentation finished more
+/// than half a refresh interval after the vertical retrace it was aimed at.
+#define OSVR_FRAME_TIMING_FLAG_LATE 0x1
+/// Set in OSVR_FrameTimingRecord::flags when presentation started more
+/// than one and a half refresh intervals after that of the previous frame,
+/// so that at least one retrace went by without a new frame.
+#define OSVR_FRAME_TIMING_FLAG_SKIPPED_VSYNC 0x2
+
+/// @brief Timing of one presented frame
+///
+/// Times that a particular RenderManager cannot determine have the value
+/// (0,0).  When asynchronous time warp is in use, a record is made each
+/// time the time-warp thread presents, whether or not the application has
+/// provided a new frame since the last one.
+typedef struct OSVR_FrameTimingRecord {
+    /// Counts up from 0 with each frame presented.
+    uint64_t frameNumber;
+
+    /// When presentation of the frame started.
+    OSVR_TimeValue presentStart;
+
+    /// Timestamp of the head pose that the presented images were rendered
+    /// or time-warped to.
+    OSVR_TimeValue poseTime;
+
+    /// The vertical retrace that the frame was aimed at.
+    OSVR_TimeValue targetVsync;
+
+    /// Milliseconds spent in each stage, indexed by OSVR_FrameTimingStage.
+    double stageMS[OSVR_FRAME_TIMING_STAGE_COUNT];
+
+    /// OSVR_FRAME_TIMING_FLAG_* values.
+    uint32_t flags;
+
+    /// How many times asynchronous time warp had already presented the
+    /// application's images before this frame; 0 for a new frame and when
+    /// time warp is not in use.
+    uint32_t atwRepresentCount;
+} OSVR_FrameTimingRecord;
+
 OSVR_RENDERMANAGER_EXPORT OSVR_ReturnCode
 osvrDestroyRenderManager(OSVR_RenderManager renderManager);
 
@@ -138,6 +190,26 @@ osvrRenderManagerGetDoingOkay(OSVR_RenderManager renderManager);
 OSVR_RENDERMANAGER_EXPORT OSVR_ReturnCode
 osvrRenderManagerGetDefaultRenderParams(OSVR_RenderParams* renderParamsOut);
 
+/// Copies the timing records of the most recently presented frames, oldest
+/// first.  RenderManager keeps a fixed number of them, overwriting the
+/// oldest; this call does not block or slow down presentation.
+/// @param recordsOut Array of maxCount records to fill in, or NULL to
+///        find out how many records are available.
+/// @param countOut Number of records copied (or available).
+OSVR_RENDERMANAGER_EXPORT OSVR_ReturnCode
+osvrRenderManagerGetFrameTimings(OSVR_RenderManager renderManager,
+                                 OSVR_FrameTimingRecord* recordsOut,
+                                 size_t maxCount, size_t* countOut);
+
+/// Finds a percentile (for example 50 or 99) of the time taken by a stage
+/// of presentation, over the frames whose timing records are kept.
+/// @return OSVR_RETURN_FAILURE if no frames have been presented or the
+///         stage or percentile is out of range.
+OSVR_RENDERMANAGER_EXPORT OSVR_ReturnCode
+osvrRenderManagerGetFrameTimingPercentile(OSVR_RenderManager renderManager,
+                                          OSVR_FrameTimingStage stage,
+                                          double percentile, double* msOut);
+
 /// This function is used to bracket the start of the presentation of render
 /// buffers for a single frame.  Between this function and the associated
 /// Finish call below, graphics-library-specific Present calls should be made
@@ -31,6 +31,7 @@ Sensics, Inc.
 #include "RenderManagerD3DBase.h"
 #include "RenderManagerOpenGL.h"
 #include "GraphicsLibraryD3D11.h"
+#include "PipelineTrace.h"
 
 #include <vector>
 #include <string>
@@ -76,6 +77,7 @@ namespace osvr {
             bool mQuit = false;
             bool mStarted = false;
             bool mFirstFramePresented = false;
+            unsigned mNextFramePresentCount = 0; ///< Times mNextFrameInfo was presented
 
           public:
             /**
@@ -87,6 +89,9 @@ namespace osvr {
                                   RenderManagerD3D11Base* D3DToHarness)
                 : RenderManagerD3D11Base(context, p) {
                 mRenderManager.reset(D3DToHarness);
+                // The harnessed RenderManager does the presenting, so it
+                // records the frame timings that our clients read.
+                mRenderManager->m_frameTimings = m_frameTimings;
             }
 
             virtual ~RenderManagerD3D11ATW() {
@@ -250,6 +255,7 @@ namespace osvr {
                   mNextFrameInfo.renderParams = renderParams;
                   mNextFrameInfo.normalizedCroppingViewports = normalizedCroppingViewports;
                   mFirstFramePresented = true;
+                  mNextFramePresentCount = 0;
                 }
                 return true;
             }
@@ -289,6 +295,9 @@ namespace osvr {
                 struct timeval lastFrameTime = {};
                 bool quit = getQuit();
                 size_t iteration = 0;
+                if (m_trace) {
+                    m_trace->nameThread("ATW");
+                }
                 while (!quit) {
 
                     // Wait until it is time to present the render buffers.
@@ -338,10 +347,13 @@ namespace osvr {
                         // being presented.
                         std::lock_guard<std::mutex> lock(mLock);
                         if (mFirstFramePresented) {
+                            PipelineTrace::Scope trace(m_trace.get(), "ATWIteration");
+                            trace.arg("iteration", static_cast<double>(iteration));
+
                             // Update the context so we get our callbacks called and
                             // update tracker state, which will be read during the
                             // time-warp calculation in our harnessed RenderManager.
-                            osvrClientUpdate(mRenderManager->m_context);
+                            mRenderManager->clientUpdate();
 
                             // make a new RenderBuffers array with the atw thread's buffers
                             std::vector<osvr::renderkit::RenderBuffer> atwRenderBuffers;
@@ -361,6 +373,7 @@ namespace osvr {
                             // Send the rendered results to the screen, using the
                             // RenderInfo that was handed to us by the client the last
                             // time they gave us some images.
+                            mRenderManager->m_atwRepresentCount = mNextFramePresentCount++;
                             if (!mRenderManager->PresentRenderBuffers(
                                 atwRenderBuffers,
                                 mNextFrameInfo.renderInfo,
@@ -443,6 +456,16 @@ namespace osvr {
                     distort);
             }
 
+            /// The swap has to happen on the time-warp thread, which
+            /// presents through the harnessed RenderManager.
+            OSVR_RENDERMANAGER_EXPORT std::shared_future<bool>
+            UpdateDistortionMeshesAsync(
+                DistortionMeshType type,
+                std::vector<DistortionParameters> const& distort) override {
+                return mRenderManager->UpdateDistortionMeshesAsync(type,
+                    distort);
+            }
+
             bool RegisterRenderBuffersInternal(
                 const std::vector<RenderBuffer>& buffers,
                 bool appWillNotOverwriteBeforeNewPresent = false) override {
@@ -648,7 +648,8 @@ namespace renderkit {
         }
 
         // Create distortion meshes for each of the eyes.
-        UpdateDistortionMeshesInternal(SQUARE, m_params.m_distortionParameters);
+        UpdateDistortionMeshesInternal(m_params.m_distortionMeshType,
+                                       m_params.m_distortionParameters);
 
         //==================================================================
         // Describe how depth and stencil tests should be performed
@@ -775,13 +776,20 @@ namespace renderkit {
         }
 
         //size_t numEyes = m_params.m_displayConfiguration.getEyes().size();
+        // Construct distortion meshes for all eyes using the RenderManager
+        // standard, which is an OpenGL-compatible mesh.
+        // Eyes that mirror another eye get no mesh of their own.
+        std::vector<DistortionMesh> meshes =
+            computeDistortionMeshesForEyes(type, distort);
+
         m_distortionMeshBuffer.resize(numEyes);
         for (size_t eye = 0; eye < numEyes; eye++) {
+            if (m_distortionMeshSourceEye[eye] != eye) {
+                continue;
+            }
             auto & meshBuffer = m_distortionMeshBuffer[eye];
 
-            // Construct a distortion mesh for this eye using the RenderManager
-            // standard, which is an OpenGL-compatible mesh.
-            DistortionMesh mesh = ComputeDistortionMesh(eye, type, distort[eye], m_params.m_renderOverfillFactor);
+            DistortionMesh const& mesh = meshes[eye];
             if (mesh.vertices.empty()) {
                 m_log->error() << "RenderManagerD3D11Base::UpdateDistortionMeshesInternal: Could not "
                                   "create mesh "
@@ -818,6 +826,7 @@ namespace renderkit {
 
             // Copy the index data
             meshBuffer.indices = mesh.indices;
+            meshBuffer.topology = mesh.topology;
 
             // Create the D3D resource for the vertex buffer
             {
@@ -1127,9 +1136,6 @@ namespace renderkit {
                                  static_cast<float>(viewportDesc.height));
         m_D3D11Context->RSSetViewports(1, &viewport);
 
-        // Set primitive topology
-        m_D3D11Context->IASetPrimitiveTopology(
-            D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
         m_D3D11Context->IASetInputLayout(m_vertexLayout);
 
         m_D3D11Context->VSSetShader(m_vertexShader.Get(), nullptr, 0);
@@ -1148,6 +1154,14 @@ namespace renderkit {
                                0,       0, 1, 0, 0, 0,       0, 1};
         DirectX::XMMATRIX projection(scaleProj);
 
+        // Eyes whose distortion mirrors that of another eye draw that eye's
+        // mesh flipped left to right.
+        size_t const meshEye =
+            params.m_index < m_distortionMeshSourceEye.size()
+                ? m_distortionMeshSourceEye[params.m_index]
+                : params.m_index;
+        bool const mirrored = meshEye != params.m_index;
+
         // Set up a ModelView matrix that handles rotating and flipping the
         // geometry as needed to match the display scan-out circuitry and/or
         // any changes needed by the inversion of window coordinates when
@@ -1163,6 +1177,9 @@ namespace renderkit {
                               "ComputeDisplayOrientationMatrix failed";
             return false;
         }
+        if (mirrored) {
+            Eigen::Map<Eigen::Matrix4f>(modelViewMat.data).col(0) *= -1;
+        }
         DirectX::XMMATRIX modelView(modelViewMat.data);
 
         // Set up the texture matrix to handle asynchronous time warp.
@@ -1195,6 +1212,17 @@ namespace renderkit {
         Eigen::Map<Eigen::Matrix4f> textureEi(textureMat);
         textureEi = textureEi * Eigen::Matrix4f::Map(crop.data).transpose();
 
+        // Mirrored meshes have their texture coordinates flipped left to
+        // right, about the middle of the texture, before the rest.  The
+        // shader multiplies the coordinates as row vectors, so this goes on
+        // the left.
+        if (mirrored) {
+            Eigen::Matrix4f mirror = Eigen::Matrix4f::Identity();
+            mirror(0, 0) = -1;
+            mirror(0, 3) = 1;
+            textureEi = mirror.transpose() * textureEi;
+        }
+
         DirectX::XMMATRIX texture(textureMat);
         cbPerObject wvp = {projection, modelView, texture};
         m_D3D11Context->UpdateSubresource(m_cbPerObjectBuffer.Get(), 0, nullptr,
@@ -1204,7 +1232,7 @@ namespace renderkit {
 
         //====================================================================
         // Which distortion mesh to use
-        auto const & meshBuffer = m_distortionMeshBuffer[params.m_index];
+        auto const & meshBuffer = m_distortionMeshBuffer[meshEye];
 
         //====================================================================
         // Set vertex buffer
@@ -1219,6 +1247,12 @@ namespace renderkit {
         m_D3D11Context->IASetIndexBuffer(meshBuffer.indexBuffer.Get(),
             DXGI_FORMAT_R16_UINT, 0);
 
+        // Set primitive topology
+        m_D3D11Context->IASetPrimitiveTopology(
+            meshBuffer.topology == TRIANGLE_LIST
+                ? D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST
+                : D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+
         //====================================================================
         // Create the shader resource view.
         // @todo move into the registration code rather than PresentEye
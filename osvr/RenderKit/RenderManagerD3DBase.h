@@ -155,6 +155,8 @@ namespace renderkit {
             Microsoft::WRL::ComPtr<ID3D11Buffer> indexBuffer;
             /// Backing data for indexBuffer
             std::vector<UINT16> indices;
+            /// How the indices form triangles
+            DistortionMeshTopology topology = TRIANGLE_STRIP;
         };
 
         /// @todo One per eye/display combination in case of multiple displays
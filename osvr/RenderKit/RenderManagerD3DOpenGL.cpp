@@ -48,6 +48,9 @@ namespace renderkit {
         // initialization if they are re-ordered in the header file.
         m_displayOpen = false;
         m_library.OpenGL = nullptr;
+        // The harnessed D3D renderer does the presenting and reports its
+        // own timing, so there is nothing for us to estimate.
+        m_estimateVsync = false;
 
         if (!m_D3D11Renderer) {
             m_log->error() << "RenderManagerD3D11OpenGL::RenderManagerD3D11OpenGL: "
@@ -41,9 +41,12 @@ Sensics, Inc.
 #include "RenderManagerOpenGL.h"
 #include "GraphicsLibraryOpenGL.h"
 #include "ComputeDistortionMesh.h"
+#include "PipelineTrace.h"
 #include <osvr/Util/Finally.h>
 #include <osvr/Util/Logger.h>
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 #include <Eigen/Core>
 #include <Eigen/Geometry>
 
@@ -343,6 +346,95 @@ static const GLchar* distortionFragmentShader =
 "    gl_FragColor.b = texture2D(tex, warpedCoordinateB).b;\n"
 "}\n";
 
+#ifndef OSVR_RM_USE_OPENGLES20
+// Shaders for SQUARE meshes drawn without position or index buffers when
+// compact distortion vertices are enabled.  Each column of quads is a strip
+// of 2 * gridQuads + 2 vertices that starts and ends with a repeated vertex,
+// so that the columns are joined by degenerate triangles; the position of
+// each vertex follows from its place in the strip.
+static const GLchar* gridDistortionVertexShader =
+"#version 130\n"
+"in vec2 textureCoordinateR;\n"
+"in vec2 textureCoordinateG;\n"
+"in vec2 textureCoordinateB;\n"
+"uniform mat4 projectionMatrix;\n"
+"uniform mat4 modelViewMatrix;\n"
+"uniform mat4 textureMatrix;\n"
+"uniform int gridQuads;\n"
+"out vec2 warpedCoordinateR;\n"
+"out vec2 warpedCoordinateG;\n"
+"out vec2 warpedCoordinateB;\n"
+"void main()\n"
+"{\n"
+"   int perColumn = 2 * gridQuads + 2;\n"
+"   int column = gl_VertexID / perColumn;\n"
+"   int i = clamp(gl_VertexID - column * perColumn - 1, 0,\n"
+"      2 * gridQuads - 1);\n"
+"   vec2 grid = vec2(float(column + i % 2), float(i / 2));\n"
+"   vec4 position = vec4(grid * (2.0 / float(gridQuads)) - 1.0, 0, 1);\n"
+"   gl_Position = projectionMatrix * modelViewMatrix * position;\n"
+"   warpedCoordinateR = vec2(textureMatrix * "
+"      vec4(textureCoordinateR,0,1));\n"
+"   warpedCoordinateG = vec2(textureMatrix * "
+"      vec4(textureCoordinateG,0,1));\n"
+"   warpedCoordinateB = vec2(textureMatrix * "
+"      vec4(textureCoordinateB,0,1));\n"
+"}\n";
+
+static const GLchar* gridDistortionFragmentShader =
+"#version 130\n"
+"uniform sampler2D tex;\n"
+"in vec2 warpedCoordinateR;\n"
+"in vec2 warpedCoordinateG;\n"
+"in vec2 warpedCoordinateB;\n"
+"void main()\n"
+"{\n"
+"    gl_FragColor.r = texture(tex, warpedCoordinateR).r;\n"
+"    gl_FragColor.g = texture(tex, warpedCoordinateG).g;\n"
+"    gl_FragColor.b = texture(tex, warpedCoordinateB).b;\n"
+"}\n";
+
+// Shaders for drawing with a distortion lookup texture.  A single quad
+// covers the eye, and each fragment looks up its distortion-corrected
+// texture coordinates before applying the time-warp texture matrix.  The
+// outermost texels of the lookup texture lie on the edges of the eye, so
+// the lookup coordinate is pulled in by half a texel.
+static const GLchar* lookupDistortionVertexShader =
+"#version 130\n"
+"in vec2 position;\n"
+"uniform mat4 projectionMatrix;\n"
+"uniform mat4 modelViewMatrix;\n"
+"uniform sampler2D lookupRedGreen;\n"
+"out vec2 lookupCoordinate;\n"
+"void main()\n"
+"{\n"
+"   vec2 size = vec2(textureSize(lookupRedGreen, 0));\n"
+"   lookupCoordinate =\n"
+"      ((position * 0.5 + 0.5) * (size - 1.0) + 0.5) / size;\n"
+"   gl_Position = projectionMatrix * modelViewMatrix *\n"
+"      vec4(position, 0, 1);\n"
+"}\n";
+
+static const GLchar* lookupDistortionFragmentShader =
+"#version 130\n"
+"uniform sampler2D tex;\n"
+"uniform sampler2D lookupRedGreen;\n"
+"uniform sampler2D lookupBlue;\n"
+"uniform mat4 textureMatrix;\n"
+"in vec2 lookupCoordinate;\n"
+"void main()\n"
+"{\n"
+"    vec4 redGreen = texture(lookupRedGreen, lookupCoordinate);\n"
+"    vec2 blue = texture(lookupBlue, lookupCoordinate).rg;\n"
+"    gl_FragColor.r = texture(tex,\n"
+"       vec2(textureMatrix * vec4(redGreen.rg, 0, 1))).r;\n"
+"    gl_FragColor.g = texture(tex,\n"
+"       vec2(textureMatrix * vec4(redGreen.ba, 0, 1))).g;\n"
+"    gl_FragColor.b = texture(tex,\n"
+"       vec2(textureMatrix * vec4(blue, 0, 1))).b;\n"
+"}\n";
+#endif
+
 static bool checkShaderError(GLuint shaderId, osvr::util::log::LoggerPtr m_log) {
     GLint result = GL_FALSE;
     glGetShaderiv(shaderId, GL_COMPILE_STATUS, &result);
@@ -433,6 +525,9 @@ namespace renderkit {
         // initialization if they are re-ordered in the header file.
         m_displayOpen = false;
         m_programId = 0;
+        m_gridProgramId = 0;
+        m_lookupProgramId = 0;
+        m_estimateVsync = p.m_verticalSync && p.m_estimateVsyncFromSwaps;
 
         // Set our toolkit pointer based on the one that is
         // passed it.  If none are passed in, then set it to
@@ -515,6 +610,20 @@ namespace renderkit {
     }
 
     bool RenderManagerOpenGL::GetTimingInfo(size_t whichEye, OSVR_RenderTimingInfo& info) {
+      if (GetToolkitTimingInfo(whichEye, info)) {
+        return true;
+      }
+
+      // The toolkit can't tell us, so use what we have estimated from
+      // the times at which our swaps completed.  All eyes are assumed
+      // to be on displays that are synchronized to the first one.
+      if (whichEye >= GetNumEyes()) {
+        return false;
+      }
+      return m_vsyncEstimator.getTimingInfo(info);
+    }
+
+    bool RenderManagerOpenGL::GetToolkitTimingInfo(size_t whichEye, OSVR_RenderTimingInfo& info) {
       if(!m_toolkit.getRenderTimingInfo) {
         return false;
       }
@@ -646,6 +755,120 @@ namespace renderkit {
             glDeleteProgram(m_programId);
             m_programId = 0;
         }
+        if (m_gridProgramId != 0) {
+            glDeleteProgram(m_gridProgramId);
+            m_gridProgramId = 0;
+        }
+        if (m_lookupProgramId != 0) {
+            glDeleteProgram(m_lookupProgramId);
+            m_lookupProgramId = 0;
+        }
+    }
+
+    bool RenderManagerOpenGL::constructGridProgram() {
+#ifdef OSVR_RM_USE_OPENGLES20
+        return false;
+#else
+        GLuint vertexShaderId = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertexShaderId, 1, &gridDistortionVertexShader, nullptr);
+        glCompileShader(vertexShaderId);
+        GLuint fragmentShaderId = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fragmentShaderId, 1, &gridDistortionFragmentShader,
+                       nullptr);
+        glCompileShader(fragmentShaderId);
+        GLint vertexCompiled = GL_FALSE, fragmentCompiled = GL_FALSE;
+        glGetShaderiv(vertexShaderId, GL_COMPILE_STATUS, &vertexCompiled);
+        glGetShaderiv(fragmentShaderId, GL_COMPILE_STATUS, &fragmentCompiled);
+        if (vertexCompiled == GL_FALSE || fragmentCompiled == GL_FALSE) {
+            glDeleteShader(vertexShaderId);
+            glDeleteShader(fragmentShaderId);
+            return false;
+        }
+
+        m_gridProgramId = glCreateProgram();
+        glAttachShader(m_gridProgramId, vertexShaderId);
+        glAttachShader(m_gridProgramId, fragmentShaderId);
+        // There is no position attribute, so one of the texture
+        // coordinates takes location 0, which some drivers require to be
+        // enabled in order to draw.
+        glBindAttribLocation(m_gridProgramId, 0, "textureCoordinateR");
+        glBindAttribLocation(m_gridProgramId, 1, "textureCoordinateG");
+        glBindAttribLocation(m_gridProgramId, 2, "textureCoordinateB");
+        glLinkProgram(m_gridProgramId);
+        glDeleteShader(vertexShaderId);
+        glDeleteShader(fragmentShaderId);
+        GLint linked = GL_FALSE;
+        glGetProgramiv(m_gridProgramId, GL_LINK_STATUS, &linked);
+        if (linked == GL_FALSE) {
+            glDeleteProgram(m_gridProgramId);
+            m_gridProgramId = 0;
+            return false;
+        }
+
+        m_gridProjectionUniformId =
+            glGetUniformLocation(m_gridProgramId, "projectionMatrix");
+        m_gridModelViewUniformId =
+            glGetUniformLocation(m_gridProgramId, "modelViewMatrix");
+        m_gridTextureUniformId =
+            glGetUniformLocation(m_gridProgramId, "textureMatrix");
+        m_gridQuadsUniformId =
+            glGetUniformLocation(m_gridProgramId, "gridQuads");
+        return !checkForGLError(
+            "RenderManagerOpenGL::constructGridProgram end");
+#endif
+    }
+
+    bool RenderManagerOpenGL::constructLookupProgram() {
+#ifdef OSVR_RM_USE_OPENGLES20
+        return false;
+#else
+        GLuint vertexShaderId = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertexShaderId, 1, &lookupDistortionVertexShader,
+                       nullptr);
+        glCompileShader(vertexShaderId);
+        GLuint fragmentShaderId = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fragmentShaderId, 1, &lookupDistortionFragmentShader,
+                       nullptr);
+        glCompileShader(fragmentShaderId);
+        GLint vertexCompiled = GL_FALSE, fragmentCompiled = GL_FALSE;
+        glGetShaderiv(vertexShaderId, GL_COMPILE_STATUS, &vertexCompiled);
+        glGetShaderiv(fragmentShaderId, GL_COMPILE_STATUS, &fragmentCompiled);
+        if (vertexCompiled == GL_FALSE || fragmentCompiled == GL_FALSE) {
+            glDeleteShader(vertexShaderId);
+            glDeleteShader(fragmentShaderId);
+            return false;
+        }
+
+        m_lookupProgramId = glCreateProgram();
+        glAttachShader(m_lookupProgramId, vertexShaderId);
+        glAttachShader(m_lookupProgramId, fragmentShaderId);
+        glBindAttribLocation(m_lookupProgramId, 0, "position");
+        glLinkProgram(m_lookupProgramId);
+        glDeleteShader(vertexShaderId);
+        glDeleteShader(fragmentShaderId);
+        GLint linked = GL_FALSE;
+        glGetProgramiv(m_lookupProgramId, GL_LINK_STATUS, &linked);
+        if (linked == GL_FALSE) {
+            glDeleteProgram(m_lookupProgramId);
+            m_lookupProgramId = 0;
+            return false;
+        }
+
+        m_lookupProjectionUniformId =
+            glGetUniformLocation(m_lookupProgramId, "projectionMatrix");
+        m_lookupModelViewUniformId =
+            glGetUniformLocation(m_lookupProgramId, "modelViewMatrix");
+        m_lookupTextureUniformId =
+            glGetUniformLocation(m_lookupProgramId, "textureMatrix");
+        m_lookupImageUniformId =
+            glGetUniformLocation(m_lookupProgramId, "tex");
+        m_lookupRedGreenUniformId =
+            glGetUniformLocation(m_lookupProgramId, "lookupRedGreen");
+        m_lookupBlueUniformId =
+            glGetUniformLocation(m_lookupProgramId, "lookupBlue");
+        return !checkForGLError(
+            "RenderManagerOpenGL::constructLookupProgram end");
+#endif
     }
 
     RenderManager::OpenResults RenderManagerOpenGL::OpenDisplay(void) {
@@ -847,7 +1070,23 @@ namespace renderkit {
         glDeleteShader(fragmentShaderId);
         checkForGLError("RenderManagerOpenGL::OpenDisplay after deleting shaders");
 
-        if (!UpdateDistortionMeshesInternal(SQUARE,
+        // Compact vertices draw SQUARE meshes with a shader of their own
+        // when the context supports it, and fall back to compact indexed
+        // meshes when it does not.
+        if (m_params.m_compactDistortionVertices && !constructGridProgram()) {
+            if (m_log)
+                m_log->warn() << "RenderManagerOpenGL::OpenDisplay: Could not "
+                                 "construct grid distortion shader; drawing "
+                                 "compact indexed meshes instead";
+        }
+        if (m_params.m_distortionLookupTexture && !constructLookupProgram()) {
+            if (m_log)
+                m_log->warn() << "RenderManagerOpenGL::OpenDisplay: Could not "
+                                 "construct distortion lookup shader; drawing "
+                                 "distortion meshes instead";
+        }
+
+        if (!UpdateDistortionMeshesInternal(m_params.m_distortionMeshType,
                                             m_params.m_distortionParameters)) {
           m_log->error() << "RenderManagerOpenGL::OpenDisplay: Could not "
                             "construct distortion mesh";
@@ -986,8 +1225,16 @@ namespace renderkit {
         :
         VAO(0),
         vertexBuffer(0),
-        indexBuffer(0)
-    {   }
+        indexBuffer(0),
+        topology(TRIANGLE_STRIP),
+        format(FLOAT_VERTICES),
+        vertexCount(0),
+        gridQuads(0)
+    {
+        texOffset[0] = texOffset[1] = 0;
+        texScale[0] = texScale[1] = 1;
+        lookupTextures[0] = lookupTextures[1] = 0;
+    }
 
     RenderManagerOpenGL::DistortionMeshBuffer::DistortionMeshBuffer(
         DistortionMeshBuffer && rhs) {
@@ -998,6 +1245,14 @@ namespace renderkit {
         indexBuffer = std::move(rhs.indexBuffer);
         vertices = std::move(rhs.vertices);
         indices = std::move(rhs.indices);
+        topology = rhs.topology;
+        format = rhs.format;
+        vertexCount = rhs.vertexCount;
+        gridQuads = rhs.gridQuads;
+        std::copy(rhs.texOffset, rhs.texOffset + 2, texOffset);
+        std::copy(rhs.texScale, rhs.texScale + 2, texScale);
+        std::copy(rhs.lookupTextures, rhs.lookupTextures + 2, lookupTextures);
+        rhs.lookupTextures[0] = rhs.lookupTextures[1] = 0;
     }
 
     RenderManagerOpenGL::DistortionMeshBuffer::~DistortionMeshBuffer() {
@@ -1016,6 +1271,15 @@ namespace renderkit {
             indexBuffer = std::move(rhs.indexBuffer);
             vertices = std::move(rhs.vertices);
             indices = std::move(rhs.indices);
+            topology = rhs.topology;
+            format = rhs.format;
+            vertexCount = rhs.vertexCount;
+            gridQuads = rhs.gridQuads;
+            std::copy(rhs.texOffset, rhs.texOffset + 2, texOffset);
+            std::copy(rhs.texScale, rhs.texScale + 2, texScale);
+            std::copy(rhs.lookupTextures, rhs.lookupTextures + 2,
+                      lookupTextures);
+            rhs.lookupTextures[0] = rhs.lookupTextures[1] = 0;
         }
         return *this;
     }
@@ -1045,16 +1309,161 @@ namespace renderkit {
             glDeleteBuffers(1, &indexBuffer);
             indexBuffer = 0;
         }
+        if (lookupTextures[0]) {
+            glDeleteTextures(2, lookupTextures);
+            lookupTextures[0] = lookupTextures[1] = 0;
+        }
         vertices.clear();
         indices.clear();
     }
 
+    void RenderManagerOpenGL::DistortionMeshBuffer::SetVertexAttributes()
+        const {
+        switch (format) {
+        case COMPACT_VERTICES: {
+            size_t const stride = sizeof(CompactDistortionVertex);
+            glVertexAttribPointer(0, 2, GL_SHORT, GL_TRUE, stride,
+                (void*)offsetof(CompactDistortionVertex, pos));
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride,
+                (void*)offsetof(CompactDistortionVertex, texRed));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride,
+                (void*)offsetof(CompactDistortionVertex, texGreen));
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(3, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride,
+                (void*)offsetof(CompactDistortionVertex, texBlue));
+            glEnableVertexAttribArray(3);
+        } break;
+        case GRID_VERTICES: {
+            // Matches the attribute locations bound in the grid program.
+            size_t const stride = sizeof(GridDistortionVertex);
+            glVertexAttribPointer(0, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride,
+                (void*)offsetof(GridDistortionVertex, texRed));
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride,
+                (void*)offsetof(GridDistortionVertex, texGreen));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride,
+                (void*)offsetof(GridDistortionVertex, texBlue));
+            glEnableVertexAttribArray(2);
+            glDisableVertexAttribArray(3);
+        } break;
+        case LOOKUP_TEXTURE: {
+            // Matches the attribute location bound in the lookup program.
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE,
+                2 * sizeof(GLfloat), nullptr);
+            glEnableVertexAttribArray(0);
+            glDisableVertexAttribArray(1);
+            glDisableVertexAttribArray(2);
+            glDisableVertexAttribArray(3);
+        } break;
+        default: {
+            size_t const stride = sizeof(DistortionVertex);
+            glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride,
+                (void*)offsetof(DistortionVertex, pos));
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride,
+                (void*)offsetof(DistortionVertex, texRed));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride,
+                (void*)offsetof(DistortionVertex, texGreen));
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride,
+                (void*)offsetof(DistortionVertex, texBlue));
+            glEnableVertexAttribArray(3);
+        }
+        }
+    }
+
+    /// Quads per side if the mesh is a SQUARE grid whose triangle strip
+    /// can be drawn by the grid shader, 0 otherwise.  The strip must have
+    /// the layout the shader computes, less the repeated vertex at the start
+    /// of the first column.
+    static GLsizei gridQuadsForMesh(DistortionMeshType type,
+                                    DistortionMesh const& mesh) {
+        if (type != SQUARE || mesh.topology != TRIANGLE_STRIP) {
+            return 0;
+        }
+        size_t const vertsPerSide = static_cast<size_t>(
+            std::sqrt(static_cast<double>(mesh.vertices.size())) + 0.5);
+        if (vertsPerSide < 2 ||
+            vertsPerSide * vertsPerSide != mesh.vertices.size()) {
+            return 0;
+        }
+        size_t const quads = vertsPerSide - 1;
+        size_t const perColumn = 2 * quads + 2;
+        if (mesh.indices.size() + 1 != quads * perColumn) {
+            return 0;
+        }
+        for (size_t k = 1; k <= mesh.indices.size(); k++) {
+            size_t const column = k / perColumn;
+            size_t const i = std::min(
+                std::max(k - column * perColumn, size_t(1)) - 1,
+                2 * quads - 1);
+            size_t const x = column + i % 2;
+            size_t const y = i / 2;
+            if (mesh.indices[k - 1] != x * vertsPerSide + y) {
+                return 0;
+            }
+        }
+        return static_cast<GLsizei>(quads);
+    }
+
     bool RenderManagerOpenGL::UpdateDistortionMeshesInternal(
         DistortionMeshType type ///< Type of mesh to produce
         ,
         std::vector<DistortionParameters> const&
             distort ///< Distortion parameters
         ) {
+        return updateDistortionMeshBuffers(type, distort, nullptr);
+    }
+
+    bool RenderManagerOpenGL::UpdateDistortionMeshesForEyesInternal(
+        DistortionMeshType type,
+        std::vector<DistortionParameters> const& distort,
+        std::vector<size_t> const& eyes) {
+        return updateDistortionMeshBuffers(type, distort, &eyes);
+    }
+
+    /// Fill a buffer object, creating it on the first upload.  Later
+    /// uploads orphan the old storage before writing the new data, so
+    /// that the driver does not have to wait for draws that are still
+    /// reading the old mesh.
+    static void fillDistortionMeshBuffer(GLenum target, GLuint& buffer,
+                                         GLsizeiptr bytes, const void* data) {
+        if (buffer) {
+            glBindBuffer(target, buffer);
+            glBufferData(target, bytes, nullptr, GL_DYNAMIC_DRAW);
+            glBufferSubData(target, 0, bytes, data);
+            return;
+        }
+        glGenBuffers(1, &buffer);
+        glBindBuffer(target, buffer);
+        glBufferData(target, bytes, data, GL_STATIC_DRAW);
+    }
+
+    void RenderManagerOpenGL::bindDistortionMeshVertexArray(
+        DistortionMeshBuffer& meshBuffer) {
+#ifdef OSVR_RM_USE_OPENGLES20
+        if(m_GLVAOExtensionAvailable) {
+            if (!meshBuffer.VAO) {
+                glGenVertexArraysOES(1, &meshBuffer.VAO);
+            }
+            glBindVertexArrayOES(meshBuffer.VAO);
+        }
+#else
+        if (!meshBuffer.VAO) {
+            glGenVertexArrays(1, &meshBuffer.VAO);
+        }
+        glBindVertexArray(meshBuffer.VAO);
+#endif
+    }
+
+    bool RenderManagerOpenGL::updateDistortionMeshBuffers(
+        DistortionMeshType type,
+        std::vector<DistortionParameters> const& distort,
+        std::vector<size_t> const* eyes) {
 
 #ifdef OSVR_RM_USE_OPENGLES20
         // Record the current state of the VAO or array and element
@@ -1092,9 +1501,6 @@ namespace renderkit {
         });
 #endif
 
-        // Clear the triangle and quad buffers if we have created them before.
-        m_distortionMeshBuffer.clear();
-
         // Construct the data buffer that will hold the vertices and texture
         // coordinates for R,G,B distortion mapping.
 
@@ -1106,19 +1512,77 @@ namespace renderkit {
             return false;
         }
 
-        m_distortionMeshBuffer.resize(numEyes);
+        // Only some eyes can be updated in place if we already have
+        // buffers of the same type, and if no eye has stopped or started
+        // mirroring another.  Otherwise, clear the triangle and quad
+        // buffers if we have created them before.
+        std::vector<size_t> const previousSourceEyes = m_distortionMeshSourceEye;
+        assignDistortionMeshSourceEyes(distort);
+        std::vector<bool> update(numEyes, true);
+        bool const inPlace = eyes != nullptr &&
+            m_distortionMeshBuffer.size() == numEyes &&
+            m_distortionMeshBufferType == type &&
+            m_distortionMeshSourceEye == previousSourceEyes;
+        if (inPlace) {
+            update.assign(numEyes, false);
+            for (size_t eye : *eyes) {
+                if (eye >= numEyes) {
+                    m_log->error() << "RenderManagerOpenGL::UpdateDistortionMesh: "
+                                      "No eye "
+                                   << eye;
+                    return false;
+                }
+                update[m_distortionMeshSourceEye[eye]] = true;
+            }
+        } else {
+            m_distortionMeshBuffer.clear();
+            m_distortionMeshBuffer.resize(numEyes);
+        }
+        m_distortionMeshBufferType = type;
+
+        // Compute the distortion meshes up front, which can be done on
+        // worker threads because it does not need a graphics context.
+        // Eyes that mirror another eye get no mesh of their own, and
+        // lookup textures replace the meshes entirely.  Meshes updated in
+        // place are not put in the on-disk cache, which would only churn
+        // while a lens is being calibrated.
+        std::vector<DistortionMesh> meshes(numEyes);
+        if (m_lookupProgramId) {
+            // Computed per eye below.
+        } else if (inPlace) {
+            PipelineTrace::Scope trace(m_trace.get(), "ComputeDistortionMeshes");
+            for (size_t eye = 0; eye < numEyes; eye++) {
+                if (update[eye] && m_distortionMeshSourceEye[eye] == eye) {
+                    meshes[eye] = ComputeDistortionMesh(eye, type,
+                        distort[eye], m_params.m_renderOverfillFactor,
+                        m_params.m_distortionMeshThreads);
+                }
+            }
+        } else {
+            meshes = computeDistortionMeshesForEyes(type, distort);
+        }
+
         for (size_t eye = 0; eye < numEyes; eye++) {
+            auto & meshBuffer = m_distortionMeshBuffer[eye];
+            meshBuffer.renderManager = this;
+            meshBuffer.display = GetDisplayUsedByEye(eye);
+            if (!update[eye] || m_distortionMeshSourceEye[eye] != eye) {
+                continue;
+            }
             if (!m_toolkit.makeCurrent ||
                 !m_toolkit.makeCurrent(m_toolkit.data, GetDisplayUsedByEye(eye))) {
                 return false;
             }
 
-            auto & meshBuffer = m_distortionMeshBuffer[eye];
-            meshBuffer.renderManager = this;
-            meshBuffer.display = GetDisplayUsedByEye(eye);
+            if (m_lookupProgramId) {
+                if (!uploadDistortionLookupTexture(eye, distort[eye],
+                                                   meshBuffer)) {
+                    return false;
+                }
+                continue;
+            }
 
-            // Compute the distortion mesh
-            DistortionMesh mesh = ComputeDistortionMesh(eye, type, distort[eye], m_params.m_renderOverfillFactor);
+            DistortionMesh const& mesh = meshes[eye];
             if (mesh.vertices.empty()) {
                 m_log->error() << "RenderManagerOpenGL::UpdateDistortionMesh: Could "
                                   "not create mesh "
@@ -1126,6 +1590,14 @@ namespace renderkit {
                 return false;
             }
 
+            meshBuffer.topology = mesh.topology;
+            if (m_params.m_compactDistortionVertices) {
+                if (!uploadCompactDistortionMesh(type, mesh, meshBuffer)) {
+                    return false;
+                }
+                continue;
+            }
+
             // Transcribe the vertex data into the correct format
             meshBuffer.vertices.resize(mesh.vertices.size());
             for (size_t i = 0; i < meshBuffer.vertices.size(); ++i) {
@@ -1149,45 +1621,202 @@ namespace renderkit {
             // Copy the index data
             meshBuffer.indices = mesh.indices;
 
-            // Construct the geometry we're going to render into the eyes
+            // Construct the geometry we're going to render into the eyes,
+            // or refill the buffers we already have.
+            bindDistortionMeshVertexArray(meshBuffer);
+            fillDistortionMeshBuffer(GL_ARRAY_BUFFER, meshBuffer.vertexBuffer,
+                sizeof(DistortionVertex) * meshBuffer.vertices.size(),
+                &meshBuffer.vertices[0]);
+            meshBuffer.SetVertexAttributes();
+            fillDistortionMeshBuffer(GL_ELEMENT_ARRAY_BUFFER,
+                meshBuffer.indexBuffer,
+                sizeof(decltype(meshBuffer.indices[0])) * meshBuffer.indices.size(),
+                &meshBuffer.indices[0]);
+        }
+
+        return true;
+    }
+
+    bool RenderManagerOpenGL::uploadDistortionLookupTexture(size_t eye,
+        DistortionParameters const& distort,
+        DistortionMeshBuffer& meshBuffer) {
 #ifdef OSVR_RM_USE_OPENGLES20
-            if(m_GLVAOExtensionAvailable) {
-                glGenVertexArraysOES(1, &meshBuffer.VAO);
-                glBindVertexArrayOES(meshBuffer.VAO);
-            }
+        return false;
 #else
-            glGenVertexArrays(1, &meshBuffer.VAO);
-            glBindVertexArray(meshBuffer.VAO);
-#endif
+        // Size the table to match the eye's pixels in the rendering
+        // orientation, including those that overfill has pushed off the
+        // screen, divided by the downsample factor.
+        OSVR_ViewportDescription viewport;
+        if (!ConstructViewportForPresent(
+                eye, viewport,
+                m_params.m_displayConfiguration->getSwapEyes())) {
+            m_log->error() << "RenderManagerOpenGL::"
+                              "uploadDistortionLookupTexture: Could not "
+                              "construct viewport for eye "
+                           << eye;
+            return false;
+        }
+        GLint maxSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+        double const scale = m_params.m_renderOverfillFactor /
+            std::max(m_params.m_distortionLookupTextureDownsample, 1u);
+        auto tableSize = [&](double pixels) {
+            return static_cast<size_t>(std::min<double>(maxSize,
+                std::max(2.0, std::ceil(pixels * scale))));
+        };
+        DistortionLookupTable table = ComputeDistortionLookupTable(eye,
+            distort, m_params.m_renderOverfillFactor,
+            tableSize(viewport.width), tableSize(viewport.height),
+            m_params.m_distortionMeshThreads);
+        if (table.width == 0) {
+            m_log->error() << "RenderManagerOpenGL::"
+                              "uploadDistortionLookupTexture: Could not "
+                              "create lookup table for eye "
+                           << eye;
+            return false;
+        }
 
-            glGenBuffers(1, &meshBuffer.vertexBuffer);
-            glBindBuffer(GL_ARRAY_BUFFER, meshBuffer.vertexBuffer);
-            glBufferData(GL_ARRAY_BUFFER,
-                sizeof(DistortionVertex) * meshBuffer.vertices.size(),
-                &meshBuffer.vertices[0], GL_STATIC_DRAW);
+        // Leave the application's texture binding as we found it.
+        GLint prevTexture;
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &prevTexture);
+        auto resetTexture = util::finally([&] {
+            glBindTexture(GL_TEXTURE_2D, prevTexture);
+        });
 
-            size_t const stride = sizeof(DistortionVertex);
-            glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride,
-                (void*)offsetof(DistortionVertex,pos));
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride,
-                (void*)offsetof(DistortionVertex, texRed));
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride,
-                (void*)offsetof(DistortionVertex, texGreen));
-            glEnableVertexAttribArray(2);
-            glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride,
-                (void*)offsetof(DistortionVertex, texBlue));
-            glEnableVertexAttribArray(3);
+        // The size of the table only depends on the viewport, so textures
+        // from an earlier update are refilled in place.
+        GLsizei const width = static_cast<GLsizei>(table.width);
+        GLsizei const height = static_cast<GLsizei>(table.height);
+        if (meshBuffer.lookupTextures[0]) {
+            glBindTexture(GL_TEXTURE_2D, meshBuffer.lookupTextures[0]);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA,
+                            GL_FLOAT, table.redGreen.data());
+            glBindTexture(GL_TEXTURE_2D, meshBuffer.lookupTextures[1]);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RG,
+                            GL_FLOAT, table.blue.data());
+            return !checkForGLError(
+                "RenderManagerOpenGL::uploadDistortionLookupTexture update");
+        }
+        glGenTextures(2, meshBuffer.lookupTextures);
+        glBindTexture(GL_TEXTURE_2D, meshBuffer.lookupTextures[0]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA,
+                     GL_FLOAT, table.redGreen.data());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, meshBuffer.lookupTextures[1]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, width, height, 0, GL_RG,
+                     GL_FLOAT, table.blue.data());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        // One quad covering the eye, as a triangle strip.
+        static const GLfloat quad[] = { -1, -1, 1, -1, -1, 1, 1, 1 };
+        meshBuffer.format = DistortionMeshBuffer::LOOKUP_TEXTURE;
+        meshBuffer.vertexCount = 4;
+        bindDistortionMeshVertexArray(meshBuffer);
+        fillDistortionMeshBuffer(GL_ARRAY_BUFFER, meshBuffer.vertexBuffer,
+                                 sizeof(quad), quad);
+        meshBuffer.SetVertexAttributes();
+        return !checkForGLError(
+            "RenderManagerOpenGL::uploadDistortionLookupTexture");
+#endif
+    }
 
-            glGenBuffers(1, &meshBuffer.indexBuffer);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshBuffer.indexBuffer);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                sizeof(decltype(meshBuffer.indices[0])) * meshBuffer.indices.size(),
-                &meshBuffer.indices[0], GL_STATIC_DRAW);
-        }
+    /// Encode a coordinate as a 16-bit unsigned normalized value over the
+    /// range [offset, offset + scale].
+    static GLushort compactTexCoord(float value, float offset, float scale) {
+        float const t = std::min(1.0f, std::max(0.0f, (value - offset) / scale));
+        return static_cast<GLushort>(std::lround(t * 65535.0f));
+    }
 
-        return true;
+    bool RenderManagerOpenGL::uploadCompactDistortionMesh(
+        DistortionMeshType type, DistortionMesh const& mesh,
+        DistortionMeshBuffer& meshBuffer) {
+        // Texture coordinates can fall outside of 0..1 near the edges, so
+        // encode them over the range the mesh actually uses.
+        float lo[2] = { mesh.vertices[0].m_texRed[0],
+                        mesh.vertices[0].m_texRed[1] };
+        float hi[2] = { lo[0], lo[1] };
+        for (auto const& v : mesh.vertices) {
+            for (auto const* tex : { &v.m_texRed, &v.m_texGreen, &v.m_texBlue }) {
+                for (size_t i = 0; i < 2; i++) {
+                    lo[i] = std::min(lo[i], (*tex)[i]);
+                    hi[i] = std::max(hi[i], (*tex)[i]);
+                }
+            }
+        }
+        for (size_t i = 0; i < 2; i++) {
+            meshBuffer.texOffset[i] = lo[i];
+            meshBuffer.texScale[i] = hi[i] > lo[i] ? hi[i] - lo[i] : 1.0f;
+        }
+        auto encodeTex = [&](Float2 const& tex, GLushort out[2]) {
+            out[0] = compactTexCoord(tex[0], meshBuffer.texOffset[0],
+                                     meshBuffer.texScale[0]);
+            out[1] = compactTexCoord(tex[1], meshBuffer.texOffset[1],
+                                     meshBuffer.texScale[1]);
+        };
+
+        bindDistortionMeshVertexArray(meshBuffer);
+
+        // SQUARE grids are drawn without an index buffer: the texture
+        // coordinates are laid out in strip order, and the grid shader
+        // computes the positions.
+        meshBuffer.gridQuads =
+            m_gridProgramId ? gridQuadsForMesh(type, mesh) : 0;
+        if (meshBuffer.gridQuads > 0) {
+            meshBuffer.format = DistortionMeshBuffer::GRID_VERTICES;
+            std::vector<GridDistortionVertex> vertices;
+            vertices.reserve(mesh.indices.size() + 1);
+            auto addVertex = [&](uint16_t index) {
+                auto const& v = mesh.vertices[index];
+                GridDistortionVertex out;
+                encodeTex(v.m_texRed, out.texRed);
+                encodeTex(v.m_texGreen, out.texGreen);
+                encodeTex(v.m_texBlue, out.texBlue);
+                vertices.push_back(out);
+            };
+            addVertex(mesh.indices[0]);
+            for (uint16_t index : mesh.indices) {
+                addVertex(index);
+            }
+            meshBuffer.vertexCount = static_cast<GLsizei>(vertices.size());
+            fillDistortionMeshBuffer(GL_ARRAY_BUFFER, meshBuffer.vertexBuffer,
+                sizeof(GridDistortionVertex) * vertices.size(),
+                &vertices[0]);
+            meshBuffer.SetVertexAttributes();
+            return !checkForGLError(
+                "RenderManagerOpenGL::uploadCompactDistortionMesh grid");
+        }
+
+        meshBuffer.format = DistortionMeshBuffer::COMPACT_VERTICES;
+        std::vector<CompactDistortionVertex> vertices(mesh.vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            auto const& v = mesh.vertices[i];
+            for (size_t c = 0; c < 2; c++) {
+                float const p = std::min(1.0f, std::max(-1.0f, v.m_pos[c]));
+                vertices[i].pos[c] =
+                    static_cast<GLshort>(std::lround(p * 32767.0f));
+            }
+            encodeTex(v.m_texRed, vertices[i].texRed);
+            encodeTex(v.m_texGreen, vertices[i].texGreen);
+            encodeTex(v.m_texBlue, vertices[i].texBlue);
+        }
+        fillDistortionMeshBuffer(GL_ARRAY_BUFFER, meshBuffer.vertexBuffer,
+            sizeof(CompactDistortionVertex) * vertices.size(),
+            &vertices[0]);
+        meshBuffer.SetVertexAttributes();
+
+        meshBuffer.indices = mesh.indices;
+        fillDistortionMeshBuffer(GL_ELEMENT_ARRAY_BUFFER,
+            meshBuffer.indexBuffer,
+            sizeof(decltype(meshBuffer.indices[0])) * meshBuffer.indices.size(),
+            &meshBuffer.indices[0]);
+        return !checkForGLError(
+            "RenderManagerOpenGL::uploadCompactDistortionMesh");
     }
 
     bool RenderManagerOpenGL::RenderFrameInitialize() {
@@ -1237,6 +1866,17 @@ namespace renderkit {
     }
 
     bool RenderManagerOpenGL::PresentFrameFinalize() {
+        // If the toolkit can't tell us when vertical retrace happens,
+        // wait for the swaps to complete and note the time, so that we
+        // can estimate it.
+        OSVR_RenderTimingInfo toolkitTiming;
+        if (m_estimateVsync && !GetToolkitTimingInfo(0, toolkitTiming)) {
+          glFinish();
+          OSVR_TimeValue now;
+          osvrTimeValueGetNow(&now);
+          m_vsyncEstimator.addSwapTime(now);
+        }
+
         if (!m_toolkit.handleEvents ||
           !m_toolkit.handleEvents(m_toolkit.data)) {
           return false;
@@ -1376,8 +2016,38 @@ namespace renderkit {
             }
             });
 
-        /// Switch to our vertex/shader programs
-        glUseProgram(m_programId);
+        /// Switch to our vertex/shader programs, using the grid or lookup
+        /// program for meshes that are drawn with them.
+        size_t const meshEye =
+            params.m_index < m_distortionMeshSourceEye.size()
+                ? m_distortionMeshSourceEye[params.m_index]
+                : params.m_index;
+        bool const mirrored = meshEye != params.m_index;
+        auto const & meshBuffer = m_distortionMeshBuffer[meshEye];
+        bool const gridMesh =
+            meshBuffer.format == DistortionMeshBuffer::GRID_VERTICES;
+        bool const lookup =
+            meshBuffer.format == DistortionMeshBuffer::LOOKUP_TEXTURE;
+        GLuint projectionUniformId = m_projectionUniformId;
+        GLuint modelViewUniformId = m_modelViewUniformId;
+        GLuint textureUniformId = m_textureUniformId;
+        if (gridMesh) {
+            glUseProgram(m_gridProgramId);
+            projectionUniformId = m_gridProjectionUniformId;
+            modelViewUniformId = m_gridModelViewUniformId;
+            textureUniformId = m_gridTextureUniformId;
+            glUniform1i(m_gridQuadsUniformId, meshBuffer.gridQuads);
+        } else if (lookup) {
+            glUseProgram(m_lookupProgramId);
+            projectionUniformId = m_lookupProjectionUniformId;
+            modelViewUniformId = m_lookupModelViewUniformId;
+            textureUniformId = m_lookupTextureUniformId;
+            glUniform1i(m_lookupImageUniformId, 0);
+            glUniform1i(m_lookupRedGreenUniformId, 1);
+            glUniform1i(m_lookupBlueUniformId, 2);
+        } else {
+            glUseProgram(m_programId);
+        }
         if (checkForGLError(
             "RenderManagerOpenGL::PresentEye after use program")) {
             return false;
@@ -1398,7 +2068,7 @@ namespace renderkit {
         GLfloat myScale = m_params.m_renderOverfillFactor;
         GLfloat scaleProj[16] = { myScale, 0, 0, 0, 0, myScale, 0, 0,
           0, 0, 1, 0, 0, 0, 0, 1 };
-        glUniformMatrix4fv(m_projectionUniformId, 1, GL_FALSE, scaleProj);
+        glUniformMatrix4fv(projectionUniformId, 1, GL_FALSE, scaleProj);
         if (checkForGLError("RenderManagerOpenGL::PresentEye after projection "
           "matrix setting")) {
           return false;
@@ -1419,7 +2089,12 @@ namespace renderkit {
                               "ComputeDisplayOrientationMatrix failed";
             return false;
         }
-        glUniformMatrix4fv(m_modelViewUniformId, 1, GL_FALSE, modelView.data);
+        // Mirrored meshes are flipped left to right before anything else.
+        if (mirrored) {
+            Eigen::Map<Eigen::Matrix4f> modelViewEigen(modelView.data);
+            modelViewEigen.col(0) *= -1;
+        }
+        glUniformMatrix4fv(modelViewUniformId, 1, GL_FALSE, modelView.data);
         if (checkForGLError("RenderManagerOpenGL::PresentEye after modelView "
           "matrix setting")) {
           return false;
@@ -1455,9 +2130,30 @@ namespace renderkit {
         Eigen::Map<Eigen::MatrixXf> cropEigen(crop.data, 4, 4);
         Eigen::MatrixXf full(4, 4);
         full = textureEigen * cropEigen;
+
+        // Mirrored meshes have their texture coordinates flipped left to
+        // right, about the middle of the texture.
+        if (mirrored) {
+            Eigen::Matrix4f mirror = Eigen::Matrix4f::Identity();
+            mirror(0, 0) = -1;
+            mirror(0, 3) = 1;
+            full = full * mirror;
+        }
+
+        // Compact meshes store their texture coordinates normalized over
+        // the range the mesh uses; map them back before the rest.
+        if (meshBuffer.format == DistortionMeshBuffer::COMPACT_VERTICES ||
+            meshBuffer.format == DistortionMeshBuffer::GRID_VERTICES) {
+            Eigen::Matrix4f decode = Eigen::Matrix4f::Identity();
+            decode(0, 0) = meshBuffer.texScale[0];
+            decode(1, 1) = meshBuffer.texScale[1];
+            decode(0, 3) = meshBuffer.texOffset[0];
+            decode(1, 3) = meshBuffer.texOffset[1];
+            full = full * decode;
+        }
         memcpy(textureMat, full.data(), 16 * sizeof(float));
 
-        glUniformMatrix4fv(m_textureUniformId, 1, GL_FALSE, textureMat);
+        glUniformMatrix4fv(textureUniformId, 1, GL_FALSE, textureMat);
         if (checkForGLError("RenderManagerOpenGL::PresentEye after texture "
           "matrix setting")) {
           return false;
@@ -1482,6 +2178,23 @@ namespace renderkit {
 
         // Bind the texture that we're going to use to render into the
         // frame buffer.
+        // The lookup textures go on the next two units, which are unbound
+        // again once we are done.
+        if (lookup) {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, meshBuffer.lookupTextures[0]);
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, meshBuffer.lookupTextures[1]);
+        }
+        auto resetLookup = util::finally([&] {
+            if (lookup) {
+                glActiveTexture(GL_TEXTURE2);
+                glBindTexture(GL_TEXTURE_2D, 0);
+                glActiveTexture(GL_TEXTURE1);
+                glBindTexture(GL_TEXTURE_2D, 0);
+                glActiveTexture(GL_TEXTURE0);
+            }
+        });
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, params.m_buffer.OpenGL->colorBufferName);
         if (checkForGLError(
@@ -1499,26 +2212,12 @@ namespace renderkit {
           return false;
         }
 
-        auto const & meshBuffer = m_distortionMeshBuffer[params.m_index];
-
 #ifdef OSVR_RM_USE_OPENGLES20
         if(m_GLVAOExtensionAvailable) {
             glBindVertexArrayOES(meshBuffer.VAO);
         } else {
             glBindBuffer(GL_ARRAY_BUFFER, meshBuffer.vertexBuffer);
-            size_t const stride = sizeof(DistortionVertex);
-            glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride,
-              (void*)offsetof(DistortionVertex, pos));
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride,
-              (void*)offsetof(DistortionVertex, texRed));
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride,
-              (void*)offsetof(DistortionVertex, texGreen));
-            glEnableVertexAttribArray(2);
-            glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride,
-              (void*)offsetof(DistortionVertex, texBlue));
-            glEnableVertexAttribArray(3);
+            meshBuffer.SetVertexAttributes();
 
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshBuffer.indexBuffer);
         }
@@ -1530,8 +2229,16 @@ namespace renderkit {
             return false;
         }
 
-        GLsizei numElements = static_cast<GLsizei>(meshBuffer.indices.size());
-        glDrawElements(GL_TRIANGLE_STRIP, numElements, GL_UNSIGNED_SHORT, 0);
+        if (gridMesh || lookup) {
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, meshBuffer.vertexCount);
+        } else {
+            GLsizei numElements =
+                static_cast<GLsizei>(meshBuffer.indices.size());
+            GLenum mode = meshBuffer.topology == TRIANGLE_LIST
+                              ? GL_TRIANGLES
+                              : GL_TRIANGLE_STRIP;
+            glDrawElements(mode, numElements, GL_UNSIGNED_SHORT, 0);
+        }
         if (checkForGLError(
             "RenderManagerOpenGL::PresentEye after glDrawElements")) {
             //return false;
@@ -29,6 +29,7 @@ Sensics, Inc.
 #include "RenderManager.h"
 #include "RenderManagerOpenGLVersion.h"
 #include "RenderManagerOpenGLC.h"
+#include "VsyncEstimator.h"
 
 #if defined(_WIN32)
 #include <windows.h>
@@ -85,6 +86,19 @@ namespace renderkit {
                 distort ///< Distortion parameters
             ) override;
 
+        OSVR_RENDERMANAGER_EXPORT bool UpdateDistortionMeshesForEyesInternal(
+            DistortionMeshType type,
+            std::vector<DistortionParameters> const& distort,
+            std::vector<size_t> const& eyes) override;
+
+        /// Shared implementation of the two above.  When eyes is not null
+        /// and the meshes already exist, only the meshes of those eyes
+        /// are recomputed and their buffers are refilled in place.
+        bool updateDistortionMeshBuffers(
+            DistortionMeshType type,
+            std::vector<DistortionParameters> const& distort,
+            std::vector<size_t> const* eyes);
+
         bool m_displayOpen; ///< Has our display been opened?
 
         // Methods to open and close a window, used to get
@@ -116,9 +130,18 @@ namespace renderkit {
         };
         OSVR_OpenGLToolkitFunctions m_toolkit;  ///< OpenGL windowing toolkit to use
 
-        /// Delete m_programId in destructor.
+        /// Delete m_programId, m_gridProgramId and m_lookupProgramId in
+        /// destructor.
         void deleteProgram();
 
+        /// Construct m_gridProgramId; returns false if the context does
+        /// not support it.
+        bool constructGridProgram();
+
+        /// Construct m_lookupProgramId; returns false if the context does
+        /// not support it.
+        bool constructLookupProgram();
+
         /// Construct the buffers we're going to use in Render() mode, which
         /// we use to actually use the Presentation mode.  This gives us the
         /// main Presentation path as the basic approach which we can build on
@@ -137,6 +160,28 @@ namespace renderkit {
             m_modelViewUniformId; ///< Pointer to modelView matrix, vertex shader
         GLuint m_textureUniformId; ///< Pointer to texture matrix, vertex shader
 
+        // Shader for drawing SQUARE meshes that have no position or index
+        // buffers, with the positions computed from gl_VertexID.  Only
+        // constructed when m_compactDistortionVertices is set and the
+        // context supports GLSL 1.30; zero otherwise.
+        GLuint m_gridProgramId;
+        GLuint m_gridProjectionUniformId;
+        GLuint m_gridModelViewUniformId;
+        GLuint m_gridTextureUniformId;
+        GLuint m_gridQuadsUniformId; ///< Quads per side of the grid
+
+        // Shader that looks up the distortion-corrected texture coordinates
+        // for each pixel in the lookup textures of the mesh buffer.  Only
+        // constructed when m_distortionLookupTexture is set and the context
+        // supports GLSL 1.30; zero otherwise.
+        GLuint m_lookupProgramId;
+        GLuint m_lookupProjectionUniformId;
+        GLuint m_lookupModelViewUniformId;
+        GLuint m_lookupTextureUniformId;
+        GLuint m_lookupImageUniformId;     ///< Sampler for the rendered image
+        GLuint m_lookupRedGreenUniformId;  ///< Sampler for red/green lookup
+        GLuint m_lookupBlueUniformId;      ///< Sampler for blue lookup
+
         // To do with our Render() path.
         std::vector<GLuint> m_frameBuffers;      ///< Groups a color buffer and a depth buffer (per display)
 
@@ -150,6 +195,20 @@ namespace renderkit {
         bool m_GLDiscardExtensionAvailable = false;
 #endif
 
+        /// Estimates the timing of vertical retrace from when swaps
+        /// complete, for toolkits that cannot report it.
+        VsyncEstimator m_vsyncEstimator;
+
+        /// Should PresentFrameFinalize() wait for the swaps to complete
+        /// and feed m_vsyncEstimator?  Set when vertical sync is on and
+        /// m_estimateVsyncFromSwaps asks for it; the ATW wrapper sets it on
+        /// the RenderManager it harnesses whenever vertical sync is on, as
+        /// that swaps on the wrapper's own thread.
+        bool m_estimateVsync;
+
+        /// Timing info from the toolkit, if it provides any.
+        bool GetToolkitTimingInfo(size_t whichEye, OSVR_RenderTimingInfo& info);
+
         // Stored client GL state
         bool m_storeClientGLState = true;
         GLint m_initialFrameBuffer;
@@ -161,6 +220,25 @@ namespace renderkit {
             GLfloat texBlue[2];
         };
 
+        /// Vertex used when m_compactDistortionVertices is set.  Positions
+        /// are signed normalized and texture coordinates are unsigned
+        /// normalized over the range of the mesh's coordinates, which the
+        /// texture matrix maps back.
+        struct CompactDistortionVertex {
+            GLshort pos[2];
+            GLushort texRed[2];
+            GLushort texGreen[2];
+            GLushort texBlue[2];
+        };
+
+        /// Vertex for SQUARE meshes drawn with the grid shader: texture
+        /// coordinates only, one per vertex of the triangle strip.
+        struct GridDistortionVertex {
+            GLushort texRed[2];
+            GLushort texGreen[2];
+            GLushort texBlue[2];
+        };
+
         struct DistortionMeshBuffer {
 
             // Needed for making the proper context current in the destructor.
@@ -172,6 +250,26 @@ namespace renderkit {
             GLuint indexBuffer;
             std::vector<DistortionVertex> vertices;
             std::vector<uint16_t> indices;
+            DistortionMeshTopology topology;
+
+            /// Which of the vertex types above the vertex buffer holds.
+            /// LOOKUP_TEXTURE buffers hold a single quad covering the eye,
+            /// and the texture coordinates are in lookupTextures.
+            enum VertexFormat {
+                FLOAT_VERTICES,
+                COMPACT_VERTICES,
+                GRID_VERTICES,
+                LOOKUP_TEXTURE
+            };
+            VertexFormat format;
+            GLsizei vertexCount;  ///< Vertices to draw for GRID_VERTICES
+                                  ///  and LOOKUP_TEXTURE
+            GLsizei gridQuads;    ///< Quads per side for GRID_VERTICES
+            GLfloat texOffset[2]; ///< Maps compact texture coordinates back
+            GLfloat texScale[2];
+            /// Red/green (RGBA32F) and blue (RG32F) texture coordinates for
+            /// LOOKUP_TEXTURE, from ComputeDistortionLookupTable().
+            GLuint lookupTextures[2];
 
             DistortionMeshBuffer();
             DistortionMeshBuffer(DistortionMeshBuffer && rhs);
@@ -179,14 +277,36 @@ namespace renderkit {
             DistortionMeshBuffer & operator=(DistortionMeshBuffer && rhs);
 
             void Clear();
+
+            /// Point the vertex attributes at the bound vertex buffer.
+            void SetVertexAttributes() const;
         };
 
+        /// Bake the distortion for an eye into the lookup textures of a
+        /// mesh buffer, when m_distortionLookupTexture is set.
+        bool uploadDistortionLookupTexture(size_t eye,
+                                           DistortionParameters const& distort,
+                                           DistortionMeshBuffer& meshBuffer);
+
+        /// Fill in a mesh buffer with the compact form of a mesh, when
+        /// m_compactDistortionVertices is set.
+        bool uploadCompactDistortionMesh(DistortionMeshType type,
+                                         DistortionMesh const& mesh,
+                                         DistortionMeshBuffer& meshBuffer);
+
         // Vertex/texture coordinate buffer to render into final windows, one
         // per eye
         // @todo One per eye/display combination in case of multiple displays
         // per eye
         std::vector<DistortionMeshBuffer> m_distortionMeshBuffer;
 
+        /// Type of the meshes in m_distortionMeshBuffer.
+        DistortionMeshType m_distortionMeshBufferType = SQUARE;
+
+        /// Bind a mesh buffer's vertex array object, creating it on the
+        /// first upload.
+        void bindDistortionMeshVertexArray(DistortionMeshBuffer& meshBuffer);
+
         //===================================================================
         // Overloaded render functions from the base class.
         bool RenderPathSetup() override;
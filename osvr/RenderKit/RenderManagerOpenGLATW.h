@@ -32,6 +32,7 @@
 
 #include "RenderManagerOpenGL.h"
 #include "GraphicsLibraryOpenGL.h"
+#include "PipelineTrace.h"
 
 #include <EGL/egl.h>
 
@@ -199,6 +200,7 @@ namespace renderkit {
             bool flipInY;
         } mNextFrameInfo;
         bool mNextFrameAvailable = false;
+        unsigned mNextFramePresentCount = 0; ///< Times mNextFrameInfo was presented
 
         bool mQuit = false;
         bool mStarted = false;
@@ -479,6 +481,7 @@ namespace renderkit {
                 mNextFrameInfo.normalizedCroppingViewports = normalizedCroppingViewports;
                 mFirstFramePresented = true;
                 mNextFrameAvailable = true;
+                mNextFramePresentCount = 0;
             }
 
             //m_log->info() << "RenderManagerOpenGLATW::PresentFrameInternal: Queued next frame info, waiting for it to be presented...";
@@ -584,6 +587,14 @@ namespace renderkit {
 
                 mRenderManager = new RenderManagerOpenGL(m_context, atwParams);
                 mRenderManager->m_storeClientGLState = false;
+                // Its swaps are paced by the vertical sync we set up on
+                // the window, so it can estimate retrace from them.
+                // Waiting for them only stalls this thread, not the
+                // application's, so this does not need asking for.
+                mRenderManager->m_estimateVsync = m_params.m_verticalSync;
+                // The harnessed RenderManager does the presenting, so it
+                // records the frame timings that our clients read.
+                mRenderManager->m_frameTimings = m_frameTimings;
 
                 m_log->info() << "RenderManagerOpenGLATW::threadFunc: Registering render buffers to the harnessed "
                                  "RenderManagerOpenGL";
@@ -617,6 +628,9 @@ namespace renderkit {
                 quit = true;
             }
 
+            if (m_trace) {
+                m_trace->nameThread("ATW");
+            }
             while (!quit) {
 
                 // Wait until it is time to present the render buffers.
@@ -683,10 +697,13 @@ namespace renderkit {
                         // being presented.
                         std::lock_guard<std::mutex> lock(mMutex);
                         if (mFirstFramePresented) {
+                            PipelineTrace::Scope trace(m_trace.get(), "ATWIteration");
+                            trace.arg("iteration", static_cast<double>(iteration));
+
                             // Update the context so we get our callbacks called and
                             // update tracker state, which will be read during the
                             // time-warp calculation in our harnessed RenderManager.
-                            osvrClientUpdate(mRenderManager->m_context);
+                            mRenderManager->clientUpdate();
 
                             //m_log->info() << "RenderManagerOpenGLATW::threadFunc: presenting frame to internal backend.";
 
@@ -702,6 +719,7 @@ namespace renderkit {
                             // Send the rendered results to the screen, using the
                             // RenderInfo that was handed to us by the client the last
                             // time they gave us some images.
+                            mRenderManager->m_atwRepresentCount = mNextFramePresentCount++;
                             if (!mRenderManager->PresentRenderBuffers(
                                     renderBuffers, mNextFrameInfo.renderInfo, mNextFrameInfo.renderParams,
                                     mNextFrameInfo.normalizedCroppingViewports, mNextFrameInfo.flipInY)) {
@@ -792,6 +810,31 @@ namespace renderkit {
             return mRenderManager->UpdateDistortionMeshesInternal(type, distort);
         }
 
+        OSVR_RENDERMANAGER_EXPORT bool
+        UpdateDistortionMeshesForEyesInternal(DistortionMeshType type, std::vector<DistortionParameters> const& distort,
+                                              std::vector<size_t> const& eyes) override {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if(!mRenderManager) {
+                m_log->error() << "RenderManagerOpenGLATW::UpdateDistortionMeshesForEyesInternal: Called before successful OpenDisplay";
+                return false;
+            }
+            return mRenderManager->UpdateDistortionMeshesForEyesInternal(type, distort, eyes);
+        }
+
+        /// The swap has to happen on the time-warp thread, which presents
+        /// through the harnessed RenderManager, so the request goes there.
+        OSVR_RENDERMANAGER_EXPORT std::shared_future<bool>
+        UpdateDistortionMeshesAsync(DistortionMeshType type, std::vector<DistortionParameters> const& distort) override {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if(!mRenderManager) {
+                m_log->error() << "RenderManagerOpenGLATW::UpdateDistortionMeshesAsync: Called before successful OpenDisplay";
+                std::promise<bool> failed;
+                failed.set_value(false);
+                return failed.get_future().share();
+            }
+            return mRenderManager->UpdateDistortionMeshesAsync(type, distort);
+        }
+
         bool RegisterRenderBuffersInternal(const std::vector<RenderBuffer>& buffers,
                                            bool appWillNotOverwriteBeforeNewPresent = false) override {
 
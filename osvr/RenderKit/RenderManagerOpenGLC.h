@@ -103,6 +103,9 @@ typedef struct OSVR_OpenGLToolkitFunctions {
     OSVR_CBool (*handleEvents)(void* data);
     OSVR_CBool (*getDisplayFrameBuffer)(void* data, size_t display, GLuint* frameBufferOut);
     OSVR_CBool (*getDisplaySizeOverride)(void* data, size_t display, int* width, int* height);
+    // If this is null or returns false and vertical sync is on, RenderManager
+    // can wait for each frame's swaps to complete and estimate the timing
+    // from when they do (see estimateVsyncFromSwaps).
     OSVR_CBool (*getRenderTimingInfo)(void* data, size_t display, size_t whichEye, OSVR_RenderTimingInfo* renderTimingInfoOut);
 } OSVR_OpenGLToolkitFunctions;
 
@@ -0,0 +1,142 @@
+/** @file
+    @brief Header
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_SeqlockRing_h_GUID_B2F4D819_6E3A_4C57_8D90_A7C15E2F3B68
+#define INCLUDED_SeqlockRing_h_GUID_B2F4D819_6E3A_4C57_8D90_A7C15E2F3B68
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace osvr {
+namespace renderkit {
+
+    /// @brief Fixed-size ring of the @p N values most recently added, which
+    /// one thread adds to while any number of others read from it, without
+    /// locks.
+    ///
+    /// Each slot carries a sequence number that the writer makes odd while
+    /// it is changing the slot, and a reader discards a value whose slot's
+    /// sequence number changed while it was copying it, which only happens
+    /// when the writer has lapped it.  Values are stored as atomic words so
+    /// that a reader racing with the writer has defined behavior.
+    template <typename T, size_t N> class SeqlockRing {
+        static_assert(std::is_trivial<T>::value,
+                      "Values are copied in and out as raw words");
+
+      public:
+        static const size_t CAPACITY = N;
+
+        SeqlockRing() : m_count(0) {
+            for (auto& slot : m_slots) {
+                slot.sequence.store(0, std::memory_order_relaxed);
+                for (auto& word : slot.words) {
+                    word.store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+        SeqlockRing(SeqlockRing const&) = delete;
+        SeqlockRing& operator=(SeqlockRing const&) = delete;
+
+        /// Number of values added so far, which is also the index that
+        /// push() will give the next one.
+        uint64_t size() const { return m_count.load(std::memory_order_acquire); }
+
+        /// Index of the oldest value that is kept, given size().
+        static uint64_t first(uint64_t count) {
+            return count > CAPACITY ? count - CAPACITY : 0;
+        }
+
+        /// Add a value, overwriting the oldest if the ring is full.  Must
+        /// only be called from one thread at a time.
+        void push(T const& value) {
+            const uint64_t index = m_count.load(std::memory_order_relaxed);
+            uint64_t words[WORDS] = {};
+            std::memcpy(words, &value, sizeof(value));
+
+            Slot& slot = m_slots[index % CAPACITY];
+            slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t w = 0; w < WORDS; w++) {
+                slot.words[w].store(words[w], std::memory_order_relaxed);
+            }
+            slot.sequence.store(2 * index + 2, std::memory_order_release);
+            m_count.store(index + 1, std::memory_order_release);
+        }
+
+        /// Copy the value that was the @p index'th one added.
+        /// @return False if it is no longer (or not yet) in the ring.
+        bool read(uint64_t index, T& value) const {
+            // The sequence number is 2 * index + 1 while the index'th
+            // value is being written into the slot and 2 * index + 2 once
+            // it has been, so 0 means the slot has never been written.
+            const Slot& slot = m_slots[index % CAPACITY];
+            if (slot.sequence.load(std::memory_order_acquire) !=
+                2 * index + 2) {
+                return false;
+            }
+            uint64_t words[WORDS];
+            for (size_t w = 0; w < WORDS; w++) {
+                words[w] = slot.words[w].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) !=
+                2 * index + 2) {
+                return false;
+            }
+            std::memcpy(&value, words, sizeof(value));
+            return true;
+        }
+
+      private:
+        static const size_t WORDS =
+            (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        struct Slot {
+            std::atomic<uint64_t> sequence;
+            std::array<std::atomic<uint64_t>, WORDS> words;
+        };
+
+        std::array<Slot, CAPACITY> m_slots;
+        std::atomic<uint64_t> m_count;
+    };
+
+    template <typename T, size_t N> const size_t SeqlockRing<T, N>::CAPACITY;
+    template <typename T, size_t N> const size_t SeqlockRing<T, N>::WORDS;
+
+} // namespace renderkit
+} // namespace osvr
+
+#endif // INCLUDED_SeqlockRing_h_GUID_B2F4D819_6E3A_4C57_8D90_A7C15E2F3B68
@@ -0,0 +1,161 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "TrackerIngestionThread.h"
+#include "PipelineTrace.h"
+#include "PoseStateCaching.h"
+
+// Library/third-party includes
+#include <osvr/ClientKit/InterfaceStateC.h>
+#include <osvr/Common/ClientContext.h>
+
+// Standard includes
+#include <algorithm>
+#include <utility>
+
+namespace osvr {
+namespace renderkit {
+
+    TrackerSnapshot::InterfaceState const*
+    TrackerSnapshot::find(OSVR_ClientInterface iface) const {
+        for (auto const& state : interfaces) {
+            if (state.iface == iface) {
+                return &state;
+            }
+        }
+        return nullptr;
+    }
+
+    TrackerIngestionThread::TrackerIngestionThread(
+        OSVR_ClientContext context, double intervalSeconds,
+        std::shared_ptr<PipelineTrace> trace)
+        : m_context(context), m_interval(intervalSeconds),
+          m_trace(std::move(trace)) {
+        m_thread = std::thread(&TrackerIngestionThread::threadFunc, this);
+    }
+
+    TrackerIngestionThread::~TrackerIngestionThread() {
+        {
+            std::lock_guard<std::mutex> lock(m_quitMutex);
+            m_quit = true;
+        }
+        m_quitCondition.notify_one();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    TrackerIngestionThread::ContextLock TrackerIngestionThread::lockContext() {
+        return ContextLock(m_contextMutex);
+    }
+
+    void TrackerIngestionThread::addInterface(ContextLock const& /*lock*/,
+                                              OSVR_ClientInterface iface,
+                                              PoseStateCaching const* cache) {
+        Tracked tracked;
+        tracked.iface = iface;
+        tracked.cache = cache;
+        m_tracked.push_back(tracked);
+    }
+
+    void TrackerIngestionThread::removeInterface(ContextLock const& /*lock*/,
+                                                 OSVR_ClientInterface iface) {
+        m_tracked.erase(std::remove_if(m_tracked.begin(), m_tracked.end(),
+                                       [iface](Tracked const& tracked) {
+                                           return tracked.iface == iface;
+                                       }),
+                        m_tracked.end());
+    }
+
+    bool TrackerIngestionThread::latch(TrackerSnapshot& snapshot) {
+        std::lock_guard<std::mutex> lock(m_publishedMutex);
+        snapshot = m_published;
+        return snapshot.updateOk;
+    }
+
+    void TrackerIngestionThread::threadFunc() {
+        if (m_trace) {
+            m_trace->nameThread("TrackerIngestion");
+        }
+        std::unique_lock<std::mutex> quitLock(m_quitMutex);
+        while (!m_quit) {
+            quitLock.unlock();
+            auto next = std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<
+                            std::chrono::steady_clock::duration>(m_interval);
+            ingest();
+            quitLock.lock();
+            m_quitCondition.wait_until(quitLock, next,
+                                       [this] { return m_quit; });
+        }
+    }
+
+    void TrackerIngestionThread::ingest() {
+        {
+            ContextLock lock(m_contextMutex);
+            {
+                PipelineTrace::Scope trace(m_trace.get(), "osvrClientUpdate");
+                m_working.updateOk =
+                    osvrClientUpdate(m_context) != OSVR_RETURN_FAILURE;
+            }
+            osvrTimeValueGetNow(&m_working.updateTime);
+            m_working.updates = ++m_updates;
+            m_working.roomToWorld = m_context->getRoomToWorldTransform();
+
+            // Read every tracked interface while nothing else can touch
+            // the context, so that the snapshot is consistent.
+            m_working.interfaces.resize(m_tracked.size());
+            for (size_t i = 0; i < m_tracked.size(); i++) {
+                Tracked const& tracked = m_tracked[i];
+                TrackerSnapshot::InterfaceState& state =
+                    m_working.interfaces[i];
+                state.iface = tracked.iface;
+                if (tracked.cache) {
+                    state.poseValid = tracked.cache->getLastReport(
+                        state.poseTime, state.pose);
+                } else {
+                    state.poseValid =
+                        osvrGetPoseState(tracked.iface, &state.poseTime,
+                                         &state.pose) == OSVR_RETURN_SUCCESS;
+                }
+                state.velocity.linearVelocityValid = false;
+                state.velocity.angularVelocityValid = false;
+                state.velocityValid =
+                    osvrGetVelocityState(tracked.iface, &state.velocityTime,
+                                         &state.velocity) ==
+                    OSVR_RETURN_SUCCESS;
+            }
+        }
+
+        // Swap rather than copy, so that publishing does not allocate
+        // and holds the lock only briefly.  The old snapshot that we get
+        // back is overwritten next time.
+        std::lock_guard<std::mutex> lock(m_publishedMutex);
+        std::swap(m_published, m_working);
+    }
+
+} // namespace renderkit
+} // namespace osvr
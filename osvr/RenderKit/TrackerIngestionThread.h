@@ -0,0 +1,166 @@
+/** @file
+    @brief Header
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_TrackerIngestionThread_h_GUID_5F0B2D87_3A1C_4E6B_9D42_E7C8A1F06B35
+#define INCLUDED_TrackerIngestionThread_h_GUID_5F0B2D87_3A1C_4E6B_9D42_E7C8A1F06B35
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+#include <osvr/ClientKit/ContextC.h>
+#include <osvr/ClientKit/InterfaceC.h>
+#include <osvr/Common/Transform.h>
+#include <osvr/Util/ClientReportTypesC.h>
+#include <osvr/Util/TimeValueC.h>
+
+// Standard includes
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace osvr {
+namespace renderkit {
+
+    class PipelineTrace;
+    class PoseStateCaching;
+
+    /// @brief Tracker state as of one update of a client context.
+    struct TrackerSnapshot {
+        /// State of one interface.
+        struct InterfaceState {
+            OSVR_ClientInterface iface = nullptr;
+            bool poseValid = false;
+            OSVR_TimeValue poseTime = {0, 0};
+            OSVR_PoseState pose;
+            bool velocityValid = false;
+            OSVR_TimeValue velocityTime = {0, 0};
+            OSVR_VelocityState velocity;
+        };
+
+        /// Did the update of the context succeed?
+        bool updateOk = true;
+        /// How many updates there had been; 0 if there has not been one.
+        uint64_t updates = 0;
+        /// When the update finished.
+        OSVR_TimeValue updateTime = {0, 0};
+        /// The context's room-to-world transform after the update.
+        osvr::common::Transform roomToWorld;
+        /// State of each interface being tracked.
+        std::vector<InterfaceState> interfaces;
+
+        /// Find the state of @p iface, or nullptr if it is not tracked.
+        InterfaceState const* find(OSVR_ClientInterface iface) const;
+    };
+
+    /// @brief Thread that owns the updating of a client context, so that
+    /// the cost and jitter of osvrClientUpdate() stay off the rendering
+    /// path.
+    ///
+    /// At a fixed interval the thread updates the context, reads the pose
+    /// and velocity of each interface it has been told about, and
+    /// publishes them as a TrackerSnapshot.  Rendering threads take a copy
+    /// of the latest snapshot with latch() instead of updating the
+    /// context themselves, which costs a short copy under a lock that is
+    /// only otherwise held for the same copy.
+    ///
+    /// Callbacks registered on the context (including those of
+    /// PoseStateCaching) are called on this thread.  Anything else that
+    /// uses the context while the thread is running must hold the lock
+    /// returned by lockContext().
+    class TrackerIngestionThread {
+      public:
+        typedef std::unique_lock<std::mutex> ContextLock;
+
+        /// Start updating @p context every @p intervalSeconds, writing
+        /// each update to @p trace if it is not null.  The context must
+        /// outlive this object.
+        TrackerIngestionThread(OSVR_ClientContext context,
+                               double intervalSeconds,
+                               std::shared_ptr<PipelineTrace> trace);
+
+        /// Stop the thread, waiting for the update in progress.
+        ~TrackerIngestionThread();
+
+        TrackerIngestionThread(TrackerIngestionThread const&) = delete;
+        TrackerIngestionThread&
+        operator=(TrackerIngestionThread const&) = delete;
+
+        /// Lock out the thread for as long as the returned lock is held,
+        /// so that the context can be used.
+        ContextLock lockContext();
+
+        /// Include @p iface in the snapshots.  Its pose is read from
+        /// @p cache (which must last until removeInterface()) if that
+        /// is not null, or from the interface state otherwise.
+        void addInterface(ContextLock const& lock, OSVR_ClientInterface iface,
+                          PoseStateCaching const* cache = nullptr);
+
+        /// Stop including @p iface in the snapshots.  Call this before
+        /// freeing the interface, without releasing the lock in between.
+        void removeInterface(ContextLock const& lock,
+                             OSVR_ClientInterface iface);
+
+        /// Copy the most recent snapshot into @p snapshot.
+        /// @return Whether the update it came from succeeded.
+        bool latch(TrackerSnapshot& snapshot);
+
+      private:
+        struct Tracked {
+            OSVR_ClientInterface iface;
+            PoseStateCaching const* cache;
+        };
+
+        void threadFunc();
+
+        /// Update the context and publish the result.
+        void ingest();
+
+        OSVR_ClientContext m_context;
+        std::chrono::duration<double> m_interval;
+        std::shared_ptr<PipelineTrace> m_trace;
+
+        std::mutex m_contextMutex;      ///< Held while using m_context
+        std::vector<Tracked> m_tracked; ///< Guarded by m_contextMutex
+        uint64_t m_updates = 0;
+
+        TrackerSnapshot m_working; ///< Filled in by the thread
+        std::mutex m_publishedMutex;
+        TrackerSnapshot m_published; ///< Guarded by m_publishedMutex
+
+        std::mutex m_quitMutex;
+        std::condition_variable m_quitCondition;
+        bool m_quit = false; ///< Guarded by m_quitMutex
+        std::thread m_thread;
+    };
+
+} // namespace renderkit
+} // namespace osvr
+
+#endif // INCLUDED_TrackerIngestionThread_h_GUID_5F0B2D87_3A1C_4E6B_9D42_E7C8A1F06B35
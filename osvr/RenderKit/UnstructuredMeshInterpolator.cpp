@@ -30,10 +30,11 @@
 #include <quat.h>
 
 // Standard includes
-#include <map>
 #include <cmath>
+#include <algorithm>
 #include <array>
 #include <iostream>
+#include <utility>
 
 namespace osvr {
 namespace renderkit {
@@ -67,10 +68,6 @@ namespace renderkit {
         return fabs(dot) > 0.8;
     }
 
-    static double pointDistance(double x1, double y1, double x2, double y2) {
-        return std::sqrt((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
-    }
-
     /// Interpolates the values at three 2D points to the
     /// location of a third point.
     static double interpolate(double p1X, double p1Y, double val1, double p2X,
@@ -110,65 +107,420 @@ namespace renderkit {
         return -(ABC[0] * pointX + ABC[1] * pointY + D) / ABC[2];
     }
 
+    /// Twice the signed area of the triangle (a,b,c); positive when the
+    /// vertices are in counter-clockwise order.
+    static double orient(double ax, double ay, double bx, double by,
+                         double cx, double cy) {
+        return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+    }
+
+    /// Is the point d strictly inside the circumcircle of the
+    /// counter-clockwise triangle (a,b,c)?
+    static bool inCircumcircle(double ax, double ay, double bx, double by,
+                               double cx, double cy, double dx, double dy) {
+        double adx = ax - dx, ady = ay - dy;
+        double bdx = bx - dx, bdy = by - dy;
+        double cdx = cx - dx, cdy = cy - dy;
+        double ad = adx * adx + ady * ady;
+        double bd = bdx * bdx + bdy * bdy;
+        double cd = cdx * cdx + cdy * cdy;
+        double det = adx * (bdy * cd - bd * cdy) -
+                     ady * (bdx * cd - bd * cdx) +
+                     ad * (bdx * cdy - bdy * cdx);
+        return det > 0;
+    }
+
+    /// Construct the Delaunay triangulation of the input locations of the
+    /// specified points using the Bowyer-Watson algorithm.  The triangle
+    /// that holds each new point is found by walking across the
+    /// triangulation from the most-recently created triangle and the
+    /// cavity of triangles whose circumcircles hold the point is grown
+    /// across triangle neighbors, so construction does not need to test
+    /// every triangle for every point.
+    /// @return Vertex indices of the triangles, counter-clockwise.
+    static std::vector<std::array<size_t, 3> >
+    delaunayTriangulate(const PackedMonoPointSamples& points) {
+        std::vector<std::array<size_t, 3> > ret;
+        size_t const n = points.size();
+        if (n < 3) {
+            return ret;
+        }
+
+        // Vertex locations, followed by those of a super-triangle that
+        // encloses all of them.
+        std::vector<std::array<double, 2> > v(n + 3);
+        double minX = points.inX[0], maxX = minX;
+        double minY = points.inY[0], maxY = minY;
+        for (size_t i = 0; i < n; i++) {
+            v[i] = {{points.inX[i], points.inY[i]}};
+            minX = std::min(minX, v[i][0]);
+            maxX = std::max(maxX, v[i][0]);
+            minY = std::min(minY, v[i][1]);
+            maxY = std::max(maxY, v[i][1]);
+        }
+        double span = std::max(maxX - minX, maxY - minY);
+        if (span <= 0) {
+            return ret;
+        }
+        double midX = 0.5 * (minX + maxX);
+        double midY = 0.5 * (minY + maxY);
+        v[n] = {{midX - 100 * span, midY - 100 * span}};
+        v[n + 1] = {{midX + 100 * span, midY - 100 * span}};
+        v[n + 2] = {{midX, midY + 100 * span}};
+
+        // Each triangle stores its vertices in counter-clockwise order and
+        // the triangle across the edge opposite each vertex (-1 for none).
+        struct Triangle {
+            std::array<size_t, 3> v;
+            std::array<long, 3> n;
+            bool alive;
+        };
+        std::vector<Triangle> tris;
+        tris.push_back({{{n, n + 1, n + 2}}, {{-1, -1, -1}}, true});
+
+        std::vector<long> cavity;
+        std::vector<char> inCavity;
+        struct Edge {
+            size_t a, b;
+            long outside;
+        };
+        std::vector<Edge> boundary;
+        std::vector<long> created;
+        long last = 0;
+
+        for (size_t p = 0; p < n; p++) {
+            double px = v[p][0], py = v[p][1];
+
+            // Walk towards the point to find the triangle that holds it.
+            // Fall back to a full search if the walk fails to terminate.
+            long t = last;
+            size_t steps = 0;
+            bool found = false;
+            while (t >= 0 && steps++ < tris.size()) {
+                Triangle const& tri = tris[t];
+                long next = -1;
+                for (int e = 0; e < 3; e++) {
+                    auto const& a = v[tri.v[(e + 1) % 3]];
+                    auto const& b = v[tri.v[(e + 2) % 3]];
+                    if (orient(a[0], a[1], b[0], b[1], px, py) < 0) {
+                        next = tri.n[e];
+                        break;
+                    }
+                }
+                if (next < 0) {
+                    found = true;
+                    break;
+                }
+                t = next;
+            }
+            if (!found) {
+                t = -1;
+                for (size_t i = 0; i < tris.size() && t < 0; i++) {
+                    if (!tris[i].alive) {
+                        continue;
+                    }
+                    bool inside = true;
+                    for (int e = 0; e < 3; e++) {
+                        auto const& a = v[tris[i].v[(e + 1) % 3]];
+                        auto const& b = v[tris[i].v[(e + 2) % 3]];
+                        if (orient(a[0], a[1], b[0], b[1], px, py) < 0) {
+                            inside = false;
+                        }
+                    }
+                    if (inside) {
+                        t = static_cast<long>(i);
+                    }
+                }
+                if (t < 0) {
+                    continue;
+                }
+            }
+
+            // Duplicate input locations do not add a vertex.
+            bool duplicate = false;
+            for (int e = 0; e < 3; e++) {
+                auto const& a = v[tris[t].v[e]];
+                if (a[0] == px && a[1] == py) {
+                    duplicate = true;
+                }
+            }
+            if (duplicate) {
+                continue;
+            }
+
+            // Grow the cavity of triangles whose circumcircles contain the
+            // point, starting from the one that holds it.
+            inCavity.resize(tris.size(), 0);
+            cavity.clear();
+            cavity.push_back(t);
+            inCavity[t] = 1;
+            for (size_t c = 0; c < cavity.size(); c++) {
+                Triangle const& tri = tris[cavity[c]];
+                for (int e = 0; e < 3; e++) {
+                    long nb = tri.n[e];
+                    if (nb < 0 || inCavity[nb]) {
+                        continue;
+                    }
+                    auto const& a = v[tris[nb].v[0]];
+                    auto const& b = v[tris[nb].v[1]];
+                    auto const& d = v[tris[nb].v[2]];
+                    if (inCircumcircle(a[0], a[1], b[0], b[1], d[0], d[1],
+                                       px, py)) {
+                        inCavity[nb] = 1;
+                        cavity.push_back(nb);
+                    }
+                }
+            }
+
+            // Collect the edges on the boundary of the cavity and remove
+            // the triangles inside it.
+            boundary.clear();
+            for (long c : cavity) {
+                Triangle& tri = tris[c];
+                for (int e = 0; e < 3; e++) {
+                    long nb = tri.n[e];
+                    if (nb >= 0 && inCavity[nb]) {
+                        continue;
+                    }
+                    boundary.push_back({tri.v[(e + 1) % 3],
+                                        tri.v[(e + 2) % 3], nb});
+                }
+                tri.alive = false;
+            }
+
+            // Fan new triangles from the point to each boundary edge and
+            // stitch them to their neighbors.
+            created.clear();
+            for (auto const& edge : boundary) {
+                long id = static_cast<long>(tris.size());
+                tris.push_back({{{edge.a, edge.b, p}},
+                                {{-1, -1, edge.outside}}, true});
+                created.push_back(id);
+                if (edge.outside >= 0) {
+                    for (int e = 0; e < 3; e++) {
+                        long& back = tris[edge.outside].n[e];
+                        if (back >= 0 &&
+                            static_cast<size_t>(back) < inCavity.size() &&
+                            inCavity[back]) {
+                            auto const& o = tris[edge.outside].v;
+                            if (o[(e + 1) % 3] == edge.b &&
+                                o[(e + 2) % 3] == edge.a) {
+                                back = id;
+                            }
+                        }
+                    }
+                }
+            }
+            for (long id : created) {
+                Triangle& tri = tris[id];
+                for (long other : created) {
+                    if (other == id) {
+                        continue;
+                    }
+                    // Edge (b,p) is shared with the triangle starting at b;
+                    // edge (p,a) with the triangle ending at a.
+                    if (tris[other].v[0] == tri.v[1]) {
+                        tri.n[0] = other;
+                    }
+                    if (tris[other].v[1] == tri.v[0]) {
+                        tri.n[1] = other;
+                    }
+                }
+            }
+            inCavity.resize(tris.size(), 0);
+            for (long c : cavity) {
+                inCavity[c] = 0;
+            }
+            last = created.empty() ? last : created.back();
+        }
+
+        // Keep the triangles that do not touch the super-triangle.
+        for (auto const& tri : tris) {
+            if (tri.alive && tri.v[0] < n && tri.v[1] < n && tri.v[2] < n) {
+                ret.push_back(tri.v);
+            }
+        }
+        return ret;
+    }
+
+    /// Turn per-cell lists of indices, given as the cell that each
+    /// (cell, index) pair belongs to, into compressed-row storage: the
+    /// indices for cell i end up in out[start[i]] to out[start[i + 1] - 1],
+    /// in the order they were listed.
+    static void fillCompressedGrid(size_t numCells,
+                                   std::vector<uint32_t> const& cells,
+                                   std::vector<uint32_t> const& indices,
+                                   std::vector<uint32_t>& start,
+                                   std::vector<uint32_t>& out) {
+        start.assign(numCells + 1, 0);
+        for (uint32_t cell : cells) {
+            start[cell + 1]++;
+        }
+        for (size_t i = 0; i < numCells; i++) {
+            start[i + 1] += start[i];
+        }
+        out.resize(indices.size());
+        std::vector<uint32_t> next(start.begin(), start.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) {
+            out[next[cells[i]]++] = indices[i];
+        }
+    }
+
     UnstructuredMeshInterpolator::UnstructuredMeshInterpolator(
         const MonoPointDistortionMeshDescription& points, int numSamplesX,
         int numSamplesY)
-        : m_points(points), m_numSamplesX(numSamplesX),
+        : UnstructuredMeshInterpolator(packMonoPointSamples(points),
+                                       numSamplesX, numSamplesY) {}
+
+    UnstructuredMeshInterpolator::UnstructuredMeshInterpolator(
+        PackedMonoPointSamples samples, int numSamplesX, int numSamplesY)
+        : m_samples(std::move(samples)), m_numSamplesX(numSamplesX),
           m_numSamplesY(numSamplesY) {
-        // Construct and fill in the grid of nearby points that is used by the
+        size_t const numPoints = m_samples.size();
+
+        // Fill in the grid of nearby points that is used by the
         // interpolation function to accelerate the search for the three
         // nearest non-collinear points.
-        std::vector<MonoPointDistortionMeshDescription> ySet;
-        MonoPointDistortionMeshDescription empty;
-        for (int y = 0; y < m_numSamplesY; y++) {
-            ySet.emplace_back(empty);
-        }
-        for (int x = 0; x < m_numSamplesX; x++) {
-            m_grid.emplace_back(ySet);
-        }
-
-        // Go through each point in the unstructured grid and insert its index
-        // into all grid elements that are within 1/4th (rounded up) of the
-        // total span of the grid from its normalized location.
+        //   Go through each point in the unstructured grid and insert its
+        // index into all grid elements that are within 1/4th (rounded up)
+        // of the total span of the grid from its normalized location.
         int xHalfSpan =
             static_cast<int>(0.9 + (1.0 / 4.0) * 0.5 * m_numSamplesX);
         int yHalfSpan =
             static_cast<int>(0.9 + (1.0 / 4.0) * 0.5 * m_numSamplesY);
-        for (size_t i = 0; i < points.size(); i++) {
+        std::vector<uint32_t> cells, indices;
+        for (size_t i = 0; i < numPoints; i++) {
             int xIndex, yIndex;
-            if (getIndex(points[i][0][0], points[i][0][1], xIndex, yIndex)) {
+            if (getIndex(m_samples.inX[i], m_samples.inY[i], xIndex, yIndex)) {
                 // Get the range of locations to insert
-                int xMin = xIndex - xHalfSpan;
-                if (xMin < 0) {
-                    xMin = 0;
-                }
-                int xMax = xIndex + xHalfSpan;
-                if (xMax >= m_numSamplesX) {
-                    xMax = m_numSamplesX - 1;
-                }
-                int yMin = yIndex - yHalfSpan;
-                if (yMin < 0) {
-                    yMin = 0;
-                }
-                int yMax = yIndex + yHalfSpan;
-                if (yMax >= m_numSamplesY) {
-                    yMax = m_numSamplesY - 1;
-                }
+                int xMin = std::max(xIndex - xHalfSpan, 0);
+                int xMax = std::min(xIndex + xHalfSpan, m_numSamplesX - 1);
+                int yMin = std::max(yIndex - yHalfSpan, 0);
+                int yMax = std::min(yIndex + yHalfSpan, m_numSamplesY - 1);
 
                 // Insert this point into each of these locations.
-                for (int x = xMin; x <= xMax; x++) {
-                    for (int y = yMin; y <= yMax; y++) {
-                        m_grid[x][y].push_back(points[i]);
+                for (int y = yMin; y <= yMax; y++) {
+                    for (int x = xMin; x <= xMax; x++) {
+                        cells.push_back(static_cast<uint32_t>(
+                            y * m_numSamplesX + x));
+                        indices.push_back(static_cast<uint32_t>(i));
                     }
                 }
             }
         }
+        if (m_numSamplesX > 0 && m_numSamplesY > 0) {
+            fillCompressedGrid(
+                static_cast<size_t>(m_numSamplesX) * m_numSamplesY, cells,
+                indices, m_gridStart, m_gridPoints);
+        }
+
+        // Triangulate the points and build the point-location grid over
+        // their bounding box, sized so that each cell overlaps only a few
+        // triangles.
+        std::vector<std::array<size_t, 3> > triangles =
+            delaunayTriangulate(m_samples);
+        if (triangles.empty()) {
+            return;
+        }
+        m_triangles.resize(triangles.size());
+        for (size_t t = 0; t < triangles.size(); t++) {
+            for (size_t v = 0; v < 3; v++) {
+                m_triangles[t][v] = static_cast<uint32_t>(triangles[t][v]);
+            }
+        }
+        double minX = m_samples.inX[0], maxX = minX;
+        double minY = m_samples.inY[0], maxY = minY;
+        for (size_t i = 1; i < numPoints; i++) {
+            minX = std::min<double>(minX, m_samples.inX[i]);
+            maxX = std::max<double>(maxX, m_samples.inX[i]);
+            minY = std::min<double>(minY, m_samples.inY[i]);
+            maxY = std::max<double>(maxY, m_samples.inY[i]);
+        }
+        int side = static_cast<int>(
+            std::ceil(std::sqrt(static_cast<double>(m_triangles.size()))));
+        m_triangleGridX = std::max(side, 1);
+        m_triangleGridY = std::max(side, 1);
+        m_triangleGridMinX = minX;
+        m_triangleGridMinY = minY;
+        m_triangleGridScaleX =
+            (maxX > minX) ? m_triangleGridX / (maxX - minX) : 0;
+        m_triangleGridScaleY =
+            (maxY > minY) ? m_triangleGridY / (maxY - minY) : 0;
+        cells.clear();
+        indices.clear();
+        for (size_t t = 0; t < m_triangles.size(); t++) {
+            uint32_t a = m_triangles[t][0];
+            uint32_t b = m_triangles[t][1];
+            uint32_t c = m_triangles[t][2];
+            size_t lo = getTriangleCell(std::min({m_samples.inX[a], m_samples.inX[b], m_samples.inX[c]}),
+                                        std::min({m_samples.inY[a], m_samples.inY[b], m_samples.inY[c]}));
+            size_t hi = getTriangleCell(std::max({m_samples.inX[a], m_samples.inX[b], m_samples.inX[c]}),
+                                        std::max({m_samples.inY[a], m_samples.inY[b], m_samples.inY[c]}));
+            int xLo = static_cast<int>(lo % m_triangleGridX);
+            int yLo = static_cast<int>(lo / m_triangleGridX);
+            int xHi = static_cast<int>(hi % m_triangleGridX);
+            int yHi = static_cast<int>(hi / m_triangleGridX);
+            for (int y = yLo; y <= yHi; y++) {
+                for (int x = xLo; x <= xHi; x++) {
+                    cells.push_back(
+                        static_cast<uint32_t>(y * m_triangleGridX + x));
+                    indices.push_back(static_cast<uint32_t>(t));
+                }
+            }
+        }
+        fillCompressedGrid(
+            static_cast<size_t>(m_triangleGridX) * m_triangleGridY, cells,
+            indices, m_triangleGridStart, m_triangleGridTriangles);
+    }
+
+    bool UnstructuredMeshInterpolator::interpolateTriangulation(
+        float xN, float yN, Float2& out) const {
+        if (m_triangleGridStart.empty()) {
+            return false;
+        }
+
+        // Allow points that lie on a shared edge to be claimed by either
+        // triangle, despite round-off.
+        const double epsilon = -1e-9;
+        size_t const cell = getTriangleCell(xN, yN);
+        for (uint32_t i = m_triangleGridStart[cell];
+             i < m_triangleGridStart[cell + 1]; i++) {
+            auto const& tri = m_triangles[m_triangleGridTriangles[i]];
+            double x0 = m_samples.inX[tri[0]], y0 = m_samples.inY[tri[0]];
+            double x1 = m_samples.inX[tri[1]], y1 = m_samples.inY[tri[1]];
+            double x2 = m_samples.inX[tri[2]], y2 = m_samples.inY[tri[2]];
+            double area = orient(x0, y0, x1, y1, x2, y2);
+            if (area <= 0) {
+                continue;
+            }
+            double w0 = orient(x1, y1, x2, y2, xN, yN) / area;
+            double w1 = orient(x2, y2, x0, y0, xN, yN) / area;
+            double w2 = 1 - w0 - w1;
+            if (w0 < epsilon || w1 < epsilon || w2 < epsilon) {
+                continue;
+            }
+            out[0] = static_cast<float>(w0 * m_samples.outX[tri[0]] +
+                                        w1 * m_samples.outX[tri[1]] +
+                                        w2 * m_samples.outX[tri[2]]);
+            out[1] = static_cast<float>(w0 * m_samples.outY[tri[0]] +
+                                        w1 * m_samples.outY[tri[1]] +
+                                        w2 * m_samples.outY[tri[2]]);
+            return true;
+        }
+        return false;
     }
 
     Float2 UnstructuredMeshInterpolator::interpolateNearestPoints(float xN,
                                                                   float yN) {
         Float2 ret = {xN, yN};
 
+        // Inside the triangulated region, blend the vertices of the
+        // triangle that holds the point.
+        if (interpolateTriangulation(xN, yN, ret)) {
+            return ret;
+        }
+
+        // Outside of it, extrapolate from the nearest points.
         // Look in the spatial-acceleration grid to see if we can
         // find three points without having to search the entire set of
         // points.
@@ -176,45 +528,45 @@ namespace renderkit {
         if (!getIndex(xN, yN, xIndex, yIndex)) {
             return ret;
         }
-        MonoPointDistortionMeshDescription points;
-        points = getNearestPoints(xN, yN, m_grid[xIndex][yIndex]);
+        size_t const cell =
+            static_cast<size_t>(yIndex) * m_numSamplesX + xIndex;
+        uint32_t p[3];
+        size_t found = getNearestPoints(
+            xN, yN, m_gridPoints.data() + m_gridStart[cell],
+            m_gridStart[cell + 1] - m_gridStart[cell], p);
 
         // If we didn't get enough points from the acceleration
         // structure, look in the whole points array
-        if (points.size() < 3) {
-            points = getNearestPoints(xN, yN, m_points);
+        if (found < 3) {
+            found = getNearestPoints(xN, yN, nullptr, m_samples.size(), p);
         }
 
         // If we didn't get three points, just return the output of
         // the first point we found.
-
-        if (points.size() < 3) {
-            float xNew = static_cast<float>(points[0][1][0]);
-            float yNew = static_cast<float>(points[0][1][1]);
-            ret[0] = xNew;
-            ret[1] = yNew;
+        if (found == 0) {
+            return ret;
+        }
+        if (found < 3) {
+            ret[0] = m_samples.outX[p[0]];
+            ret[1] = m_samples.outY[p[0]];
             return ret;
         }
 
         // Found three points -- interpolate them.
         float xNew = static_cast<float>(interpolate(
-            points[0][0][0], points[0][0][1], points[0][1][0], points[1][0][0],
-            points[1][0][1], points[1][1][0], points[2][0][0], points[2][0][1],
-            points[2][1][0], xN, yN));
+            m_samples.inX[p[0]], m_samples.inY[p[0]], m_samples.outX[p[0]], m_samples.inX[p[1]], m_samples.inY[p[1]],
+            m_samples.outX[p[1]], m_samples.inX[p[2]], m_samples.inY[p[2]], m_samples.outX[p[2]], xN, yN));
         float yNew = static_cast<float>(interpolate(
-            points[0][0][0], points[0][0][1], points[0][1][1], points[1][0][0],
-            points[1][0][1], points[1][1][1], points[2][0][0], points[2][0][1],
-            points[2][1][1], xN, yN));
+            m_samples.inX[p[0]], m_samples.inY[p[0]], m_samples.outY[p[0]], m_samples.inX[p[1]], m_samples.inY[p[1]],
+            m_samples.outY[p[1]], m_samples.inX[p[2]], m_samples.inY[p[2]], m_samples.outY[p[2]], xN, yN));
         ret[0] = xNew;
         ret[1] = yNew;
         return ret;
     }
 
-    MonoPointDistortionMeshDescription
-    UnstructuredMeshInterpolator::getNearestPoints(
-        float xN, float yN, const MonoPointDistortionMeshDescription& points) {
-        MonoPointDistortionMeshDescription ret;
-
+    size_t UnstructuredMeshInterpolator::getNearestPoints(
+        float xN, float yN, const uint32_t* indices, size_t count,
+        uint32_t nearest[3]) const {
         // Find the three non-collinear points in the mesh that are nearest
         // to the normalized point we are trying to look up.  We start by
         // sorting the points based on distance from our location, selecting
@@ -222,45 +574,86 @@ namespace renderkit {
         // one that is not collinear with the first two (normalized dot
         // product magnitude far enough from 1).  If we don't find such
         // points, we just go with the values from the closest point.
-        typedef std::multimap<double, size_t> PointDistanceIndexMap;
-        PointDistanceIndexMap map;
-
-        //if (points.size() < 460 && points.size() > 0)
-        //    std::cout << "XXX Sorting mesh of size " << points.size() << std::endl;
-        for (size_t i = 0; i < points.size(); i++) {
-            // Insertion into the multimap sorts them by distance.
-            map.insert(std::make_pair(
-                pointDistance(xN, yN, points[i][0][0], points[i][0][1]), i));
-        }
-
-        PointDistanceIndexMap::const_iterator it = map.begin();
-        size_t first = it->second;
-        it++;
-        size_t second = it->second;
-        it++;
-        size_t third = first;
-        while (it != map.end()) {
-            if (!nearly_collinear(points[first][0], points[second][0],
-                                  points[it->second][0])) {
-                third = it->second;
-                break;
+        //   Equally-distant points are taken in the order they are listed.
+        if (count == 0) {
+            return 0;
+        }
+
+        // Squared distances, in one pass over the packed coordinates.
+        // This is the loop that touches every point on a full search, so
+        // it is kept simple enough for the compiler to vectorize.
+        std::vector<float> dist2(count);
+        if (indices) {
+            for (size_t i = 0; i < count; i++) {
+                float dx = m_samples.inX[indices[i]] - xN;
+                float dy = m_samples.inY[indices[i]] - yN;
+                dist2[i] = dx * dx + dy * dy;
+            }
+        } else {
+            const float* inX = m_samples.inX.data();
+            const float* inY = m_samples.inY.data();
+            for (size_t i = 0; i < count; i++) {
+                float dx = inX[i] - xN;
+                float dy = inY[i] - yN;
+                dist2[i] = dx * dx + dy * dy;
             }
-            it++;
         }
 
-        // Push back all of the points we found, which may not include
-        // a third point if the first is the same as the third.
-        if (map.size() >= 1) {
-            ret.push_back(points[first]);
+        // Order positions in the list by distance.  The third point is
+        // nearly always among the closest few, so only those are sorted
+        // at first and the rest only if they are needed.
+        std::vector<uint32_t> order(count);
+        for (size_t i = 0; i < count; i++) {
+            order[i] = static_cast<uint32_t>(i);
         }
-        if (map.size() >= 2) {
-            ret.push_back(points[second]);
+        auto closer = [&dist2](uint32_t a, uint32_t b) {
+            return dist2[a] < dist2[b] || (dist2[a] == dist2[b] && a < b);
+        };
+        size_t sortedCount = std::min<size_t>(count, 16);
+        std::partial_sort(order.begin(), order.begin() + sortedCount,
+                          order.end(), closer);
+        auto pointAt = [&](size_t i) {
+            return indices ? indices[order[i]] : order[i];
+        };
+
+        nearest[0] = pointAt(0);
+        if (count == 1) {
+            return 1;
         }
-        if (third != first) {
-            ret.push_back(points[third]);
+        nearest[1] = pointAt(1);
+
+        std::array<double, 2> const first = {
+            {m_samples.inX[nearest[0]], m_samples.inY[nearest[0]]}};
+        std::array<double, 2> const second = {
+            {m_samples.inX[nearest[1]], m_samples.inY[nearest[1]]}};
+        for (size_t i = 2; i < count; i++) {
+            if (i == sortedCount) {
+                std::sort(order.begin() + sortedCount, order.end(), closer);
+                sortedCount = count;
+            }
+            uint32_t candidate = pointAt(i);
+            std::array<double, 2> const third = {
+                {m_samples.inX[candidate], m_samples.inY[candidate]}};
+            if (!nearly_collinear(first, second, third)) {
+                nearest[2] = candidate;
+                return 3;
+            }
         }
+        return 2;
+    }
 
-        return ret;
+    /// Check that there are enough point samples for one eye to build an
+    /// interpolator from.
+    static bool checkPointSamples(
+      const MonoPointDistortionMeshDescriptionPtr &samples) {
+      if (!samples || samples->size() < 3) {
+        std::cerr << "makeInterpolatorsForParameters: Need "
+          "3+ points, found "
+          << (samples ? samples->size() : 0)
+          << std::endl;
+        return false;
+      }
+      return true;
     }
 
     bool makeUnstructuredMeshInterpolators(
@@ -284,46 +677,13 @@ namespace renderkit {
             << params.m_monoPointSamples.size() << std::endl;
           return false;
         }
-        // Add a new interpolator to be used when we're finding
-        // mesh coordinates.
-        if (params.m_monoPointSamples[eye].size() < 3) {
-          std::cerr << "makeInterpolatorsForParameters: Need "
-            "3+ points, found "
-            << params.m_monoPointSamples[eye].size()
-            << std::endl;
+        if (!checkPointSamples(params.m_monoPointSamples[eye])) {
           return false;
         }
-        for (size_t i = 0; i < params.m_monoPointSamples[eye].size();
-          i++) {
-          if (params.m_monoPointSamples[eye][i].size() != 2) {
-            std::cerr
-              << "makeInterpolatorsForParameters: Need 2 "
-              << "points in the mesh, found "
-              << params.m_monoPointSamples[eye][i].size()
-              << std::endl;
-            return false;
-          }
-          if (params.m_monoPointSamples[eye][i][0].size() != 2) {
-            std::cerr
-              << "makeInterpolatorsForParameters: Need 2 "
-              << "values in input point, found "
-              << params.m_monoPointSamples[eye][i][0].size()
-              << std::endl;
-            return false;
-          }
-          if (params.m_monoPointSamples[eye][i][1].size() != 2) {
-            std::cerr
-              << "makeInterpolatorsForParameters: Need 2 "
-              << "values in output point, found "
-              << params.m_monoPointSamples[eye][i][1].size()
-              << std::endl;
-            return false;
-          }
-        }
         // Add a new interpolator to be used when we're finding
         // mesh coordinates.
         interpolators.emplace_back(new
-          UnstructuredMeshInterpolator(params.m_monoPointSamples[eye]));
+          UnstructuredMeshInterpolator(*params.m_monoPointSamples[eye]));
       }
       else if (params.m_type ==
         DistortionParameters::rgb_point_samples) {
@@ -341,53 +701,14 @@ namespace renderkit {
               << std::endl;
             return false;
           }
-          // Add a new interpolator to be used when we're finding
-          // mesh coordinates.
-          if (params.m_rgbPointSamples[clr][eye].size() < 3) {
-            std::cerr
-              << "makeInterpolatorsForParameters: Need "
-              "3+ points, found "
-              << params.m_rgbPointSamples[clr][eye].size()
-              << std::endl;
+          if (!checkPointSamples(params.m_rgbPointSamples[clr][eye])) {
             return false;
           }
-          for (size_t i = 0;
-            i < params.m_rgbPointSamples[clr][eye].size(); i++) {
-            if (params.m_rgbPointSamples[clr][eye][i].size() !=
-              2) {
-              std::cerr
-                << "makeInterpolatorsForParameters: Need "
-                "2 points in the mesh, found "
-                << params.m_rgbPointSamples[clr][eye][i].size()
-                << std::endl;
-              return false;
-            }
-            if (params.m_rgbPointSamples[clr][eye][i][0].size() !=
-              2) {
-              std::cerr
-                << "makeInterpolatorsForParameters: Need "
-                "2 values in input point, found "
-                << params.m_rgbPointSamples[clr][eye][i][0]
-                .size()
-                << std::endl;
-              return false;
-            }
-            if (params.m_rgbPointSamples[clr][eye][i][1].size() !=
-              2) {
-              std::cerr
-                << "makeInterpolatorsForParameters: Need "
-                "2 values in output point, found "
-                << params.m_rgbPointSamples[clr][eye][i][1]
-                .size()
-                << std::endl;
-              return false;
-            }
-          }
 
           // Add a new interpolator to be used when we're finding
           // mesh coordinates, one per eye.
           interpolators.emplace_back(new
-            UnstructuredMeshInterpolator(params.m_rgbPointSamples[clr][eye]));
+            UnstructuredMeshInterpolator(*params.m_rgbPointSamples[clr][eye]));
         }
       }
 
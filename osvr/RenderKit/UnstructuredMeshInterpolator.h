@@ -36,6 +36,7 @@
 
 // Standard includes
 #include <array>
+#include <cstdint>
 #include <vector>
 #include <memory>
 
@@ -46,10 +47,15 @@ namespace renderkit {
     ///
     /// This class makes a spatial data structure that makes it faster
     /// to determine the interpolated coordinates between vertices
-    /// in an unstructured mesh.  It pre-fills in a small list of the
-    /// nearest unstructured vertices to each location in a regular
-    /// grid and then uses these to more-rapidly identify the nearest
-    /// points when a large number of interpolations need to be done.
+    /// in an unstructured mesh.  It builds a Delaunay triangulation of
+    /// the unstructured vertices once, along with a regular grid that
+    /// lists the triangles overlapping each of its cells, so that each
+    /// interpolation inside the mesh is a cell lookup followed by a
+    /// barycentric blend of the three vertices of the enclosing triangle.
+    ///   Locations outside of the triangulated region are extrapolated
+    /// from the nearest non-collinear points, using a second grid that
+    /// pre-fills a small list of the nearest unstructured vertices to
+    /// each of its locations.
     class UnstructuredMeshInterpolator {
     public:
         /// Constructor, provided the list of points it is to use.
@@ -66,9 +72,24 @@ namespace renderkit {
           int numSamplesY = 20
         );
 
-        /// Find an interpolation of the value based on the three
+        /// Constructor, provided the points already packed into float
+        /// arrays, which it takes over.
+        /// @param samples Unstructured mesh points to use for interpolation
+        /// @param numSamplesX Optional parameter describing the size of
+        ///        the acceleration mesh structure.
+        /// @param numSamplesY Optional parameter describing the size of
+        ///        the acceleration mesh structure.
+        OSVR_RENDERMANAGER_EXPORT UnstructuredMeshInterpolator(
+          PackedMonoPointSamples samples,
+          int numSamplesX = 20,
+          int numSamplesY = 20
+        );
+
+        /// Find an interpolation of the value based on the triangle
+        /// of the unstructured mesh that contains the point.  If no
+        /// triangle contains it, the value is extrapolated from the three
         /// nearest non-collinear points in the unstructured mesh.
-        /// Attempts to use the spatial acceleration structure to
+        /// Attempts to use the spatial acceleration structures to
         /// speed up the query if it can.  If there are not three
         /// points, just return the original coordinates.
         /// @param xN Normalized x coordinate
@@ -80,20 +101,32 @@ namespace renderkit {
 
     protected:
 
-        /// Return the three nearest non-collinear points in the
-        /// unstructured mesh description passed in.  If there are
-        /// not three such points, can return fewer.
+        /// Find the triangle of the triangulation that contains the
+        /// specified location and interpolate the output coordinates
+        /// of its vertices using barycentric weights.
         /// @param xN Normalized texture coordinate in X
         /// @param yN Normalized texture coordinate in Y
-        /// @param points Vector of points to search in.
-        /// @return vector of up to three points.
-        MonoPointDistortionMeshDescription getNearestPoints(
-          float xN, float yN,
-          const MonoPointDistortionMeshDescription &points);
+        /// @param [out] out Interpolated coordinate.
+        /// @return True if a triangle containing the point was found.
+        bool interpolateTriangulation(float xN, float yN, Float2 &out) const;
 
-        const MonoPointDistortionMeshDescription m_points;
-
-        /// Structure to store points from the m_points array
+        /// Find the three nearest non-collinear points in the
+        /// unstructured mesh among a list of them.  If there are
+        /// not three such points, can return fewer.
+        /// @param xN Normalized texture coordinate in X
+        /// @param yN Normalized texture coordinate in Y
+        /// @param indices Indices of the points to search in, or nullptr
+        ///        to search all of them.
+        /// @param count Number of points to search in.
+        /// @param [out] nearest Indices of the points found.
+        /// @return Number of points found, up to three.
+        size_t getNearestPoints(float xN, float yN, const uint32_t* indices,
+                                size_t count, uint32_t nearest[3]) const;
+
+        /// Input and output locations of the unstructured mesh points.
+        PackedMonoPointSamples m_samples;
+
+        /// Structure to store points from the unstructured mesh
         /// in a regular mesh covering the range of
         /// normalized texture coordinates from (0,0) to (1,1).
         ///   It is filled by the constructor and is used by the
@@ -102,14 +135,49 @@ namespace renderkit {
         /// If there are not three such points here, the acceleration
         /// has failed for a location and the full point list is
         /// searched.
-        std::vector<    // Range in X
-            std::vector<  // Range in Y
-            MonoPointDistortionMeshDescription ///< Points
-            >
-            > m_grid;
+        ///   The indices of the points near each grid location are
+        /// stored one location after another in m_gridPoints, with X
+        /// varying fastest; those for location i start at m_gridStart[i]
+        /// and end at m_gridStart[i + 1].
+        std::vector<uint32_t> m_gridStart;
+        std::vector<uint32_t> m_gridPoints;
         int m_numSamplesX = 0; ///< Size of the grid in X
         int m_numSamplesY = 0; ///< Size of the grid in Y
 
+        /// Delaunay triangulation of the input locations of the points,
+        /// each entry holding the indices of its three vertices in
+        /// counter-clockwise order.
+        std::vector<std::array<uint32_t, 3> > m_triangles;
+
+        /// Point-location grid covering the bounding box of the input
+        /// locations.  Each cell lists the indices of the triangles whose
+        /// bounding boxes overlap it; it is stored with X varying fastest,
+        /// in the same layout as m_gridStart and m_gridPoints.
+        std::vector<uint32_t> m_triangleGridStart;
+        std::vector<uint32_t> m_triangleGridTriangles;
+        int m_triangleGridX = 0;  ///< Size of the triangle grid in X
+        int m_triangleGridY = 0;  ///< Size of the triangle grid in Y
+        double m_triangleGridMinX = 0;  ///< Lower X bound of the grid
+        double m_triangleGridMinY = 0;  ///< Lower Y bound of the grid
+        double m_triangleGridScaleX = 0;  ///< Cells per unit in X
+        double m_triangleGridScaleY = 0;  ///< Cells per unit in Y
+
+        /// Return the index of the triangle-grid cell holding a
+        /// specified location, clamped to the range of the grid.  The
+        /// clamping is done before converting to int, so that locations
+        /// far outside the grid (or NaN, which goes to the first cell)
+        /// stay in range.
+        inline size_t getTriangleCell(double xN, double yN) const {
+            double x = (xN - m_triangleGridMinX) * m_triangleGridScaleX;
+            if (!(x >= 0)) { x = 0; }
+            if (x > m_triangleGridX - 1) { x = m_triangleGridX - 1; }
+            double y = (yN - m_triangleGridMinY) * m_triangleGridScaleY;
+            if (!(y >= 0)) { y = 0; }
+            if (y > m_triangleGridY - 1) { y = m_triangleGridY - 1; }
+            return static_cast<size_t>(y) * m_triangleGridX +
+                   static_cast<size_t>(x);
+        }
+
         /// Return the index of the closest grid point to a
         /// specified location.  Clamps to the range of
         /// the grid even for points outside it.
@@ -119,7 +187,7 @@ namespace renderkit {
         /// @param yIndexOut [out] Index of nearest grid point
         /// @return True on success, false on no samples in X,Y
         inline bool getIndex(double xN, double yN,
-                             int &xIndexOut, int &yIndexOut) {
+                             int &xIndexOut, int &yIndexOut) const {
             if (m_numSamplesX * m_numSamplesY == 0) {
                 return false;
             }
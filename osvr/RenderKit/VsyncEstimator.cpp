@@ -0,0 +1,220 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "VsyncEstimator.h"
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace osvr {
+namespace renderkit {
+
+    const size_t VsyncEstimator::CAPACITY;
+    const size_t VsyncEstimator::MIN_SAMPLES;
+
+    /// Shortest interval between swaps that is taken as a refresh period,
+    /// in seconds (a 400Hz display); anything shorter means the swap did
+    /// not wait for retrace.
+    static const double MIN_PERIOD = 1.0 / 400;
+
+    /// Longest interval taken as a refresh period, in seconds (a 20Hz
+    /// display); longer gaps are pauses in presentation.
+    static const double MAX_PERIOD = 1.0 / 20;
+
+    /// Swaps further than this fraction of a period from the fitted
+    /// lattice are left out of the fit.
+    static const double OUTLIER_FRACTION = 0.25;
+
+    /// The fitted period is only used if it is within this fraction of
+    /// the median interval.
+    static const double MAX_PERIOD_CORRECTION = 0.1;
+
+    /// Time the presenting thread needs between being told to present and
+    /// retrace, in seconds; matches what the D3D11 renderer asks for.
+    static const double PRESENT_SLACK = 1e-3;
+
+    static OSVR_TimeValue secondsToTimeValue(double seconds) {
+        OSVR_TimeValue ret;
+        ret.seconds = static_cast<OSVR_TimeValue_Seconds>(seconds);
+        ret.microseconds = static_cast<OSVR_TimeValue_Microseconds>(
+            (seconds - ret.seconds) * 1e6);
+        return ret;
+    }
+
+    void VsyncEstimator::addSwapTime(OSVR_TimeValue const& when) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_count == 0) {
+            m_base = when;
+        }
+        m_times[m_next] = osvrTimeValueDurationSeconds(&when, &m_base);
+        m_next = (m_next + 1) % CAPACITY;
+        m_count = std::min(m_count + 1, CAPACITY);
+        update();
+    }
+
+    void VsyncEstimator::reset() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_next = 0;
+        m_count = 0;
+        m_period = 0;
+    }
+
+    bool VsyncEstimator::getTimingInfo(OSVR_RenderTimingInfo& info) {
+        OSVR_TimeValue now;
+        osvrTimeValueGetNow(&now);
+        return getTimingInfo(now, info);
+    }
+
+    bool VsyncEstimator::getTimingInfo(OSVR_TimeValue const& now,
+                                       OSVR_RenderTimingInfo& info) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_period <= 0) {
+            return false;
+        }
+        double sincePhase = osvrTimeValueDurationSeconds(&now, &m_base) -
+                            m_phase;
+        double sinceRetrace =
+            sincePhase - std::floor(sincePhase / m_period) * m_period;
+
+        info.hardwareDisplayInterval = secondsToTimeValue(m_period);
+        info.timeSincelastVerticalRetrace = secondsToTimeValue(sinceRetrace);
+        info.timeUntilNextPresentRequired = secondsToTimeValue(
+            std::max(m_period - sinceRetrace - PRESENT_SLACK, 0.0));
+        return true;
+    }
+
+    double VsyncEstimator::getPeriod() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_period;
+    }
+
+    void VsyncEstimator::update() {
+        m_period = 0;
+        if (m_count < MIN_SAMPLES) {
+            return;
+        }
+
+        // Times in order, oldest first.
+        std::vector<double> times(m_count);
+        size_t oldest = (m_next + CAPACITY - m_count) % CAPACITY;
+        for (size_t i = 0; i < m_count; i++) {
+            times[i] = m_times[(oldest + i) % CAPACITY];
+        }
+        double newest = times.back();
+
+        // Median of the plausible intervals between swaps.
+        std::vector<double> intervals;
+        for (size_t i = 1; i < times.size(); i++) {
+            double interval = times[i] - times[i - 1];
+            if (interval >= MIN_PERIOD && interval <= MAX_PERIOD) {
+                intervals.push_back(interval);
+            }
+        }
+        if (intervals.size() < MIN_SAMPLES / 2) {
+            return;
+        }
+        std::nth_element(intervals.begin(),
+                         intervals.begin() + intervals.size() / 2,
+                         intervals.end());
+        double median = intervals[intervals.size() / 2];
+
+        // Lattice index of each time, counted from the oldest.  Each is
+        // found from the interval to the one before it rather than from
+        // the distance to the oldest, so that the error in the median
+        // does not add up over many periods.
+        std::vector<double> indices(times.size());
+        indices[0] = 0;
+        for (size_t i = 1; i < times.size(); i++) {
+            indices[i] = indices[i - 1] +
+                         std::max(1.0, std::floor((times[i] - times[i - 1]) /
+                                                      median +
+                                                  0.5));
+        }
+
+        // Least-squares fit of the times against their indices, done
+        // twice: the second time leaving out swaps that are far off the
+        // first fit (ones that completed late).
+        double period = median;
+        double intercept = 0;
+        bool fitted = false;
+        for (int pass = 0; pass < 2; pass++) {
+            double sumK = 0, sumT = 0, sumKK = 0, sumKT = 0;
+            size_t n = 0;
+            for (size_t i = 0; i < times.size(); i++) {
+                double k = indices[i];
+                double t = times[i] - newest;
+                if (fitted && std::fabs(t - (intercept + k * period)) >
+                                  OUTLIER_FRACTION * period) {
+                    continue;
+                }
+                sumK += k;
+                sumT += t;
+                sumKK += k * k;
+                sumKT += k * t;
+                n++;
+            }
+            double denominator = n * sumKK - sumK * sumK;
+            if (n < MIN_SAMPLES / 2 || denominator <= 0) {
+                break;
+            }
+            double slope = (n * sumKT - sumK * sumT) / denominator;
+            if (std::fabs(slope - median) > MAX_PERIOD_CORRECTION * median) {
+                break;
+            }
+            period = slope;
+            intercept = (sumT - slope * sumK) / n;
+            fitted = true;
+        }
+
+        // Swaps complete at or after retrace, so the earliest of them
+        // relative to the lattice gives its phase.  Only the recent half
+        // is used so that any error in the period matters less.
+        double earliest = 0;
+        bool found = false;
+        for (size_t i = times.size() / 2; i < times.size(); i++) {
+            double rel = times[i] - newest;
+            double k = std::floor(rel / period + 0.5);
+            double residual = rel - k * period;
+            if (std::fabs(residual) > OUTLIER_FRACTION * period) {
+                continue;
+            }
+            if (!found || residual < earliest) {
+                earliest = residual;
+                found = true;
+            }
+        }
+
+        m_period = period;
+        m_phase = newest + earliest;
+    }
+
+} // namespace renderkit
+} // namespace osvr
@@ -0,0 +1,107 @@
+/** @file
+    @brief Header
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_VsyncEstimator_h_GUID_C4E81A3F_6B27_4D95_A0F2_83D5E7B19C64
+#define INCLUDED_VsyncEstimator_h_GUID_C4E81A3F_6B27_4D95_A0F2_83D5E7B19C64
+
+// Internal Includes
+#include <osvr/RenderKit/RenderManagerC.h>
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <array>
+#include <cstddef>
+#include <mutex>
+
+namespace osvr {
+namespace renderkit {
+
+    /// @brief Estimates the period and phase of vertical retrace from the
+    /// times at which buffer swaps completed, for displays whose toolkit
+    /// cannot report them.
+    ///
+    /// With vertical sync on, a swap completes at (or a little after) a
+    /// retrace, so the recent completion times lie close to a lattice
+    /// t0 + k * period.  The period is first taken as the median interval
+    /// between swaps, which ignores the odd missed frame, and is then
+    /// refined by a least-squares fit of the times against their lattice
+    /// indices.  Wake-ups are late but never early, so the phase is set
+    /// from the earliest of the fitted times rather than their mean.
+    ///
+    /// If the application consistently misses every other retrace, the
+    /// estimated period is twice the true one; pacing to it still works.
+    ///
+    /// Times are added by the presenting thread and may be read from any
+    /// thread.
+    class VsyncEstimator {
+      public:
+        /// Number of recent swaps that the estimate is based on.
+        static const size_t CAPACITY = 64;
+
+        /// Number of swaps needed before there is an estimate.
+        static const size_t MIN_SAMPLES = 8;
+
+        /// Record that a swap completed at @p when.
+        void addSwapTime(OSVR_TimeValue const& when);
+
+        /// Forget all swaps, for example when the display is reopened.
+        void reset();
+
+        /// Fill in @p info for the current time.
+        /// @return False if there are not yet enough swaps to estimate
+        /// from, in which case @p info is unchanged.
+        bool getTimingInfo(OSVR_RenderTimingInfo& info);
+
+        /// Fill in @p info as of time @p now.
+        bool getTimingInfo(OSVR_TimeValue const& now,
+                           OSVR_RenderTimingInfo& info);
+
+        /// Estimated interval between retraces, in seconds, or 0 if there
+        /// is no estimate yet.
+        double getPeriod();
+
+      private:
+        /// Recompute m_period and m_phase from the stored times.
+        void update();
+
+        std::mutex m_mutex;
+
+        /// Times are stored as seconds since the first one, to keep them
+        /// precise as doubles.
+        OSVR_TimeValue m_base = {0, 0};
+        std::array<double, CAPACITY> m_times;
+        size_t m_next = 0;  ///< Where the next time goes
+        size_t m_count = 0; ///< How many of m_times are filled in
+
+        double m_period = 0; ///< In seconds; 0 when there is no estimate
+        double m_phase = 0;  ///< A retrace time, in seconds since m_base
+    };
+
+} // namespace renderkit
+} // namespace osvr
+
+#endif // INCLUDED_VsyncEstimator_h_GUID_C4E81A3F_6B27_4D95_A0F2_83D5E7B19C64
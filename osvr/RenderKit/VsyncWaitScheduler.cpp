@@ -0,0 +1,178 @@
+/** @file
+    @brief Implementation
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal Includes
+#include "VsyncWaitScheduler.h"
+
+// Library/third-party includes
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <errno.h>
+#include <time.h>
+#endif
+
+// Standard includes
+#include <algorithm>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+namespace osvr {
+namespace renderkit {
+
+    /// Least time to spin at the end of a wait, in seconds, to absorb
+    /// the cost of the final polls.
+    static const double MIN_SPIN_MARGIN = 200e-6;
+
+    /// Margin used until the first sleep has been measured.
+    static const double INITIAL_SPIN_MARGIN = 1e-3;
+
+    /// How much of the worst sleep lateness seen is kept after each wait,
+    /// so that one bad wake-up does not leave us spinning for long.  This
+    /// is applied per wait rather than per sleep so that it also recovers
+    /// when the margin has grown too large for any sleeps to happen.
+    static const double SLEEP_OVERSHOOT_DECAY = 0.95;
+
+    /// The margin is this multiple of the sleep lateness.
+    static const double SLEEP_OVERSHOOT_SAFETY = 1.5;
+
+    VsyncWaitScheduler::VsyncWaitScheduler()
+        : m_spinMargin(INITIAL_SPIN_MARGIN) {
+#ifdef _WIN32
+        // High-resolution timers need Windows 10 1803 or later; older
+        // versions reject the flag and get a regular timer.
+        m_timer = CreateWaitableTimerExW(nullptr, nullptr,
+                                         CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                         TIMER_ALL_ACCESS);
+        if (!m_timer) {
+            m_timer = CreateWaitableTimerExW(nullptr, nullptr, 0,
+                                             TIMER_ALL_ACCESS);
+        }
+#endif
+        m_stats.spinMarginMS = m_spinMargin * 1e3;
+    }
+
+    VsyncWaitScheduler::~VsyncWaitScheduler() {
+#ifdef _WIN32
+        if (m_timer) {
+            CloseHandle(m_timer);
+        }
+#endif
+    }
+
+    void VsyncWaitScheduler::begin(double secondsToGo) {
+        m_predictedEnd =
+            Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                               std::chrono::duration<double>(secondsToGo));
+    }
+
+    void VsyncWaitScheduler::pause(double secondsToGo) {
+        double sleepFor = secondsToGo - m_spinMargin;
+        if (sleepFor <= 0) {
+            return;
+        }
+        Clock::time_point wakeTime =
+            Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                               std::chrono::duration<double>(sleepFor));
+        sleepUntil(wakeTime);
+        std::chrono::duration<double> late = Clock::now() - wakeTime;
+
+        m_stats.sleeps++;
+        m_sleepOvershoot = std::max(late.count(), m_sleepOvershoot);
+        updateSpinMargin();
+    }
+
+    double VsyncWaitScheduler::end() {
+        std::chrono::duration<double> overshoot = Clock::now() - m_predictedEnd;
+        double seconds = std::max(overshoot.count(), 0.0);
+        m_stats.waits++;
+        m_totalOvershoot += seconds;
+        m_stats.meanOvershootMS = m_totalOvershoot / m_stats.waits * 1e3;
+        m_stats.maxOvershootMS =
+            std::max(m_stats.maxOvershootMS, seconds * 1e3);
+
+        m_sleepOvershoot *= SLEEP_OVERSHOOT_DECAY;
+        updateSpinMargin();
+        return seconds;
+    }
+
+    VsyncWaitScheduler::Statistics VsyncWaitScheduler::getStatistics() const {
+        return m_stats;
+    }
+
+    void VsyncWaitScheduler::updateSpinMargin() {
+        m_spinMargin = std::max(MIN_SPIN_MARGIN,
+                                m_sleepOvershoot * SLEEP_OVERSHOOT_SAFETY);
+        m_stats.sleepOvershootMS = m_sleepOvershoot * 1e3;
+        m_stats.spinMarginMS = m_spinMargin * 1e3;
+    }
+
+    void VsyncWaitScheduler::sleepUntil(Clock::time_point wakeTime) {
+#if defined(_WIN32)
+        if (m_timer) {
+            // Relative due time, in (negative) 100ns units.
+            auto remaining = std::chrono::duration_cast<
+                std::chrono::duration<long long, std::ratio<1, 10000000> > >(
+                wakeTime - Clock::now());
+            if (remaining.count() <= 0) {
+                return;
+            }
+            LARGE_INTEGER due;
+            due.QuadPart = -remaining.count();
+            if (SetWaitableTimer(m_timer, &due, 0, nullptr, nullptr, FALSE)) {
+                WaitForSingleObject(m_timer, INFINITE);
+                return;
+            }
+        }
+        std::this_thread::sleep_until(wakeTime);
+#elif defined(__linux__)
+        // steady_clock is CLOCK_MONOTONIC here, so we can sleep until an
+        // absolute time on it, which is immune to being woken early by a
+        // signal and then re-sleeping for too long.
+        auto sinceEpoch = wakeTime.time_since_epoch();
+        auto seconds =
+            std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch);
+        struct timespec ts;
+        ts.tv_sec = static_cast<time_t>(seconds.count());
+        ts.tv_nsec = static_cast<long>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch -
+                                                                 seconds)
+                .count());
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts,
+                               nullptr) == EINTR) {
+        }
+#else
+        std::this_thread::sleep_until(wakeTime);
+#endif
+    }
+
+} // namespace renderkit
+} // namespace osvr
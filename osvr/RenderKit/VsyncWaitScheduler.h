@@ -0,0 +1,112 @@
+/** @file
+    @brief Header
+
+    @date 2016
+
+    @author
+    Sensics, Inc.
+    <http://sensics.com>
+
+*/
+
+// Copyright 2016 Sensics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// 	http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INCLUDED_VsyncWaitScheduler_h_GUID_7A2C5E19_D84B_4F36_B0E7_1C93F6A58D20
+#define INCLUDED_VsyncWaitScheduler_h_GUID_7A2C5E19_D84B_4F36_B0E7_1C93F6A58D20
+
+// Internal Includes
+// - none
+
+// Library/third-party includes
+// - none
+
+// Standard includes
+#include <chrono>
+#include <cstddef> // for size_t
+
+namespace osvr {
+namespace renderkit {
+
+    /// @brief Paces a wait for a point shortly before vertical retrace
+    /// without spinning for all of it.
+    ///
+    /// The caller polls the time remaining, as before, and calls pause()
+    /// between polls.  While the end of the wait is further away than a
+    /// spin margin, pause() sleeps on a high-resolution timer until the
+    /// margin is all that remains; within the margin it returns at once,
+    /// so that the caller spins for the last part.  The margin is set from
+    /// how late recent sleeps have woken up, so it is a few hundred
+    /// microseconds where the timer is accurate and grows where it is not,
+    /// down to spinning for all of the wait if sleeps are hopeless.
+    ///
+    /// Not thread-safe; each waiting thread needs its own.
+    class VsyncWaitScheduler {
+      public:
+        /// How the waits have gone.
+        struct Statistics {
+            size_t waits = 0;  ///< Waits that have ended
+            size_t sleeps = 0; ///< Sleeps taken during them
+            /// How long after the time first predicted the waits ended,
+            /// on average and at worst.
+            double meanOvershootMS = 0;
+            double maxOvershootMS = 0;
+            /// Recent worst lateness of sleeps waking up, which sets the
+            /// spin margin.
+            double sleepOvershootMS = 0;
+            /// Time at the end of each wait that is spent spinning.
+            double spinMarginMS = 0;
+        };
+
+        VsyncWaitScheduler();
+        ~VsyncWaitScheduler();
+        VsyncWaitScheduler(VsyncWaitScheduler const&) = delete;
+        VsyncWaitScheduler& operator=(VsyncWaitScheduler const&) = delete;
+
+        /// Start a wait that is predicted to end @p secondsToGo from now.
+        void begin(double secondsToGo);
+
+        /// Called between polls with the time still to wait: sleeps if
+        /// that is more than the spin margin, otherwise returns at once.
+        void pause(double secondsToGo);
+
+        /// Finish the wait begun by begin().
+        /// @return How many seconds after its predicted end it finished.
+        double end();
+
+        /// Get a copy of the statistics.
+        Statistics getStatistics() const;
+
+      private:
+        typedef std::chrono::steady_clock Clock;
+
+        /// Sleep until @p wakeTime or as soon after it as the system
+        /// allows.
+        void sleepUntil(Clock::time_point wakeTime);
+
+        /// Set the spin margin from the sleep lateness.
+        void updateSpinMargin();
+
+        Clock::time_point m_predictedEnd;
+        double m_totalOvershoot = 0;
+        double m_sleepOvershoot = 0; ///< Decaying maximum, in seconds
+        double m_spinMargin;         ///< In seconds
+        Statistics m_stats;
+        void* m_timer = nullptr; ///< Waitable timer handle on Windows
+    };
+
+} // namespace renderkit
+} // namespace osvr
+
+#endif // INCLUDED_VsyncWaitScheduler_h_GUID_7A2C5E19_D84B_4F36_B0E7_1C93F6A58D20
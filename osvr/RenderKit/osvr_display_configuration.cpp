@@ -25,6 +25,8 @@
 
 // Internal Includes
 #include "osvr_display_configuration.h"
+#include "DistortionSampleFile.h"
+#include "DistortionSampleParser.h"
 
 // Library/third-party includes
 #include <boost/units/io.hpp>
@@ -34,9 +36,43 @@
 // Standard includes
 #include <cassert>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <utility>
 
+#ifdef OSVR_RM_PRECOMPILED_BUILT_IN_MESHES
+// Built-in distortion meshes, converted at build time from the JSON in
+// osvr_display_config_built_in_osvr_hdks.h into arrays of
+// (inX, inY, outX, outY) samples so that they need no parsing.
+#include "osvr_display_config_built_in_osvr_hdks_meshes.h"
+
+struct BuiltInKeysAndData {
+    const char* key;
+    const double* samples;
+    const size_t* eyeSampleCounts;
+    size_t numEyes;
+};
+
+#define OSVR_RM_BUILT_IN_MESH(KEY, NAME)                                       \
+    {                                                                          \
+        KEY, NAME##_mono_point_samples, NAME##_mono_point_counts,              \
+            sizeof(NAME##_mono_point_counts) /                                 \
+                sizeof(NAME##_mono_point_counts[0])                            \
+    }
+
+static const std::initializer_list<BuiltInKeysAndData>
+    BUILT_IN_MONO_POINT_SAMPLES = {
+        OSVR_RM_BUILT_IN_MESH("OSVR_HDK_13_V1",
+                              osvr_display_config_built_in_osvr_hdk13_v1),
+        OSVR_RM_BUILT_IN_MESH("OSVR_HDK_13_V2",
+                              osvr_display_config_built_in_osvr_hdk13_v2),
+        OSVR_RM_BUILT_IN_MESH("OSVR_HDK_20_V1",
+                              osvr_display_config_built_in_osvr_hdk20_v1)};
+#undef OSVR_RM_BUILT_IN_MESH
+#else
 // Included files that define built-in distortion meshes.
 #include "osvr_display_config_built_in_osvr_hdks.h"
 
@@ -50,6 +86,7 @@ static const std::initializer_list<BuiltInKeysAndData>
         {"OSVR_HDK_13_V1", osvr_display_config_built_in_osvr_hdk13_v1},
         {"OSVR_HDK_13_V2", osvr_display_config_built_in_osvr_hdk13_v2},
         {"OSVR_HDK_20_V1", osvr_display_config_built_in_osvr_hdk20_v1}};
+#endif
 
 
 OSVRDisplayConfiguration::OSVRDisplayConfiguration() {
@@ -61,6 +98,65 @@ OSVRDisplayConfiguration::OSVRDisplayConfiguration(
     parse(display_description);
 }
 
+/// Configurations handed out by OSVRDisplayConfiguration::getShared(), most
+/// recently used first.  Entries are found by the hash of their descriptor
+/// and then checked against the whole descriptor.
+struct SharedDisplayConfiguration {
+    size_t hash;
+    std::string description;
+    std::shared_ptr<const OSVRDisplayConfiguration> config;
+};
+static const size_t SHARED_DISPLAY_CONFIGURATIONS_KEPT = 4;
+static std::mutex g_sharedDisplayConfigurationsMutex;
+static std::list<SharedDisplayConfiguration> g_sharedDisplayConfigurations;
+
+std::shared_ptr<const OSVRDisplayConfiguration>
+OSVRDisplayConfiguration::getShared(const std::string& display_description) {
+    size_t const hash = std::hash<std::string>()(display_description);
+    auto find = [&] {
+        for (auto it = g_sharedDisplayConfigurations.begin();
+             it != g_sharedDisplayConfigurations.end(); ++it) {
+            if (it->hash == hash && it->description == display_description) {
+                g_sharedDisplayConfigurations.splice(
+                    g_sharedDisplayConfigurations.begin(),
+                    g_sharedDisplayConfigurations, it);
+                return g_sharedDisplayConfigurations.front().config;
+            }
+        }
+        return std::shared_ptr<const OSVRDisplayConfiguration>();
+    };
+    {
+        std::lock_guard<std::mutex> lock(g_sharedDisplayConfigurationsMutex);
+        auto ret = find();
+        if (ret) {
+            return ret;
+        }
+    }
+
+    // Parse without holding the lock, so that other descriptors can be
+    // looked up meanwhile.  If another thread parsed the same one first,
+    // use its copy so that everyone shares one.
+    std::shared_ptr<const OSVRDisplayConfiguration> config =
+        std::make_shared<OSVRDisplayConfiguration>(display_description);
+    std::lock_guard<std::mutex> lock(g_sharedDisplayConfigurationsMutex);
+    auto ret = find();
+    if (ret) {
+        return ret;
+    }
+    g_sharedDisplayConfigurations.push_front(
+        SharedDisplayConfiguration{hash, display_description, config});
+    if (g_sharedDisplayConfigurations.size() >
+        SHARED_DISPLAY_CONFIGURATIONS_KEPT) {
+        g_sharedDisplayConfigurations.pop_back();
+    }
+    return config;
+}
+
+void OSVRDisplayConfiguration::clearSharedCache() {
+    std::lock_guard<std::mutex> lock(g_sharedDisplayConfigurationsMutex);
+    g_sharedDisplayConfigurations.clear();
+}
+
 struct ExternalDistortionReturnValue {
     ExternalDistortionReturnValue() : distortion(Json::nullValue) {}
     ExternalDistortionReturnValue(Json::Value const& val, std::string&& fn)
@@ -115,6 +211,84 @@ getExternalDistortionFile(const char* distortionTypeName, Json::Reader& reader,
     return withError();
 }
 
+/// Reads the point-sample arrays named by @p keys straight out of an external
+/// distortion file, without building a JSON document for the whole file.
+/// The files hold calibration data that can run to tens of megabytes, for
+/// which the document would be several times larger than the samples.
+///
+/// Returns false, after saying why, if there is no external file or it
+/// can't be read this way; the caller can then fall back to the JSON reader.
+/// A binary copy of the samples next to the file is read instead when there
+/// is one.
+inline bool
+readExternalDistortionSamples(const char* distortionTypeName,
+                              Json::Value const& distortionObject,
+                              const char* externalFileKey,
+                              std::vector<std::string> const& keys,
+                              std::vector<osvr::renderkit::MonoPointDistortionMeshDescriptions>& samples,
+                              std::string& filename) {
+    Json::Value const& externalFile = distortionObject[externalFileKey];
+    if (externalFile.isNull() || !externalFile.isString()) {
+        return false;
+    }
+    filename = externalFile.asString();
+    std::string text;
+    bool haveText = false;
+    {
+        std::ifstream fs{filename, std::ios::in | std::ios::binary};
+        if (fs) {
+            fs.seekg(0, std::ios::end);
+            std::streamoff size = fs.tellg();
+            if (size > 0) {
+                text.resize(static_cast<size_t>(size));
+                fs.seekg(0, std::ios::beg);
+                haveText = static_cast<bool>(fs.read(&text[0], size));
+            }
+        }
+    }
+
+    // A binary copy of the samples next to the file, made by
+    // ConvertDistortionSamples, is used in its place as long as it was
+    // converted from a file with the same contents (or the file itself is
+    // missing).  Hashing the text is much cheaper than parsing it.
+    std::string error;
+    std::string binaryFilename =
+        osvr::renderkit::getDistortionSampleFileName(filename);
+    osvr::renderkit::DistortionSampleSource source =
+        osvr::renderkit::describeDistortionSampleSource(text);
+    if (osvr::renderkit::readDistortionSampleFile(
+            binaryFilename, keys, haveText ? &source : nullptr, samples,
+            error)) {
+        std::cout << "OSVRDisplayConfiguration::parse(): Read point samples "
+                     "from binary "
+                  << distortionTypeName << " file " << binaryFilename
+                  << std::endl;
+        return true;
+    }
+    if (!error.empty()) {
+        std::cerr << "OSVRDisplayConfiguration::parse(): Warning: Couldn't "
+                     "use binary "
+                  << distortionTypeName << " file " << binaryFilename << " ("
+                  << error << "), reading " << filename << " instead.\n";
+    }
+
+    if (!haveText) {
+        return false;
+    }
+    std::cout << "OSVRDisplayConfiguration::parse(): Reading point samples "
+                 "from external "
+              << distortionTypeName << " file " << filename << std::endl;
+    if (!osvr::renderkit::parseDistortionSampleArrays(text, keys, samples,
+                                                      error)) {
+        std::cerr << "OSVRDisplayConfiguration::parse(): Warning: Couldn't "
+                     "read samples directly from external "
+                  << distortionTypeName << " file " << filename << " ("
+                  << error << "), trying the JSON reader.\n";
+        return false;
+    }
+    return true;
+}
+
 /// Given the distortion object of the json config, tries to turn it into a mesh
 /// description (without loading external or built-ins - all it cares about is
 /// "mono_point_samples").
@@ -172,11 +346,13 @@ jsonToMonoPointMesh(Json::Value const& distortion, const char* dataSource) {
             point[1] = (out);
             eye.push_back(point);
         }
-        mesh.push_back(eye);
+        mesh.push_back(
+            std::make_shared<osvr::renderkit::MonoPointDistortionMeshDescription>(
+                std::move(eye)));
     }
     std::cout << "OSVRDisplayConfiguration::parse(): Initial processing "
                  "complete. Loaded mono point samples data with "
-              << mesh[0].size() << " and " << mesh[1].size()
+              << mesh[0]->size() << " and " << mesh[1]->size()
               << " samples per eye, respectively.\n";
     return mesh;
 }
@@ -194,18 +370,16 @@ inline bool parseBuiltInDistortionMonoPointMeshes(
     // Read a Json value from the built-in config, then replace the
     // distortion mesh with that from the file.
     const std::string builtInKey = builtIn.asString();
-    bool found = false;
-    std::string builtInString;
+    const BuiltInKeysAndData* builtInEntry = nullptr;
     /// Check against each entry in the known built ins (registered in a table
     /// at the top of this file)
     for (auto& knownEntry : BUILT_IN_MONO_POINT_SAMPLES) {
         if (builtInKey == knownEntry.key) {
-            builtInString = knownEntry.dataString;
-            found = true;
+            builtInEntry = &knownEntry;
             break;
         }
     }
-    if (!found) {
+    if (!builtInEntry) {
         // didn't find a match
         std::cerr << "OSVRDisplayConfiguration::parse(): Warning: Unrecognized "
                      "mono_point_samples_built_in value: "
@@ -213,6 +387,25 @@ inline bool parseBuiltInDistortionMonoPointMeshes(
         return false;
     }
 
+#ifdef OSVR_RM_PRECOMPILED_BUILT_IN_MESHES
+    // The samples were validated when they were generated, so copy them
+    // straight into the mesh.
+    osvr::renderkit::MonoPointDistortionMeshDescriptions newMesh;
+    const double* sample = builtInEntry->samples;
+    for (size_t eye = 0; eye < builtInEntry->numEyes; eye++) {
+        auto eyeMesh =
+            std::make_shared<osvr::renderkit::MonoPointDistortionMeshDescription>(
+                builtInEntry->eyeSampleCounts[eye]);
+        for (auto& point : *eyeMesh) {
+            point[0] = {{sample[0], sample[1]}};
+            point[1] = {{sample[2], sample[3]}};
+            sample += 4;
+        }
+        newMesh.push_back(std::move(eyeMesh));
+    }
+    (void)reader;
+#else
+    std::string builtInString = builtInEntry->dataString;
     Json::Value builtInData;
     if (!reader.parse(builtInString, builtInData, false)) {
         std::cerr << "OSVRDisplayConfiguration::parse(): Warning: Couldn't "
@@ -232,6 +425,7 @@ inline bool parseBuiltInDistortionMonoPointMeshes(
         /// blabbed about it, just return false without touching anything else.
         return false;
     }
+#endif
     /// OK, we've got a winner!
     std::cout << "OSVRDisplayConfiguration::parse(): Using distortion method "
                  "\"mono_point_samples_built_in\": \""
@@ -262,6 +456,21 @@ inline void parseDistortionMonoPointMeshes(
     // and grab its values to parse, replacing the ones that they sent
     // in.
     {
+        std::vector<osvr::renderkit::MonoPointDistortionMeshDescriptions>
+            samples;
+        std::string filename;
+        if (readExternalDistortionSamples("mono point", distortion,
+                                          "mono_point_samples_external_file",
+                                          {"mono_point_samples"}, samples,
+                                          filename)) {
+            std::cout << "OSVRDisplayConfiguration::parse(): Using "
+                         "distortion method "
+                         "\"mono_point_samples_external_file\": \""
+                      << filename << "\"" << std::endl;
+            mesh = std::move(samples[0]);
+            return;
+        }
+
         auto externalDistortion =
             getExternalDistortionFile("mono point", reader, distortion,
                                       "mono_point_samples_external_file");
@@ -309,18 +518,33 @@ inline void parseDistortionRGBPointMeshes(Json::Value myDistortion,
                                           osvr::renderkit::RGBPointDistortionMeshDescriptions& mesh) {
     Json::Reader reader;
 
+    std::array<std::string, 3> names = {
+        "red_point_samples", "green_point_samples", "blue_point_samples"};
+
     // See if we have the name of an external file to parse.  If so, we open it
     // and grab its values to parse.  Otherwise, we parse the ones that they
     // sent in.
+    {
+        std::vector<osvr::renderkit::MonoPointDistortionMeshDescriptions>
+            samples;
+        std::string filename;
+        if (readExternalDistortionSamples(
+                "RGB point samples", myDistortion,
+                "rgb_point_samples_external_file",
+                std::vector<std::string>(names.begin(), names.end()), samples,
+                filename)) {
+            for (size_t clr = 0; clr < 3; clr++) {
+                mesh[clr] = std::move(samples[clr]);
+            }
+            return;
+        }
+    }
     auto externalDistortion =
         getExternalDistortionFile("RGB point samples", reader, myDistortion, "rgb_point_samples_external_file");
     if (externalDistortion) {
         myDistortion.swap(externalDistortion.distortion);
     }
 
-    std::array<std::string, 3> names = {
-        "red_point_samples", "green_point_samples", "blue_point_samples"};
-
     for (size_t clr = 0; clr < 3; clr++) {
         const Json::Value& eyeArray = myDistortion[names[clr].c_str()];
         if (eyeArray.isNull() || eyeArray.empty()) {
@@ -369,7 +593,9 @@ inline void parseDistortionRGBPointMeshes(Json::Value myDistortion,
                 point[1] = (out);
                 eye.push_back(point);
             }
-            mesh[clr].push_back(eye);
+            mesh[clr].push_back(
+                std::make_shared<osvr::renderkit::MonoPointDistortionMeshDescription>(
+                    std::move(eye)));
         }
     }
 }
@@ -401,6 +627,10 @@ bool ParseDistortionJson(OSVRDisplayConfiguration::DistortionInfo& di, const Jso
     /// If not specified, set to a default.
     di.m_distortionDesiredTriangleCount = distortion.get("desired_triangle_count", 200 * 64).asInt();
 
+    /// Find out how closely an adaptive mesh must follow the distortion,
+    /// if this is specified.  If not specified, set to a default.
+    di.m_distortionMaxMeshErrorPixels = distortion.get("max_mesh_error_pixels", 0.5f).asFloat();
+
     /// We will detect distortion type based on either the explicitly
     /// specified string or the presence of essential object members.
     di.m_distortionTypeString = distortion["type"].asString();
@@ -783,7 +1013,7 @@ std::string OSVRDisplayConfiguration::getDistortionTypeString(size_t eye) const
     return m_eyes[eye].m_distortion.m_distortionTypeString;
 }
 
-osvr::renderkit::MonoPointDistortionMeshDescriptions
+osvr::renderkit::MonoPointDistortionMeshDescriptions const&
 OSVRDisplayConfiguration::getDistortionMonoPointMeshes(size_t eye) const {
     if (eye >= m_eyes.size()) {
         throw DisplayConfigurationParseException("Eye parameter out of range.");
@@ -791,7 +1021,7 @@ OSVRDisplayConfiguration::getDistortionMonoPointMeshes(size_t eye) const {
     return m_eyes[eye].m_distortion.m_distortionMonoPointMesh;
 }
 
-osvr::renderkit::RGBPointDistortionMeshDescriptions
+osvr::renderkit::RGBPointDistortionMeshDescriptions const&
 OSVRDisplayConfiguration::getDistortionRGBPointMeshes(size_t eye) const {
     if (eye >= m_eyes.size()) {
         throw DisplayConfigurationParseException("Eye parameter out of range.");
@@ -841,6 +1071,13 @@ int OSVR_RENDERMANAGER_EXPORT OSVRDisplayConfiguration::getDesiredDistortionTria
     return m_eyes[eye].m_distortion.m_distortionDesiredTriangleCount;
 }
 
+float OSVR_RENDERMANAGER_EXPORT OSVRDisplayConfiguration::getDistortionMaxMeshErrorPixels(size_t eye) const {
+    if (eye >= m_eyes.size()) {
+        throw DisplayConfigurationParseException("Eye parameter out of range.");
+    }
+    return m_eyes[eye].m_distortion.m_distortionMaxMeshErrorPixels;
+}
+
 std::vector<OSVRDisplayConfiguration::EyeInfo> const&
 OSVRDisplayConfiguration::getEyes() const {
     return m_eyes;
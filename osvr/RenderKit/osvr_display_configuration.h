@@ -70,6 +70,22 @@ class OSVRDisplayConfiguration {
     void OSVR_RENDERMANAGER_EXPORT
     parse(const std::string& display_description);
 
+    /// Returns the configuration parsed from a display descriptor, shared
+    /// with every other caller in the process that asks for the same
+    /// descriptor.  The most recently used configurations are kept even
+    /// when nobody holds them, so that a RenderManager that is destroyed
+    /// and created again (on device reconnect, for example) does not
+    /// parse the descriptor and its distortion data again.
+    /// @throws DisplayConfigurationParseException if the descriptor can't
+    ///         be parsed; failures are not cached.
+    static std::shared_ptr<const OSVRDisplayConfiguration>
+    OSVR_RENDERMANAGER_EXPORT getShared(const std::string& display_description);
+
+    /// Drop the configurations kept by getShared(), so that later calls
+    /// parse their descriptors again; needed only when external files the
+    /// descriptors refer to have changed.
+    static void OSVR_RENDERMANAGER_EXPORT clearSharedCache();
+
     /// Produces a duplicate object that leaves out/defaults the parameters related to display output transformation
     /// (e.g. rotation, swap eyes).
     ///
@@ -118,11 +134,13 @@ class OSVRDisplayConfiguration {
     DistortionType OSVR_RENDERMANAGER_EXPORT getDistortionType(size_t eye = 0) const;
     /// deprecated
     std::string OSVR_RENDERMANAGER_EXPORT getDistortionTypeString(size_t eye = 0) const;
-    /// Only valid if getDistortionType() == MONO_POINT_SAMPLES
-    osvr::renderkit::MonoPointDistortionMeshDescriptions
+    /// Only valid if getDistortionType() == MONO_POINT_SAMPLES.  The
+    /// samples themselves are shared, not copied, by copies of the result.
+    osvr::renderkit::MonoPointDistortionMeshDescriptions const&
     getDistortionMonoPointMeshes(size_t eye = 0) const;
-    /// Only valid if getDistortionType() == RGB_POINT_SAMPLES
-    osvr::renderkit::RGBPointDistortionMeshDescriptions
+    /// Only valid if getDistortionType() == RGB_POINT_SAMPLES.  The
+    /// samples themselves are shared, not copied, by copies of the result.
+    osvr::renderkit::RGBPointDistortionMeshDescriptions const&
     getDistortionRGBPointMeshes(size_t eye = 0) const;
     /// @name Polynomial distortion
     /// @brief Only valid if getDistortionType() == RGB_SYMMETRIC_POLYNOMIALS
@@ -137,6 +155,10 @@ class OSVRDisplayConfiguration {
     /// Returns the desired number of triangles in the constructed distortion mesh.
     int OSVR_RENDERMANAGER_EXPORT getDesiredDistortionTriangleCount(size_t eye = 0) const;
 
+    /// Returns the largest error, in pixels, that an adaptive distortion
+    /// mesh may leave when interpolating the distortion.
+    float OSVR_RENDERMANAGER_EXPORT getDistortionMaxMeshErrorPixels(size_t eye = 0) const;
+
     // Distortion
     class DistortionInfo {
       public:
@@ -148,6 +170,7 @@ class OSVRDisplayConfiguration {
             m_distortionPolynomialRed = {0.f, 1.f};
             m_distortionPolynomialGreen = {0.f, 1.f};
             m_distortionPolynomialBlue = {0.f, 1.f};
+            m_distortionMaxMeshErrorPixels = 0.5f;
         }
 
         DistortionType m_distortionType;
@@ -160,6 +183,7 @@ class OSVRDisplayConfiguration {
         std::vector<float> m_distortionPolynomialGreen;
         std::vector<float> m_distortionPolynomialBlue;
         int m_distortionDesiredTriangleCount;
+        float m_distortionMaxMeshErrorPixels;
     };
 
     /// Structure holding the information for one eye.